@@ -130,29 +130,18 @@ void editor_input_selection(SDL_Event event){
 
                 bool nothing = true;
                 // check what entity we clicked over, we clicked on an entity (thats ignoring our current selection) we should change the current selection, else we deselect
-                struct ye_entity_node *clicked_entity = entity_list_head;
-                while (clicked_entity != NULL)
-                {
-                    if(clicked_entity->entity == YE_STATE.editor.selected_entity || clicked_entity->entity->camera != NULL || clicked_entity->entity == origin)
-                    {
-                        clicked_entity = clicked_entity->next;
+                // TODO: we can only select rendered objects rn
+                struct ye_spatial_hit hits[32];
+                int hit_count = ye_query_point(mouse_world_x, mouse_world_y, YE_SPATIAL_RENDERERS, hits, 32);
+                for(int i = 0; i < hit_count; i++){
+                    struct ye_entity *clicked_entity = hits[i].entity;
+                    if(clicked_entity == YE_STATE.editor.selected_entity || clicked_entity->camera != NULL || clicked_entity == origin)
                         continue;
-                    }
-
-                    // TODO: we can only select rendered objects rn
-                    if (
-                        clicked_entity->entity->renderer != NULL && 
-                        ye_point_in_rect(mouse_world_x, mouse_world_y, ye_get_position_rect(clicked_entity->entity, YE_COMPONENT_RENDERER)))
-                    {
-                        // we clicked on this entity
-                        if (clicked_entity->entity != YE_STATE.editor.selected_entity)
-                        {
-                            YE_STATE.editor.selected_entity = clicked_entity->entity;
-                        }
-                        nothing = false;
-                        break;
-                    }
-                    clicked_entity = clicked_entity->next; // TODO: solve world mouse point
+
+                    // we clicked on this entity (hits are sorted topmost first)
+                    YE_STATE.editor.selected_entity = clicked_entity;
+                    nothing = false;
+                    break;
                 }
                 if(nothing){
                     YE_STATE.editor.selected_entity = NULL;
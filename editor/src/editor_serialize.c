@@ -206,6 +206,10 @@ void serialize_entity_physics(struct ye_entity *entity, json_t *entity_json){
     // set the rotational velocity
     json_object_set_new(physics, "rotational velocity", json_real(entity->physics->rotational_velocity));
 
+    // set the collision response
+    json_object_set_new(physics, "restitution", json_real(entity->physics->restitution));
+    json_object_set_new(physics, "friction", json_real(entity->physics->friction));
+
     // add the velocity object to the physics object
     json_object_set_new(physics, "velocity", velocity);
 
@@ -233,6 +237,29 @@ void serialize_entity_collider(struct ye_entity *entity, json_t *entity_json){
     json_object_set_new(entity_json, "collider", collider);
 }
 
+void serialize_entity_audiosource(struct ye_entity *entity, json_t *entity_json){
+    // create the audiosource object
+    json_t *audiosource = json_object();
+
+    // set the active state
+    json_object_set_new(audiosource, "active", json_boolean(entity->audiosource->active));
+
+    // set the sound and how it plays
+    json_object_set_new(audiosource, "src", json_string(entity->audiosource->filename));
+    json_object_set_new(audiosource, "playing", json_boolean(entity->audiosource->playing));
+    json_object_set_new(audiosource, "loops", json_integer(entity->audiosource->loops));
+    json_object_set_new(audiosource, "volume", json_integer(entity->audiosource->volume));
+    json_object_set_new(audiosource, "priority", json_integer(entity->audiosource->priority));
+
+    // set the position and how far it carries
+    serialize_entity_position(&entity->audiosource->rect, audiosource);
+    json_object_set_new(audiosource, "relative", json_boolean(entity->audiosource->relative));
+    json_object_set_new(audiosource, "range", json_real(entity->audiosource->range));
+
+    // add the audiosource object to the entity json
+    json_object_set_new(entity_json, "audiosource", audiosource);
+}
+
 void serialize_entity_tag(struct ye_entity *entity, json_t *entity_json){
     // create the tag object
     json_t *tag = json_object();
@@ -318,6 +345,10 @@ void editor_write_scene_to_disk(const char *path){
             serialize_entity_tag(entity, json_object_get(entity_json, "components"));
         }
 
+        if(entity->audiosource != NULL){
+            serialize_entity_audiosource(entity, json_object_get(entity_json, "components"));
+        }
+
         // add the entity to the entity json array
         json_array_append_new(entities, entity_json);
 
@@ -327,6 +358,11 @@ void editor_write_scene_to_disk(const char *path){
     // update the scene file with the new entity list
     json_object_set_new(json_object_get(scene, "scene"), "entities", entities);
 
+    // record everything the scene references so the runtime can prefetch it in parallel
+    json_t *manifest = ye_build_scene_manifest(scene);
+    if(manifest != NULL)
+        json_object_set_new(scene, "manifest", manifest);
+
     // ye_json_log(scene); //TODO: figure out how we update the name version styles and prefabs
 
     // write the scene file
@@ -372,6 +372,11 @@ void _paint_physics(struct nk_context *ctx, struct ye_entity *ent){
             nk_layout_row_dynamic(ctx, 25, 2);
             nk_label(ctx, "Rotational Velocity:", NK_TEXT_CENTERED);
             nk_property_float(ctx, "#rv", -1000000, &ent->physics->rotational_velocity, 1000000, 1, 5);
+            nk_layout_row_dynamic(ctx, 25, 4);
+            nk_label(ctx, "Restitution:", NK_TEXT_CENTERED);
+            nk_property_float(ctx, "#restitution", 0, &ent->physics->restitution, 1, 0.05f, 0.01f);
+            nk_label(ctx, "Friction:", NK_TEXT_CENTERED);
+            nk_property_float(ctx, "#friction", 0, &ent->physics->friction, 1, 0.05f, 0.01f);
             
             nk_layout_row_dynamic(ctx, 25, 1);
             if(nk_button_label(ctx, "Remove Component")){
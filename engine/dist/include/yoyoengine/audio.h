@@ -19,11 +19,46 @@
 /**
  * @file audio.h
  * @brief The engine API for handling audio
+ *
+ * Short effects are decoded once and kept in the sound cache. The first time one is played it is decoded on a
+ * background thread and starts on the next frame, so the main loop never waits on audio I/O. Long tracks should
+ * be played with @ref ye_play_music, which streams them through Mix_Music instead of decoding them up front
+ * (only one can play at a time).
+ *
+ * Effects play on a pool of "audio_channels" voices. When every voice is busy, a new sound takes over the voice
+ * playing the lowest priority sound that is not more important than it (the quietest, then the oldest, among equals).
+ * If there is none it is dropped. How many voices were requested, played, stolen and dropped last frame is exposed
+ * in @ref ye_runtime_data.
  */
 
 #ifndef YE_AUDIO_H
 #define YE_AUDIO_H
 
+#include <stdbool.h>
+
+#include <SDL2/SDL.h>
+
+/*
+    Number of mixer channels (voices) if settings.yoyo does not specify "audio_channels"
+*/
+#ifndef YE_DEFAULT_AUDIO_CHANNELS
+    #define YE_DEFAULT_AUDIO_CHANNELS 16
+#endif
+
+/*
+    Priority given to sounds played without one, priorities are compared as plain ints (higher wins)
+*/
+#ifndef YE_DEFAULT_SOUND_PRIORITY
+    #define YE_DEFAULT_SOUND_PRIORITY 128
+#endif
+
+/*
+    Files bigger than this (in KB, encoded) passed to ye_play_sound log a warning suggesting ye_play_music
+*/
+#ifndef YE_LARGE_SOUND_KB
+    #define YE_LARGE_SOUND_KB 1024
+#endif
+
 // counter for audio chunks
 extern int totalChunks;
 
@@ -34,12 +69,112 @@ void ye_audio_init();
 
 /**
  * @brief Play a sound by its filename path and specify number of loops.
+ *
+ * If the sound is not cached yet it is decoded in the background and starts playing on the next frame it is ready.
+ * Files of any size are decoded as effects, files over YE_LARGE_SOUND_KB log a warning (stream those with @ref ye_play_music).
+ *
  * @param pFilename The path to the audio file.
  * @param channel The audio channel to play the sound on.
  * @param loops The number of times to loop the sound. -1 for infinite looping.
  */
 void ye_play_sound(const char *pFilename, int channel, int loops);
 
+/**
+ * @brief Same as @ref ye_play_sound, but with a priority deciding which voices it may take over (and be taken over by).
+ * @param pFilename The path to the audio file.
+ * @param channel The audio channel to play the sound on, -1 for any free (or stealable) voice.
+ * @param loops The number of times to loop the sound. -1 for infinite looping.
+ * @param priority Higher priorities are kept over lower ones when the voices run out.
+ */
+void ye_play_sound_priority(const char *pFilename, int channel, int loops, int priority);
+
+/**
+ * @brief Starts decoding a sound in the background so a later play does not have to wait for it.
+ * @param pFilename The path to the audio file.
+ */
+void ye_preload_sound(const char *pFilename);
+
+/**
+ * @brief Plays a sound only if it is already cached, returning the channel it landed on.
+ *
+ * Unlike @ref ye_play_sound this never decodes or streams, which makes it usable by systems that need to
+ * keep track of (and keep adjusting) the channel a sound is playing on. Pair it with @ref ye_preload_sound.
+ *
+ * @param pFilename The path to the audio file.
+ * @param channel The audio channel to play the sound on, -1 for any free (or stealable) voice.
+ * @param loops The number of times to loop the sound. -1 for infinite looping.
+ * @param priority Higher priorities are kept over lower ones when the voices run out.
+ * @return int The channel the sound is playing on, -1 if it is not cached or was dropped.
+ */
+int ye_play_cached_sound(const char *pFilename, int channel, int loops, int priority);
+
+/**
+ * @brief Identifies the play currently on a channel.
+ *
+ * Every play gets a new id, so comparing it to the id seen when the sound started tells whether
+ * the sound is still the one playing (it has not finished or been stolen).
+ *
+ * @param channel The audio channel.
+ * @return unsigned int The id of what the channel is playing, 0 if it is idle.
+ */
+unsigned int ye_channel_voice_id(int channel);
+
+/**
+ * @brief Overrides the volume and stereo panning of a playing channel until its sound stops.
+ * @param channel The audio channel.
+ * @param volume The volume 0-128, scaled by whatever volume the channel was set to.
+ * @param left The volume of the left speaker 0-255.
+ * @param right The volume of the right speaker 0-255.
+ */
+void ye_spatialize_channel(int channel, int volume, Uint8 left, Uint8 right);
+
+/**
+ * @brief Stops whatever is playing on a channel and frees its voice right away.
+ * @param channel The audio channel.
+ */
+void ye_stop_channel(int channel);
+
+/**
+ * @brief Starts sounds that finished decoding and releases ones that finished playing. Called once per frame by the engine.
+ */
+void ye_audio_update();
+
+/**
+ * @brief Streams a track from disk (or the resource pack) through Mix_Music, replacing whatever track is playing.
+ * @param path The path to the audio file.
+ * @param loops The number of times to play the track. -1 for infinite looping.
+ * @param fade_in_ms How long to fade the track in over, 0 to start at full volume.
+ * @return true if the track started playing.
+ */
+bool ye_play_music(const char *path, int loops, int fade_in_ms);
+
+/**
+ * @brief Stops the current track.
+ * @param fade_out_ms How long to fade the track out over, 0 to stop immediately.
+ */
+void ye_stop_music(int fade_out_ms);
+
+/**
+ * @brief Pauses the current track.
+ */
+void ye_pause_music();
+
+/**
+ * @brief Resumes the current track after @ref ye_pause_music.
+ */
+void ye_resume_music();
+
+/**
+ * @brief Returns whether a track is currently playing.
+ */
+bool ye_music_playing();
+
+/**
+ * @brief Set the volume of the music track 0-128.
+ * @param volume The volume level to set. Range is 0-128.
+ */
+void ye_set_music_volume(int volume);
+
 /**
  * @brief Set a specific (or all channels if passed -1) volume level 0-128.
  * @param channel The audio channel to set the volume for. -1 for all channels.
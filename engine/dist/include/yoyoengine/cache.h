@@ -21,8 +21,8 @@
  * @brief The engine API for caching resources
  * 
  * Cache System:
- * The goal of this cache system is to be something that supports the engine for the long term. The chosen paradigm is that of a refcount-less cache, which accumulates
- * items either manually, or from pre loaded files. The public API supports getting resources from the cache (if existant) through functions like `ye_image` and `ye_font`.
+ * The goal of this cache system is to be something that supports the engine for the long term. Items accumulate
+ * either manually, or from pre loaded files. The public API supports getting resources from the cache (if existant) through functions like `ye_image` and `ye_font`.
  * There are also functions for manually adding resources to the cache, such as `ye_create_texture` and `ye_create_font`.
  * The cache is only explicitely cleared when ye_clear_*_cache is called, which will free all cached resources of specified type.
  * Normally, the scene manager will just clear the texture cache between scenes. The font and color cache will be cleared when the engine is shut down.
@@ -42,16 +42,27 @@
  * The cache is very opt in, as you are only required to pass the pointers to resources when constructing ECS
  * components, meaning you could forgo the cache entirely and manually manage your memory. This is not recommended.
  * 
- * Tracking cache size:
+ * Texture budget:
  * 
- * This could be pretty easily done, but its not strictly necessary and will add overhead (unless optimized out)
- * It could be done like this if ever needed:
+ * Every cached texture tracks its approximate size (w * h * bytes per pixel) and how many renderer components hold it
+ * (through @ref ye_image_acquire and @ref ye_image_release). When the total goes over the `texture_cache_budget_mb` setting,
+ * the least recently used textures that nobody holds are evicted. A budget of 0 disables eviction.
+ * Pointers returned by plain @ref ye_image are not counted, so only hold onto them for the current frame (or acquire them).
+ * The size, hit, miss and eviction counters are exposed in @ref ye_runtime_data.
  * 
- * int ye_texture_size(SDL_Texture *texture){
- *    int w, h;
- *   SDL_QueryTexture(texture, NULL, NULL, &w, &h);
- *   return w * h * 4;
- * }
+ * Sounds:
+ * 
+ * Sound effects are decoded once into a Mix_Chunk and cached by path the same way textures are, so playing one is just
+ * Mix_PlayChannel on the cached chunk. A channel holds a reference to its chunk until it finishes, and unreferenced chunks are
+ * evicted least recently used first when the total goes over the `sound_cache_budget_mb` setting. Scene manifests decode
+ * their sounds ahead of time along with their textures.
+ * 
+ * Downscaled variants:
+ * 
+ * When a cached texture is drawn at less than half its size (ex: a zoomed out camera), the renderer asks
+ * @ref ye_image_variant for the smallest halved copy that is still at least as big as it is on screen.
+ * Variants are generated the first time they are asked for (at the start of the next frame) and count towards
+ * the texture budget of their texture, so textures that are never drawn small never pay for them.
  * 
  * TODO:
  * - destruction of individual cache items
@@ -64,8 +75,31 @@
 #ifndef YE_CACHE_H
 #define YE_CACHE_H
 
+#include <stdint.h>
+#include <SDL_mixer.h>
 #include <yoyoengine/yoyoengine.h>
 
+/*
+    Default texture cache budget (in megabytes) if settings.yoyo does not specify one
+*/
+#ifndef YE_DEFAULT_TEXTURE_CACHE_BUDGET_MB
+    #define YE_DEFAULT_TEXTURE_CACHE_BUDGET_MB 256
+#endif
+
+/*
+    Default sound cache budget (in megabytes) if settings.yoyo does not specify one
+*/
+#ifndef YE_DEFAULT_SOUND_CACHE_BUDGET_MB
+    #define YE_DEFAULT_SOUND_CACHE_BUDGET_MB 64
+#endif
+
+/*
+    How many halved variants (1/2, 1/4, ...) a texture can have, 0 to disable them
+*/
+#ifndef YE_TEXTURE_VARIANT_LEVELS
+    #define YE_TEXTURE_VARIANT_LEVELS 4
+#endif
+
 /**
  * @brief Pre-caches a scene.
  * 
@@ -92,6 +126,13 @@ void ye_pre_cache_styles(const char *styles_path);
  */
 void ye_clear_texture_cache();
 
+/**
+ * @brief Clears the sound cache.
+ * 
+ * Frees every cached sound that is not playing (or otherwise held). The audio system clears everything on shutdown.
+ */
+void ye_clear_sound_cache();
+
 /**
  * @brief Clears the font cache.
  * 
@@ -120,13 +161,50 @@ void ye_init_cache();
  */
 void ye_shutdown_cache();
 
+struct ye_texture_alias;
+
 /**
  * @brief A node for a cached texture.
  */
 struct ye_texture_node {
     SDL_Texture *texture; /**< The cached texture. */
-    char *path; /**< The path to the texture. */
+    char *path; /**< The (normalized) path to the texture. */
+    uint64_t content_hash; /**< Hash of the file the texture was decoded from, 0 if unknown. */
+    struct ye_texture_alias *aliases; /**< Other paths to byte-identical files (checked byte for byte, not just by hash), sharing this texture. */
+    SDL_Texture *variants[YE_TEXTURE_VARIANT_LEVELS > 0 ? YE_TEXTURE_VARIANT_LEVELS : 1]; /**< Halved copies of the texture, variants[0] is half size. */
+    int variant_count; /**< How many variants have been generated. */
+    int variants_wanted; /**< How many variants the renderer has asked for. */
+    size_t bytes; /**< Approximate memory held by the texture (and its variants). */
+    int refcount; /**< How many holders acquired this texture, it cannot be evicted while > 0. */
+    struct ye_texture_node *lru_prev; /**< The next more recently used texture. */
+    struct ye_texture_node *lru_next; /**< The next less recently used texture. */
     UT_hash_handle hh; /**< The hash handle. */
+    UT_hash_handle hh_texture; /**< The hash handle keyed by texture pointer. */
+    UT_hash_handle hh_content; /**< The hash handle keyed by content hash. */
+};
+
+/**
+ * @brief Another path whose file is byte-identical to an already cached texture, and shares it.
+ */
+struct ye_texture_alias {
+    char *path; /**< The (normalized) path. */
+    struct ye_texture_node *node; /**< The node holding the shared texture. */
+    struct ye_texture_alias *next; /**< The next alias of the same node. */
+    UT_hash_handle hh; /**< The hash handle. */
+};
+
+/**
+ * @brief A node for a cached sound.
+ */
+struct ye_sound_node {
+    Mix_Chunk *chunk; /**< The decoded sound. */
+    char *path; /**< The (normalized) path to the sound. */
+    size_t bytes; /**< Memory held by the decoded samples. */
+    int refcount; /**< How many channels (or other holders) are using it, it cannot be evicted while > 0. */
+    struct ye_sound_node *lru_prev; /**< The next more recently used sound. */
+    struct ye_sound_node *lru_next; /**< The next less recently used sound. */
+    UT_hash_handle hh; /**< The hash handle. */
+    UT_hash_handle hh_chunk; /**< The hash handle keyed by chunk pointer. */
 };
 
 /**
@@ -157,6 +235,8 @@ struct ye_color_node {
  * @brief API specific to caching access.
  * 
  * The idea is accessing any sort of resource routes through here, and the cache layer will handle the loading.
+ * Texture paths can be relative to the resources folder or already resolved (ex: by ye_get_resource_static), they are
+ * normalized into the same key either way. Byte-identical image files share a single texture regardless of their path.
  * Colors and fonts must be created in styles.yoyo, (or manually before usage) and can be indexed by name. Fonts must be declared at a specific size in styles.yoyo.
  * @{
  */
@@ -168,6 +248,53 @@ struct ye_color_node {
  */
 SDL_Texture * ye_image(const char *path);
 
+/**
+ * @brief Writes the canonical cache key for a texture path (normalized, and resolved against the resources folder if relative).
+ * @param path The path to the texture.
+ * @param key The buffer to write the key into.
+ * @param size The size of key.
+ * @return false if the key did not fit.
+ */
+bool ye_image_key(const char *path, char *key, size_t size);
+
+/**
+ * @brief Returns whether a texture is currently cached, without loading it or counting as a hit or miss.
+ * @param path The path to the texture.
+ * @return true if the texture is cached.
+ */
+bool ye_image_is_cached(const char *path);
+
+/**
+ * @brief Same as @ref ye_image, but holds a reference so the texture will not be evicted until released.
+ * @param path The path to the texture.
+ * @return The cached texture.
+ */
+SDL_Texture * ye_image_acquire(const char *path);
+
+/**
+ * @brief Picks the smallest downscaled variant of a cached texture that still covers a size on screen.
+ *
+ * Textures that are not cached (ex: text) or are not drawn below half size are returned as is. If the right variant has
+ * not been generated yet, the closest one that exists is returned and the rest are generated next frame.
+ *
+ * @param texture The texture being drawn.
+ * @param w The width (in pixels) it covers on screen.
+ * @param h The height (in pixels) it covers on screen.
+ * @return The texture to draw instead.
+ */
+SDL_Texture * ye_image_variant(SDL_Texture *texture, int w, int h);
+
+/**
+ * @brief Generates any variants requested through @ref ye_image_variant. Called by @ref ye_render_all before painting.
+ */
+void ye_generate_texture_variants();
+
+/**
+ * @brief Releases a reference taken with @ref ye_image_acquire, making the texture evictable once nobody holds it.
+ * @param texture The texture to release.
+ */
+void ye_image_release(SDL_Texture *texture);
+
 /**
  * @brief Returns the pointer to a cached font based on name and size, returning a fallback default font if not found.
  * @param name The name of the font.
@@ -182,6 +309,33 @@ TTF_Font * ye_font(const char *name, int size);
  */
 SDL_Color * ye_color(const char *name);
 
+/**
+ * @brief Returns the pointer to a cached sound, decoding it if its not already cached.
+ * @param path The path to the sound.
+ * @return The cached sound, or NULL if it could not be loaded.
+ */
+Mix_Chunk * ye_sound(const char *path);
+
+/**
+ * @brief Returns whether a sound is currently cached, without loading it.
+ * @param path The path to the sound.
+ * @return true if the sound is cached.
+ */
+bool ye_sound_is_cached(const char *path);
+
+/**
+ * @brief Same as @ref ye_sound, but holds a reference so the sound will not be evicted until released.
+ * @param path The path to the sound.
+ * @return The cached sound, or NULL if it could not be loaded.
+ */
+Mix_Chunk * ye_sound_acquire(const char *path);
+
+/**
+ * @brief Releases a reference taken with @ref ye_sound_acquire, making the sound evictable once nobody holds it.
+ * @param chunk The sound to release.
+ */
+void ye_sound_release(Mix_Chunk *chunk);
+
 /** @} */ // end of CacheAPI
 
 /**
@@ -198,6 +352,45 @@ SDL_Color * ye_color(const char *name);
  */
 SDL_Texture * ye_cache_texture(const char *path);
 
+/**
+ * @brief Caches a texture that was already created elsewhere (ex: by the scene prefetcher) under a path.
+ * @param path The path to cache the texture under.
+ * @param texture The texture, the cache takes ownership of it.
+ * @param content_hash The hash of the file it was decoded from (see @ref ye_image_source), or 0 if unknown.
+ * @return The cached texture. If path was already cached, or another file with the same contents was,
+ * that texture is returned instead and the passed one is destroyed.
+ */
+SDL_Texture * ye_cache_texture_preloaded(const char *path, SDL_Texture *texture, uint64_t content_hash);
+
+/**
+ * @brief Replaces the pixels of a cached texture, keeping every holder of it pointed at the new contents.
+ *
+ * If the size is unchanged the existing SDL_Texture is updated in place, otherwise a new one is created
+ * and renderer components holding the old one are switched over to it. If other paths were sharing the
+ * texture because their files were identical, this path is split off into its own texture first, so only
+ * what was loaded through this path changes.
+ *
+ * @param path The path the texture is cached under.
+ * @param surface The new pixels (not freed).
+ * @return true if the texture was cached and has been reloaded.
+ */
+bool ye_cache_reload_texture(const char *path, SDL_Surface *surface);
+
+/**
+ * @brief Decode a sound from path and add it to the cache.
+ * @param path The path to the sound.
+ * @return The cached sound, or NULL if it could not be loaded.
+ */
+Mix_Chunk * ye_cache_sound(const char *path);
+
+/**
+ * @brief Add an already decoded sound to the cache under path.
+ * @param path The path the sound was loaded from.
+ * @param chunk The decoded sound, ownership passes to the cache.
+ * @return The cached sound. If path was already cached that sound is returned instead and the passed one is freed.
+ */
+Mix_Chunk * ye_cache_sound_preloaded(const char *path, Mix_Chunk *chunk);
+
 /**
  * @brief Create a font from name, size, and path.
  * @param name The name of the font.
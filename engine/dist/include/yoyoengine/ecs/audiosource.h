@@ -18,7 +18,15 @@
 
 /**
  * @file audiosource.h
- * @brief NOT YET DOCUMENTED OR IMPLEMENTED
+ * @brief ECS Audio source component
+ *
+ * An audio source is a sound that lives somewhere in the scene. Once per frame @ref ye_system_audio works out,
+ * for every source at once, how loud it should be and where it sits in the stereo field relative to the center
+ * of the target camera. Sources that end up out of earshot are culled: they are not given a voice, and one that
+ * was playing gives its voice back, so a scene full of far away sources costs no channels.
+ *
+ * Looping sources that get culled start again once they come back into range. One shot sources that are out of
+ * range when they play (or wander out of range while playing) are simply done.
  */
 
 #ifndef YE_AUDIOSOURCE_H
@@ -27,46 +35,79 @@
 #include <yoyoengine/yoyoengine.h>
 
 /*
-    This spatialized audio relies on:
-    - relative positioning options for components
-    which relies on:
-    - figuring out rect vs bounds
-
-    also:
-    - circular areas of effect (optional)?
+    Distance (in world units) from a source at which it fades to silence, if it does not specify one
 */
+#ifndef YE_AUDIOSOURCE_DEFAULT_RANGE
+    #define YE_AUDIOSOURCE_DEFAULT_RANGE 1500.0f
+#endif
 
 /*
-    For audio sources, we dont really care about some of the traditional priorities for a complete audio api, these are more about very basic
-    sounds playing in a scene. they have a position, a volume, and a file name source. Their channel is automatically assigned by the engine. Active means the component is even enabled,
-    there is a seperate bool for "playing" which can be used to unload the sound if it is not playing and we are outside of earshot
+    Sources attenuated below this volume (0-128) are treated as inaudible and culled
 */
+#ifndef YE_AUDIOSOURCE_CULL_VOLUME
+    #define YE_AUDIOSOURCE_CULL_VOLUME 2
+#endif
 
+/**
+ * @brief A structure to represent an audio source component.
+ *
+ * Active means the component is even enabled, playing is whether the source wants to be heard.
+ * The channel it plays on is assigned (and taken back) by the engine.
+ */
 struct ye_component_audiosource {
-    bool active;
-    bool playing;
-    char *filename;
-    int loops;
-    int volume;
-
-    // struct ye_position pos; TODO
-    
-    // reserved for engine tracking and manipulation:
+    bool active;        ///< controls whether system will act upon this component
+    bool playing;       ///< whether the source wants to be playing, cleared once a one shot finishes
+    char *filename;     ///< path to the sound
+    int loops;          ///< number of times to loop the sound, -1 for infinite
+    int volume;         ///< volume of the source 0-128 before attenuation
+    int priority;       ///< priority of its voice when the channels run out (see @ref ye_play_sound_priority)
+
+    bool relative;          ///< whether or not this comp is relative to a parent transform
+    struct ye_rectf rect;   ///< area of the source, the sound comes from its center
+    float range;            ///< distance from the center at which it fades to silence, <= 0 to not attenuate or pan at all
 
-    int channel;
+    // reserved for engine tracking and manipulation:
 
-    // honestly why not just load the sound here, we would have to do it anyway, possibly multiple times if we are registering and de registering
+    int channel;                ///< the channel it is playing on, -1 if it has no voice
+    unsigned int voice_id;      ///< id of the play it started (see @ref ye_channel_voice_id)
+    bool audible;               ///< whether it was in earshot last frame
+    int computed_volume;        ///< attenuated volume applied to its channel
+    Uint8 computed_left;        ///< left speaker volume applied to its channel
+    Uint8 computed_right;       ///< right speaker volume applied to its channel
 };
 
-/*
-    Constructs the audio source component for the given entity. The filename is the path to the audio file, and loops is the number of times
-*/
+/**
+ * @brief Adds an audio source component to an entity. It starts stopped, call @ref ye_play_audiosource to hear it.
+ * @param entity The entity to add the audio source component to.
+ * @param pFilename The path to the sound.
+ * @param loops The number of times to loop the sound. -1 for infinite looping.
+ */
 void ye_add_audiosource_component(struct ye_entity *entity, const char *pFilename, int loops);
 
+/**
+ * @brief Starts the source playing from the beginning (once it is in earshot and its sound is decoded).
+ * @param entity The entity whose audio source should play.
+ */
 void ye_play_audiosource(struct ye_entity *entity);
 
+/**
+ * @brief Stops the source and frees its voice. Playing it again starts it from the beginning.
+ * @param entity The entity whose audio source should stop.
+ */
 void ye_pause_audiosource(struct ye_entity *entity);
 
+/**
+ * @brief Removes an audio source component from an entity, stopping it if it is playing.
+ * @param entity The entity to remove the audio source component from.
+ */
 void ye_remove_audiosource_component(struct ye_entity *entity);
 
-#endif
\ No newline at end of file
+/**
+ * @brief Handles the audio source system.
+ *
+ * Computes the attenuation and panning of every source relative to the target camera in one pass, then
+ * starts, culls and updates their voices in a second. Sources without a target camera play unattenuated.
+ */
+void ye_system_audio();
+
+#endif
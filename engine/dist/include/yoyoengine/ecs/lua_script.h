@@ -19,6 +19,30 @@
 /**
  * @file lua_script.h
  * @brief lua script component
+ *
+ * By default every script shares a single lua_State (with the standard libraries and engine API loaded once),
+ * and each entity's script runs inside its own environment table. Globals a script defines land in its
+ * environment, so scripts cannot see or clobber each other, while reads fall through to the shared globals.
+ * Setting "lua_shared_state" to false in settings.yoyo gives every script its own lua_State instead.
+ *
+ * Scripts can define on_mount(entity), on_update(entity, dt) and on_unmount(entity). They are looked up once
+ * when the script loads and called through registry references from then on. on_mount runs as a task, so it
+ * (and anything started with ye_start_task) can call wait(seconds), wait_frames(n) or wait_event(name)
+ * instead of polling timers in on_update. See lua_api.h.
+ *
+ * Each script file is compiled once and every entity using it loads the cached bytecode. If
+ * "lua_bytecode_cache_path" is set, the bytecode is also persisted there so later runs skip compiling. Lua
+ * does not verify bytecode, so that folder must only ever be written by the engine.
+ *
+ * Garbage collection is driven by the engine: automatic collection is stopped in every state, and after the
+ * scripts run each frame @ref ye_lua_gc_step spends at most "lua_gc_budget_ms" stepping the collectors of
+ * states that grew, taking turns between them. A state that runs away from its budget gets a full collection.
+ * Set "lua_gc_budget_ms" to 0 to leave collection to lua, and "lua_gc_generational" to use generational mode
+ * (where each state that grew gets one young collection per frame instead of budgeted incremental steps).
+ *
+ * Every state allocates from the engine's lua pools (see lua_alloc.c), and every byte is charged to the script
+ * that allocated it. With "lua_script_memory_limit_kb" set (or @ref ye_set_lua_script_memory_limit), a script
+ * that tries to grow past its limit gets a lua memory error, and is disabled if that error escapes a callback.
  */
 
 #ifndef YE_LUA_SCRIPT_H
@@ -30,6 +54,42 @@
 #include <lualib.h>
 #include <lauxlib.h>
 
+/*
+    Default time (ms) each frame may spend collecting lua garbage if settings.yoyo does not specify "lua_gc_budget_ms"
+*/
+#ifndef YE_DEFAULT_LUA_GC_BUDGET_MS
+    #define YE_DEFAULT_LUA_GC_BUDGET_MS 1.0f
+#endif
+
+/*
+    How much work (in KB of allocation) each collector step does, the budget is checked between steps
+*/
+#ifndef YE_LUA_GC_STEP_KB
+    #define YE_LUA_GC_STEP_KB 16
+#endif
+
+/*
+    A state starts a collection cycle once it grows to this percent of what it held after its last one
+*/
+#ifndef YE_LUA_GC_PAUSE_PERCENT
+    #define YE_LUA_GC_PAUSE_PERCENT 150
+#endif
+
+/*
+    A state that grows past this percent of what it held after its last cycle is fully collected, ignoring the budget
+*/
+#ifndef YE_LUA_GC_EMERGENCY_PERCENT
+    #define YE_LUA_GC_EMERGENCY_PERCENT 400
+#endif
+
+/**
+ * @brief Where the engine is at collecting one lua state.
+ */
+struct ye_lua_gc {
+    size_t baseline;    // bytes the state held after its last finished cycle, 0 if it never finished one
+    bool collecting;    // whether a cycle is in progress
+};
+
 /**
  * @brief The script component for lua. Will recieve callbacks from the engine.
  */
@@ -37,18 +97,64 @@ struct ye_component_lua_script {
     bool active;                    // controls whether system will act upon this component
     char *script_path;              // the path to the script
 
-    lua_State *state;               // the lua state for this script
+    lua_State *state;               // the lua state for this script (the shared one, unless it has its own)
+    bool shared_state;              // whether state is the shared state (and must not be closed with the script)
+    int env_ref;                    // registry reference to the scripts environment table, LUA_NOREF if it has its own state
+    struct ye_lua_gc gc;            // collection progress of its own state (unused if shared)
+
+    struct ye_entity *entity;       // the entity the script is attached to, passed to every callback
+    uint32_t memory_owner;          // what the lua allocator charges this scripts memory to
+    struct ye_lua_task *tasks;      // the scripts suspended (or running) tasks
 
     /*
-        Once the script is boostrapped, we parse references so we know
-        not to look for invalid references.
+        Once the script is boostrapped, we take registry references to its callbacks
+        so they are called directly. LUA_NOREF if the script does not define one.
     */
-    bool has_on_mount;
-    bool has_on_unmount;
-    bool has_on_update;
+    int on_mount_ref;
+    int on_unmount_ref;
+    int on_update_ref;
     // ... etc
 };
 
+/**
+ * @brief The lua_State shared by every script, NULL if scripts get their own or scripting is not initialized.
+ */
+extern lua_State *lua_shared_state;
+
+/**
+ * @brief Initialize lua scripting, creating the shared state if "lua_shared_state" is enabled.
+ */
+void ye_init_lua_scripting();
+
+/**
+ * @brief Shut down lua scripting, closing the shared state. Every script component must be removed first.
+ */
+void ye_shutdown_lua_scripting();
+
+/**
+ * @brief Steps the collectors of the lua states within the per frame budget. Called once per frame by the engine after the scripts run.
+ */
+void ye_lua_gc_step();
+
+/**
+ * @brief How much memory a lua state is using.
+ * @param state The lua state
+ * @return size_t The bytes it has allocated
+ */
+size_t ye_lua_state_memory(lua_State *state);
+
+/**
+ * @brief Frees every compiled script held in memory. Scripts compile again the next time they are added.
+ */
+void ye_clear_lua_bytecode_cache();
+
+/**
+ * @brief Pushes the table a script's globals live in (its environment, or the globals of its own state).
+ * 
+ * @param script The script whose environment to push onto its state's stack
+ */
+void ye_lua_script_push_env(struct ye_component_lua_script *script);
+
 /**
  * @brief Add a lua script component to an entity
  * 
@@ -64,9 +170,25 @@ bool ye_add_lua_script_component(struct ye_entity *entity, char *script_path);
  */
 void ye_remove_lua_script_component(struct ye_entity *entity);
 
+/**
+ * @brief Sets how much memory an entity's script may hold, overriding "lua_script_memory_limit_kb".
+ * 
+ * @param entity The entity with the script
+ * @param limit The limit in bytes, 0 for no limit
+ */
+void ye_set_lua_script_memory_limit(struct ye_entity *entity, size_t limit);
+
+/**
+ * @brief How much memory an entity's script is holding (in whatever state it runs in).
+ * 
+ * @param entity The entity with the script
+ * @return size_t The bytes charged to it, 0 if it has no script
+ */
+size_t ye_lua_script_memory(struct ye_entity *entity);
+
 /**
  * @brief The system that controls the behavior of lua scripts
  */
 void ye_system_lua_scripting();
 
-#endif
\ No newline at end of file
+#endif
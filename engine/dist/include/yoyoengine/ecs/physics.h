@@ -33,6 +33,22 @@
     #define YE_PHYSICS_SUBSTEPS 10
 #endif
 
+/*
+    How many bodies (or broadphase pairs) each worker grabs at a time.
+    Steps with fewer than this run entirely on the main thread.
+*/
+#ifndef YE_PHYSICS_PARALLEL_GRAIN
+    #define YE_PHYSICS_PARALLEL_GRAIN 256
+#endif
+
+/*
+    Friction is the fraction of sliding velocity lost over 1/YE_PHYSICS_FRICTION_RATE seconds
+    of contact, so the same value slows a body down just as fast at any framerate.
+*/
+#ifndef YE_PHYSICS_FRICTION_RATE
+    #define YE_PHYSICS_FRICTION_RATE 60
+#endif
+
 /**
  * @brief Physics component structure
  *
@@ -43,6 +59,9 @@ struct ye_component_physics {
 
     struct ye_vec2f velocity;           /**< Velocity of entity */
     float rotational_velocity;          /**< Rotational velocity of entity */
+
+    float restitution;                  /**< 0-1, how much velocity into a surface is bounced back (0 stops, 1 is a perfect bounce) */
+    float friction;                     /**< 0-1, how much velocity along a surface is lost per 1/YE_PHYSICS_FRICTION_RATE seconds of contact (0 slides freely, 1 sticks) */
 };
 
 /**
@@ -68,4 +87,9 @@ void ye_remove_physics_component(struct ye_entity *entity);
  */
 void ye_system_physics();
 
+/**
+ * @brief Frees the scratch memory held by the physics system.
+ */
+void ye_shutdown_physics();
+
 #endif
\ No newline at end of file
@@ -191,6 +191,28 @@ void ye_temp_add_animation_renderer_component(struct ye_entity *entity, int z, c
  */
 void ye_remove_renderer_component(struct ye_entity *entity);
 
+/**
+ * @brief Points every renderer holding a texture (including animation frames) at a different texture.
+ * @param old_texture The texture being replaced.
+ * @param new_texture The texture to use instead.
+ */
+void ye_renderer_retarget_texture(SDL_Texture *old_texture, SDL_Texture *new_texture);
+
+/**
+ * @brief Points the renderers (and animation frames) that got a texture through one particular path at a different texture.
+ * @param key The cache key of the path (see @ref ye_image_key).
+ * @param old_texture The texture they hold now.
+ * @param new_texture The texture to use instead.
+ * @return The number of references moved (each image renderer and animation frame counts once).
+ */
+int ye_renderer_retarget_texture_path(const char *key, SDL_Texture *old_texture, SDL_Texture *new_texture);
+
+/**
+ * @brief Switches every image renderer still showing the placeholder for a streamed texture over to the real one.
+ * @param key The cache key of the texture that finished streaming (see @ref ye_image_key).
+ */
+void ye_renderer_texture_streamed(const char *key);
+
 /**
  * @brief Handles the rendering system.
  * @param renderer The SDL renderer to use.
@@ -61,7 +61,8 @@ struct ScreenSize {
  * The path you provide must be relative to the resources folder.
  * Ex: ("images/yoyo.png") will yeild something like /home/user/gamelocation/resources/images/yoyo.png on linux.
  * 
- * Importantly, this is just a pointer to a buffer, and as such will change its value after the next invokation.
+ * The joined path is interned: the first call for a given sub path builds it, and every later call
+ * (from any thread) returns the same pointer. It stays valid until the engine shuts down, and must not be modified or freed.
  * 
  * @param sub_path The path (relative to the resources folder) of the resource you wish to access.
  * @return char* The absolute path to the resource.
@@ -100,8 +101,15 @@ struct ye_engine_config {
     int volume;
     int window_mode;
     int framecap;
+    float fixed_timestep;   // if > 0, every frame steps the simulation by exactly this many seconds
+    int texture_cache_budget_mb; // unreferenced textures are evicted when the cache grows past this, 0 for no limit
+    float texture_upload_budget_ms; // time each frame may spend uploading streamed textures
+    int sound_cache_budget_mb;  // unreferenced sounds are evicted when the cache grows past this, 0 for no limit
+    int audio_channels;         // how many sound effects can play at once
+    int lua_script_memory_limit_kb; // memory each lua script may hold before it is stopped, 0 for no limit
     char *window_title;
     char *icon_path;
+    char *lua_bytecode_cache_path;  // folder compiled lua scripts are persisted to, NULL to only keep them in memory
     
     /*
         Some fields that handle pillarboxing and letterboxing
@@ -125,6 +133,28 @@ struct ye_engine_config {
     */
     bool debug_mode;
 
+    /*
+        Reload textures when their files change on disk (always on in the editor)
+    */
+    bool hot_reload;
+
+    /*
+        Load textures requested mid game in the background, showing a placeholder until they are uploaded
+    */
+    bool stream_textures;
+
+    /*
+        Run every lua script in one shared state (each in its own environment) instead of a state per script
+    */
+    bool lua_shared_state;
+
+    /*
+        Time (ms) each frame may spend collecting lua garbage, 0 to let lua collect on its own.
+        Collectors run in generational mode instead of incremental if lua_gc_generational is set.
+    */
+    float lua_gc_budget_ms;
+    bool lua_gc_generational;
+
     /*
         TODO: remove me?
     */
@@ -136,6 +166,7 @@ struct ye_engine_config {
     char *engine_resources_path;
     char *game_resources_path;
     char *log_file_path;
+    char *resource_pack_path;   // resources.yepk next to the executable unless overridden, mounted if it exists
 
     /*
         Controls which camera the scene is rendered from the perspective of.
@@ -228,6 +259,38 @@ struct ye_runtime_data {
     
     int log_line_count;         // the number of lines in the log file
     int audio_chunk_count;      // the number of audio chunks currently allocated and playing
+    int audio_voices_requested; // sounds asked to play last frame
+    int audio_voices_played;    // of those, how many got a voice
+    int audio_voices_stolen;    // how many had to take a voice from a lower priority sound
+    int audio_voices_dropped;   // how many were not played at all
+
+    size_t texture_cache_bytes;     // approximate memory held by cached textures
+    int texture_cache_count;        // number of cached textures
+    int texture_cache_hits;         // lookups that found the texture already cached
+    int texture_cache_misses;       // lookups that had to load the texture
+    int texture_cache_evictions;    // textures evicted to stay under the budget
+    int texture_cache_dedupes;      // loads that found a byte-identical file already cached under another path
+    int texture_stream_pending;     // streamed textures still decoding or waiting to be uploaded
+    float texture_upload_time;      // time in ms spent uploading streamed textures last frame
+
+    size_t sound_cache_bytes;       // memory held by decoded sounds
+    int sound_cache_count;          // number of cached sounds
+    int sound_cache_hits;           // plays that found the sound already decoded
+    int sound_cache_misses;         // plays that had to decode the sound
+    int sound_cache_evictions;      // sounds evicted to stay under the budget
+
+    int lua_state_count;            // lua states alive (1 when scripts share one)
+    size_t lua_memory_bytes;        // memory held by every lua state
+    size_t lua_max_state_memory_bytes;  // memory held by the largest lua state
+    float lua_gc_time;              // time in ms spent collecting lua garbage last frame
+    int lua_allocations;            // lua allocations served last frame
+    size_t lua_pool_bytes;          // memory reserved by the lua allocator pools
+    int lua_tasks;                  // lua tasks alive (waiting or ready to resume)
+    int lua_tasks_resumed;          // lua tasks resumed by the scheduler last frame
+
+    size_t scene_prefetch_bytes;    // bytes read prefetching the last scene's manifest
+    float scene_prefetch_rate;      // how fast that was read and decoded, in MB/s
+    int scene_ready_time;           // time in ms from starting to load the last scene until it was constructed
     
     char *scene_name;           // TODO: store current scene path for reloading in editor?
     char *scene_file_path;      // the path to the open scene file
@@ -25,6 +25,7 @@
 #define GRAPHICS_H
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #include <SDL_ttf.h>
 
@@ -63,6 +64,47 @@ SDL_Rect createRealPixelRect(bool centered, float x, float y, float w, float h);
  */
 TTF_Font *ye_load_font(const char *pFontPath/*, int fontSize*/);
 
+/**
+ * @brief The encoded bytes of an image (or its pre-decoded .yetex), ready to be hashed and decoded.
+ */
+struct ye_image_source {
+    const unsigned char *data;  ///< the file contents
+    size_t size;                ///< size of data in bytes
+    bool yetex;                 ///< data is a pre-decoded .yetex rather than an encoded image
+    bool owned;                 ///< data was read from disk (rather than pointing into the resource pack)
+    uint64_t hash;              ///< content hash of data
+};
+
+/**
+ * @brief Reads an image (preferring its .yetex, and the resource pack over loose files) without decoding it.
+ * @note Safe to call from any thread.
+ * @param path The path to the image file.
+ * @param source The source to fill in, close it with @ref ye_image_source_close.
+ * @return true if the image (or its .yetex) was found.
+ */
+bool ye_image_source_open(const char *path, struct ye_image_source *source);
+
+/**
+ * @brief Decodes an opened image source into a surface.
+ * @note Safe to call from any thread.
+ * @param source The opened source.
+ * @return The surface (free it with SDL_FreeSurface), or NULL if decoding failed.
+ */
+SDL_Surface * ye_image_source_decode(struct ye_image_source *source);
+
+/**
+ * @brief Creates a texture from an opened image source. Must be called from the main thread.
+ * @param source The opened source.
+ * @return The texture, or NULL if decoding or creating it failed.
+ */
+SDL_Texture * ye_image_source_texture(struct ye_image_source *source);
+
+/**
+ * @brief Releases anything held by an image source.
+ * @param source The source to close.
+ */
+void ye_image_source_close(struct ye_image_source *source);
+
 /**
  * @brief Creates a SDL_Texture from an image file.
  * @param pPath The path to the image file.
@@ -0,0 +1,60 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/yoyolick/yoyoengine)
+    Copyright (C) 2023  Ryan Zmuda
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file hotreload.h
+ * @brief Reloads cached textures when their files change on disk, without reloading the scene.
+ *
+ * A background thread watches the game resources folder (inotify on linux, periodically
+ * re-scanning the folder everywhere else or if inotify is unavailable). When an image or
+ * .yetex changes, only that file is re-decoded, on the watcher thread. The next frame swaps
+ * the new pixels into the cached SDL_Texture, so every renderer holding it picks it up.
+ *
+ * Enabled by the "hot_reload" setting, and always in the editor. Files inside a resource
+ * pack are never reloaded.
+ */
+
+#ifndef YE_HOTRELOAD_H
+#define YE_HOTRELOAD_H
+
+#include <stdbool.h>
+#include <yoyoengine/yoyoengine.h>
+
+/*
+    How often (ms) the polling fallback re-scans the resources folder
+*/
+#ifndef YE_HOT_RELOAD_POLL_MS
+    #define YE_HOT_RELOAD_POLL_MS 500
+#endif
+
+/**
+ * @brief Starts watching the game resources folder, restarting the watcher if it is already running.
+ */
+void ye_init_hot_reload();
+
+/**
+ * @brief Applies any reloads that finished decoding since the last call. Called once per frame by the engine.
+ */
+void ye_hot_reload_poll();
+
+/**
+ * @brief Stops the watcher thread and drops any reloads that were not applied yet.
+ */
+void ye_shutdown_hot_reload();
+
+#endif
@@ -53,6 +53,7 @@ void ye_log_shutdown();
 
 /**
  * @brief Logs a message to the console and console buffer
+ * @note Safe to call from any thread.
  * 
  * @param level The level of the message
  * @param format The content of the message (similar to printf)
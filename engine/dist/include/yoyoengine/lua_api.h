@@ -28,10 +28,164 @@
  */
 void ye_register_lua_scripting_api(lua_State *state);
 
+/*
+    ECS bindings (lua_api_ecs.c)
+
+    Scripts see entities as userdata with id, name, active and one field per component they have
+    (transform, physics, collider, renderer, camera, audiosource). Component fields read and write
+    the component structs directly. Bulk helpers: ye_get_positions, ye_set_positions, ye_set_velocities.
+*/
+
+/**
+ * @brief Registers the entity and component bindings with a lua state.
+ * 
+ * @param state The lua state
+ */
+void ye_register_lua_ecs_api(lua_State *state);
+
+/**
+ * @brief Pushes the userdata scripts use to refer to an entity (nil if entity is NULL).
+ * 
+ * The same userdata is pushed for an entity for as long as lua holds on to it.
+ * 
+ * @param state The lua state to push onto
+ * @param entity The entity
+ */
+void ye_lua_push_entity(lua_State *state, struct ye_entity *entity);
+
+/**
+ * @brief Invalidates every lua handle to an entity, so scripts holding one get an error instead of freed memory.
+ * 
+ * @param entity The entity being destroyed
+ */
+void ye_lua_forget_entity(struct ye_entity *entity);
+
+/*
+    Allocator (lua_alloc.c)
+
+    Every lua state allocates through ye_lua_alloc. Small blocks come from size class pools shared by
+    every state, and every block is charged to a memory owner (one per script, 0 for the engine).
+*/
+
+/**
+ * @brief The lua_Alloc every engine lua state is created with.
+ */
+void * ye_lua_alloc(void *ud, void *ptr, size_t osize, size_t nsize);
+
+/**
+ * @brief Creates a memory owner to charge allocations to.
+ * 
+ * @param limit How many bytes it may hold, 0 for no limit
+ * @return uint32_t The owner (0, the engine, if none could be created)
+ */
+uint32_t ye_lua_memory_owner_create(size_t limit);
+
+/**
+ * @brief Releases an owner. Its id is reused once every block charged to it has been freed.
+ */
+void ye_lua_memory_owner_release(uint32_t owner);
+
+/**
+ * @brief Charges allocations to owner from now on.
+ * 
+ * @return uint32_t The owner that was being charged before, to swap back to
+ */
+uint32_t ye_lua_memory_owner_swap(uint32_t owner);
+
+/**
+ * @brief How many bytes are charged to an owner.
+ */
+size_t ye_lua_memory_owner_usage(uint32_t owner);
+
+/**
+ * @brief Changes how many bytes an owner may hold (0 for no limit), clearing its over limit flag.
+ */
+void ye_lua_memory_owner_set_limit(uint32_t owner, size_t limit);
+
+/**
+ * @brief Whether an owner has had an allocation refused for going over its limit.
+ */
+bool ye_lua_memory_owner_over_limit(uint32_t owner);
+
+/**
+ * @brief Publishes the allocator metrics to YE_STATE.runtime and starts counting the next frame.
+ */
+void ye_lua_alloc_publish_stats();
+
+/**
+ * @brief Frees every pool. Only call once every lua state is closed.
+ */
+void ye_lua_alloc_shutdown();
+
+/*
+    Coroutines (lua_api_coroutines.c)
+
+    on_mount and functions started with ye_start_task(fn, ...) run as tasks (coroutines) that can suspend
+    themselves with wait(seconds), wait_frames(n) and wait_event(name). ye_fire_event(name) wakes everything
+    waiting on name. Waiting tasks sit in time ordered queues and are only touched once they are due.
+*/
+
+/**
+ * @brief The script whose lua code is running right now, NULL outside of scripts.
+ */
+extern struct ye_component_lua_script *lua_running_script;
+
+/**
+ * @brief Registers wait, wait_frames, wait_event, ye_start_task and ye_fire_event with a lua state.
+ * 
+ * @param state The lua state
+ */
+void ye_register_lua_coroutine_api(lua_State *state);
+
+/**
+ * @brief Runs a script callback as a task, passing it the entity, until it finishes or first waits.
+ * 
+ * @param script The script the callback belongs to
+ * @param callback_ref The registry reference to the callback
+ * @return true if the task was started
+ */
+bool ye_lua_start_callback_task(struct ye_component_lua_script *script, int callback_ref);
+
+/**
+ * @brief Drops every task a script has waiting. Called when the script is removed.
+ * 
+ * @param script The script
+ */
+void ye_lua_cancel_script_tasks(struct ye_component_lua_script *script);
+
+/**
+ * @brief Wakes every task waiting on an event. They resume the next time the scheduler steps (this frame, if it has not yet).
+ * 
+ * @param name The name of the event
+ */
+void ye_lua_fire_event(const char *name);
+
+/**
+ * @brief Resumes every task whose wait is over. Called once per frame by the engine after the scripts update.
+ */
+void ye_lua_scheduler_step();
+
+/**
+ * @brief Frees the scheduler's queues. Every script component must be removed first.
+ */
+void ye_lua_scheduler_shutdown();
+
 /*
     Callbacks (lua_api_callbacks.c)
 */
+
+/**
+ * @brief Calls a script callback through its registry reference, passing it the entity (and delta time if pass_delta).
+ * 
+ * @param script The script the callback belongs to
+ * @param callback_ref The registry reference to the callback
+ * @param callback_name The name of the callback, for error messages
+ * @param pass_delta Whether to pass the delta time as a second argument
+ * @return true if the callback ran without errors
+ */
+bool ye_run_lua_callback(struct ye_component_lua_script *script, int callback_ref, const char *callback_name, bool pass_delta);
 void ye_run_lua_on_mount(struct ye_component_lua_script *script);
 void ye_run_lua_on_unmount(struct ye_component_lua_script *script);
+void ye_run_lua_on_update(struct ye_component_lua_script *script);
 
 #endif
\ No newline at end of file
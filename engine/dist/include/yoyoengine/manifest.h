@@ -0,0 +1,70 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/yoyolick/yoyoengine)
+    Copyright (C) 2023  Ryan Zmuda
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file manifest.h
+ * @brief Per-scene asset manifests, and prefetching everything a scene needs before it is constructed.
+ *
+ * When the editor saves a scene it records every texture, font, sound and styles file the
+ * scene references (with their sizes on disk) under the scene's "manifest" key:
+ *
+ * @code
+ * "manifest": {
+ *     "version": 1,
+ *     "total size": 123456,
+ *     "textures": [ { "path": "images/background.png", "size": 100000 }, ... ],
+ *     "fonts": [ ... ], "sounds": [ ... ], "styles": [ ... ]
+ * }
+ * @endcode
+ *
+ * When a scene with a manifest is loaded, every file in it is read (and every texture and sound decoded) in
+ * parallel on the worker pool, then textures are uploaded and sounds cached on the main thread, so
+ * constructing the scene afterwards never has to wait on the disk. Scenes without a manifest are
+ * loaded the old way.
+ *
+ * Scripts are not recorded, the scene format has no script component to find them in.
+ */
+
+#ifndef YE_MANIFEST_H
+#define YE_MANIFEST_H
+
+#include <stdbool.h>
+#include <yoyoengine/yoyoengine.h>
+
+#define YE_MANIFEST_VERSION 1
+
+/**
+ * @brief Builds the asset manifest for a scene file.
+ *
+ * @param scene_file The root of a scene file (the object holding "styles" and "scene").
+ * @return json_t* A new manifest object (caller owns the reference), or NULL if the scene is invalid.
+ */
+json_t * ye_build_scene_manifest(json_t *scene_file);
+
+/**
+ * @brief Reads and decodes everything in a manifest concurrently, caching the textures and sounds.
+ *
+ * Updates YE_STATE.runtime.scene_prefetch_bytes and scene_prefetch_rate.
+ *
+ * @param manifest A manifest as produced by @ref ye_build_scene_manifest.
+ * @return true The manifest was prefetched (individual files that failed will load lazily as usual).
+ * @return false The manifest is invalid or from an incompatible version.
+ */
+bool ye_prefetch_scene_manifest(json_t *manifest);
+
+#endif
@@ -0,0 +1,85 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/yoyolick/yoyoengine)
+    Copyright (C) 2023  Ryan Zmuda
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file pack.h
+ * @brief Read only access to packed game resources (.yepk files).
+ *
+ * A pack is built ahead of time by tools/pack_assets.py (or the launcher build script) and
+ * holds every file under a game's resources folder as one aligned blob, plus an index of
+ * relative paths. At runtime the whole pack is memory mapped once, and resources are handed
+ * to SDL_image/SDL_ttf/SDL_mixer as SDL_RWops views straight into the mapping, so loading
+ * does not touch the filesystem per file.
+ *
+ * Anything that is not in the mounted pack is still loaded from loose files as usual.
+ *
+ * Layout (little endian):
+ * - header: "YEPK" | u32 version | u32 entry count | u32 alignment | u64 index offset | u64 index size
+ * - blobs: each starting on an alignment boundary
+ * - index: entry count * (u64 offset | u64 size | u32 path offset | u32 path length), then the path strings
+ */
+
+#ifndef YE_PACK_H
+#define YE_PACK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <yoyoengine/yoyoengine.h>
+
+#define YE_PACK_VERSION 1
+
+/**
+ * @brief Maps a pack into memory and indexes it, replacing any previously mounted pack.
+ *
+ * @param pack_path The path to the .yepk file.
+ * @return true The pack was mounted.
+ * @return false The file could not be mapped or is not a valid pack.
+ */
+bool ye_pack_mount(const char *pack_path);
+
+/**
+ * @brief Unmaps the current pack. Anything still reading from it (open fonts, etc) must be closed first.
+ */
+void ye_pack_unmount();
+
+/**
+ * @brief Returns true if the mounted pack holds a resource.
+ *
+ * @param path The path to the resource, either relative to the resources folder or as
+ * returned by ye_get_resource_static.
+ */
+bool ye_pack_contains(const char *path);
+
+/**
+ * @brief Returns a pointer to a resource inside the mapped pack.
+ *
+ * @param path The path to the resource (see @ref ye_pack_contains).
+ * @param size Set to the size of the resource in bytes.
+ * @return const void* The resource data, or NULL if it is not in the pack. Valid until the pack is unmounted.
+ */
+const void * ye_pack_data(const char *path, size_t *size);
+
+/**
+ * @brief Opens a read only SDL_RWops view of a resource inside the pack.
+ *
+ * @param path The path to the resource (see @ref ye_pack_contains).
+ * @return SDL_RWops* The view (close it, or pass freesrc to the SDL loader), or NULL if it is not in the pack.
+ */
+SDL_RWops * ye_pack_open(const char *path);
+
+#endif
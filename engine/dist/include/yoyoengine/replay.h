@@ -0,0 +1,101 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/yoyolick/yoyoengine)
+    Copyright (C) 2023  Ryan Zmuda
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file replay.h
+ * @brief Records the input event stream and frame deltas so a session can be replayed exactly.
+ *
+ * While recording, every SDL_Event consumed by @ref ye_process_frame and the delta time of every
+ * frame are written to a file. Playing that file back feeds the same events and deltas into the
+ * same frames, so physics and scripts step through identical state. Playback can optionally skip
+ * rendering (headless), which is also handy as a repeatable load for benchmarking.
+ *
+ * For a replay to line up, start recording and playback from the same state, for example
+ * right after loading the same scene. Anything driven by wall clock time (timers, animation
+ * frames) or unseeded randomness is not captured.
+ */
+
+#ifndef YE_REPLAY_H
+#define YE_REPLAY_H
+
+#include <stdbool.h>
+#include <yoyoengine/yoyoengine.h>
+
+/**
+ * @brief The current state of the replay system.
+ */
+enum ye_replay_mode {
+    YE_REPLAY_OFF,          ///< events come straight from SDL
+    YE_REPLAY_RECORDING,    ///< events come from SDL and are written to disk
+    YE_REPLAY_PLAYING       ///< events come from a recording
+};
+
+/**
+ * @brief Starts recording events and frame deltas to a file, starting with the next frame.
+ *
+ * @param path The path to write the recording to (overwritten if it exists).
+ * @return true The recording was started.
+ * @return false The file could not be opened or something is already recording/playing.
+ */
+bool ye_replay_start_recording(const char *path);
+
+/**
+ * @brief Starts playing back a recording, starting with the next frame.
+ *
+ * Real input is ignored during playback, except for SDL_QUIT so the window can still be closed.
+ * Playback stops by itself once the recording runs out.
+ *
+ * @param path The path of the recording to play.
+ * @param headless If true, frames are not rendered (or frame capped) while playing.
+ * @return true The playback was started.
+ * @return false The file could not be opened, is not a valid recording, or something is already recording/playing.
+ */
+bool ye_replay_start_playback(const char *path, bool headless);
+
+/**
+ * @brief Stops any recording or playback and closes the file.
+ */
+void ye_replay_stop();
+
+/**
+ * @brief Returns what the replay system is currently doing.
+ */
+enum ye_replay_mode ye_replay_get_mode();
+
+/**
+ * @brief Returns true if a headless playback is running and rendering should be skipped.
+ */
+bool ye_replay_is_headless();
+
+/**
+ * @brief Called by the engine at the start of every frame with the delta it computed.
+ *
+ * @param delta The delta time (seconds) the engine would use for this frame.
+ * @return float The delta time to actually use (the recorded one during playback).
+ */
+float ye_replay_begin_frame(float delta);
+
+/**
+ * @brief Drop in replacement for SDL_PollEvent used by the engine's frame loop.
+ *
+ * @param event Where to write the next event.
+ * @return int 1 if an event was written, 0 if there are no more events this frame.
+ */
+int ye_replay_poll_event(SDL_Event *event);
+
+#endif
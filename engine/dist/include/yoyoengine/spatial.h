@@ -0,0 +1,133 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/yoyolick/yoyoengine)
+    Copyright (C) 2023  Ryan Zmuda
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file spatial.h
+ * @brief Spatial queries (raycast, point, rect) over collider and renderer bounds.
+ *
+ * The engine keeps a uniform hash grid over the world bounds of every active collider
+ * and renderer. The grid is rebuilt lazily the first time it is queried after it has been
+ * invalidated (once per frame, and whenever a collider or renderer is added or removed),
+ * so a frame that never queries never pays for it.
+ *
+ * Queries write into a caller owned array and never allocate. Internal scratch buffers
+ * only grow when the number of tracked bounds grows.
+ */
+
+#ifndef YE_SPATIAL_H
+#define YE_SPATIAL_H
+
+#include <yoyoengine/yoyoengine.h>
+
+/*
+    Size (in world units) of a single grid cell. Should be roughly the size
+    of a typical collider or sprite in your game.
+*/
+#ifndef YE_SPATIAL_CELL_SIZE
+    #define YE_SPATIAL_CELL_SIZE 256.0f
+#endif
+
+/*
+    Bounds covering more cells than this are kept in a separate list
+    that every query checks, instead of being inserted into every cell.
+*/
+#ifndef YE_SPATIAL_MAX_CELLS_PER_ITEM
+    #define YE_SPATIAL_MAX_CELLS_PER_ITEM 64
+#endif
+
+/**
+ * @brief Flags selecting which component bounds a query should consider.
+ */
+enum ye_spatial_mask {
+    YE_SPATIAL_COLLIDERS = 1 << 0,                                  ///< collider rects (static and trigger)
+    YE_SPATIAL_RENDERERS = 1 << 1,                                  ///< renderer rects
+    YE_SPATIAL_ALL = YE_SPATIAL_COLLIDERS | YE_SPATIAL_RENDERERS    ///< everything
+};
+
+/**
+ * @brief A single result of a spatial query.
+ */
+struct ye_spatial_hit {
+    struct ye_entity *entity;           ///< the entity that was hit
+    enum ye_component_type component;   ///< YE_COMPONENT_COLLIDER or YE_COMPONENT_RENDERER
+    struct ye_rectf bounds;             ///< world bounds of the component that was hit
+    float distance;                     ///< distance along the ray to the hit (0 for point and rect queries)
+    struct ye_vec2f point;              ///< world position of the ray entry point (query point for point queries)
+    struct ye_vec2f normal;             ///< surface normal at the ray entry point, zero if the ray started inside
+};
+
+/**
+ * @brief Casts a ray and returns everything it passes through, sorted nearest first.
+ *
+ * @param x The x origin of the ray.
+ * @param y The y origin of the ray.
+ * @param dir_x The x component of the ray direction (does not need to be normalized).
+ * @param dir_y The y component of the ray direction (does not need to be normalized).
+ * @param max_distance The maximum distance to travel, or <= 0 for no limit.
+ * @param mask Which components to test against (see @ref ye_spatial_mask).
+ * @param hits Caller owned array the results are written into.
+ * @param max_hits The capacity of hits.
+ * @return int The number of hits written.
+ */
+int ye_raycast(float x, float y, float dir_x, float dir_y, float max_distance, int mask, struct ye_spatial_hit *hits, int max_hits);
+
+/**
+ * @brief Returns everything whose bounds contain a point.
+ *
+ * Results are sorted topmost first (highest renderer z, then lowest entity id), which
+ * makes the first result the one a user would expect to click on.
+ *
+ * @param x The x position of the point in world space.
+ * @param y The y position of the point in world space.
+ * @param mask Which components to test against (see @ref ye_spatial_mask).
+ * @param hits Caller owned array the results are written into.
+ * @param max_hits The capacity of hits.
+ * @return int The number of hits written.
+ */
+int ye_query_point(float x, float y, int mask, struct ye_spatial_hit *hits, int max_hits);
+
+/**
+ * @brief Returns everything whose bounds overlap a rect, sorted the same way as @ref ye_query_point.
+ *
+ * @param rect The rect to test in world space.
+ * @param mask Which components to test against (see @ref ye_spatial_mask).
+ * @param hits Caller owned array the results are written into.
+ * @param max_hits The capacity of hits.
+ * @return int The number of hits written.
+ */
+int ye_query_rect(struct ye_rectf rect, int mask, struct ye_spatial_hit *hits, int max_hits);
+
+/**
+ * @brief Marks the spatial index as stale so the next query rebuilds it.
+ *
+ * The engine calls this every frame and whenever colliders or renderers are added or removed.
+ * Call it yourself if you move something and query again within the same frame.
+ */
+void ye_spatial_invalidate();
+
+/**
+ * @brief Initializes the spatial index.
+ */
+void ye_init_spatial();
+
+/**
+ * @brief Frees everything held by the spatial index.
+ */
+void ye_shutdown_spatial();
+
+#endif
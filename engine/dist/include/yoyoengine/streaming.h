@@ -0,0 +1,81 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/yoyolick/yoyoengine)
+    Copyright (C) 2023  Ryan Zmuda
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file streaming.h
+ * @brief Loads textures requested mid game in the background and uploads them a little at a time.
+ *
+ * Scene loads still cache everything up front, but an image renderer created or changed afterwards
+ * (ex: from a script, when a new area comes into view) would otherwise stall the frame while its
+ * texture is read, decoded and uploaded. With streaming on, the renderer shows `missing_texture`
+ * until its texture is ready: a background thread reads and decodes the file, and @ref ye_render_all
+ * uploads decoded pixels in bands of rows until the "texture_upload_budget_ms" setting is used up for
+ * that frame. Once the whole texture is uploaded it is cached, and every image renderer still waiting
+ * on that path is switched over to it (renderers that were sized from the placeholder take the real size).
+ *
+ * Enabled by the "stream_textures" setting (on by default).
+ */
+
+#ifndef YE_STREAMING_H
+#define YE_STREAMING_H
+
+#include <stdbool.h>
+#include <yoyoengine/yoyoengine.h>
+
+/*
+    Default time (ms) each frame may spend uploading streamed textures if settings.yoyo does not specify one
+*/
+#ifndef YE_DEFAULT_TEXTURE_UPLOAD_BUDGET_MS
+    #define YE_DEFAULT_TEXTURE_UPLOAD_BUDGET_MS 2.0f
+#endif
+
+/*
+    Number of rows uploaded at a time, so a single large texture can be spread across frames
+*/
+#ifndef YE_STREAM_UPLOAD_ROWS
+    #define YE_STREAM_UPLOAD_ROWS 64
+#endif
+
+/**
+ * @brief Same as @ref ye_image_acquire, but if the texture is not cached yet it is loaded in the background
+ * and `missing_texture` is returned until it is ready.
+ *
+ * The placeholder is not reference counted. When the real texture is uploaded, every image renderer still
+ * holding the placeholder for this path acquires it. Falls back to @ref ye_image_acquire if streaming is off.
+ *
+ * @param path The path to the texture.
+ * @return The cached texture, or `missing_texture` while it is streaming in.
+ */
+SDL_Texture * ye_image_acquire_streamed(const char *path);
+
+/**
+ * @brief Uploads decoded textures until this frame's upload budget is spent. Called by @ref ye_render_all.
+ */
+void ye_texture_stream_update();
+
+/**
+ * @brief Starts the texture loading thread.
+ */
+void ye_init_texture_streaming();
+
+/**
+ * @brief Stops the texture loading thread and drops anything that was not uploaded yet.
+ */
+void ye_shutdown_texture_streaming();
+
+#endif
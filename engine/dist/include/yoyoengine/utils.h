@@ -24,6 +24,10 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
 #include <SDL2/SDL.h>
 
 #include <yoyoengine/logging.h>
@@ -50,6 +54,36 @@ struct ye_rectf; // this forward declaration ignores a bunch of compiler warning
  */
 int ye_clamp(int value, int min, int max);
 
+/**
+ * @brief Normalizes a path: backslashes become slashes, repeated slashes and "." segments are
+ * dropped, and ".." segments are resolved where possible (ex: "res/./a/../b.png" becomes "res/b.png").
+ *
+ * @param path The path to normalize.
+ * @param out The buffer to write the normalized path into.
+ * @param out_size The size of out.
+ * @return true The path was normalized.
+ * @return false The path was NULL or did not fit in out.
+ */
+bool ye_normalize_path(const char *path, char *out, size_t out_size);
+
+/**
+ * @brief Fast non-cryptographic 64 bit hash of a block of memory.
+ *
+ * @param data The data to hash.
+ * @param size The size of data in bytes.
+ * @return uint64_t The hash, never 0.
+ */
+uint64_t ye_hash_bytes(const void *data, size_t size);
+
+/**
+ * @brief Reads an entire file into memory.
+ *
+ * @param path The path to the file.
+ * @param size Set to the size of the file in bytes.
+ * @return unsigned char* The contents (free them with free()), or NULL if the file could not be read or is empty.
+ */
+unsigned char * ye_read_file(const char *path, size_t *size);
+
 /**
  * @brief Aligns a rectangle within another rectangle (by modifying the passed values).
  * 
@@ -0,0 +1,75 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/yoyolick/yoyoengine)
+    Copyright (C) 2023  Ryan Zmuda
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file workers.h
+ * @brief A small pool of worker threads that engine systems can split work across.
+ *
+ * The pool runs one job at a time. A job is a range of indices that gets chopped into
+ * chunks, and the calling thread helps process chunks until the whole range is done, so
+ * @ref ye_parallel_for returns only once every chunk has run.
+ */
+
+#ifndef YE_WORKERS_H
+#define YE_WORKERS_H
+
+#include <stdbool.h>
+#include <yoyoengine/yoyoengine.h>
+
+/*
+    Upper bound on the number of worker threads we will spawn,
+    regardless of how many cores the machine reports
+*/
+#ifndef YE_MAX_WORKERS
+    #define YE_MAX_WORKERS 16
+#endif
+
+/**
+ * @brief A function run by the worker pool over the index range [start, end).
+ */
+typedef void (*ye_parallel_fn)(int start, int end, void *data);
+
+/**
+ * @brief Runs fn over [0, count) split into chunks of at most grain indices.
+ *
+ * Runs everything on the calling thread if the pool is not running, the range fits
+ * in a single chunk, or it is called from inside another parallel job.
+ *
+ * @param count The number of indices to process.
+ * @param grain The number of indices each chunk should hold (values < 1 are treated as 1).
+ * @param fn The function to run on each chunk.
+ * @param data User data passed through to fn.
+ */
+void ye_parallel_for(int count, int grain, ye_parallel_fn fn, void *data);
+
+/**
+ * @brief Returns the number of threads that work on a job, including the calling thread.
+ */
+int ye_worker_count();
+
+/**
+ * @brief Spawns the worker threads (one less than the number of cores, capped by YE_MAX_WORKERS).
+ */
+void ye_init_workers();
+
+/**
+ * @brief Stops and joins all worker threads.
+ */
+void ye_shutdown_workers();
+
+#endif
@@ -0,0 +1,107 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/yoyolick/yoyoengine)
+    Copyright (C) 2023  Ryan Zmuda
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file yetex.h
+ * @brief Pre-decoded texture format (.yetex) that skips image decoding at load time.
+ *
+ * tools/convert_textures.py (or the launcher build script with "predecode_textures")
+ * converts every image under a resources folder into RGBA pixels stored next to the
+ * original as "<image>.yetex" (ex: "background.png.yetex"), optionally LZ4 compressed.
+ *
+ * ye_create_image_texture checks for the .yetex of whatever image it is asked for (in the
+ * mounted pack first, then on disk) and uploads it with SDL_CreateTexture + SDL_UpdateTexture,
+ * never going through SDL_image or an intermediate surface. Uncompressed pixels inside a
+ * pack are uploaded straight out of the mapping.
+ *
+ * Layout (little endian):
+ * - header: "YETX" | u32 version | u32 width | u32 height | u32 compression | u32 flags | u64 payload size
+ * - payload: width * height RGBA pixels (4 bytes each, R first), raw or as a single LZ4 block
+ */
+
+#ifndef YE_YETEX_H
+#define YE_YETEX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <yoyoengine/yoyoengine.h>
+
+#define YE_YETEX_VERSION 1
+
+/*
+    Suffix appended to an image path to find its pre-decoded version
+*/
+#define YE_YETEX_EXTENSION ".yetex"
+
+/**
+ * @brief How the pixels of a .yetex are stored.
+ */
+enum ye_yetex_compression {
+    YE_YETEX_RAW = 0,   ///< plain RGBA pixels
+    YE_YETEX_LZ4 = 1    ///< RGBA pixels as a single LZ4 block
+};
+
+/**
+ * @brief Creates a texture from the contents of a .yetex file.
+ *
+ * @param data The file contents.
+ * @param size The size of data in bytes.
+ * @return SDL_Texture* The texture, or NULL if the data is not a valid .yetex (error is logged).
+ */
+SDL_Texture * ye_create_yetex_texture(const void *data, size_t size);
+
+/**
+ * @brief Decodes the contents of a .yetex file into an RGBA32 surface.
+ *
+ * Unlike @ref ye_create_yetex_texture this does not touch the renderer, so it is safe to call off the main thread.
+ *
+ * @param data The file contents.
+ * @param size The size of data in bytes.
+ * @return SDL_Surface* The surface (free it with SDL_FreeSurface), or NULL if the data is not a valid .yetex.
+ */
+SDL_Surface * ye_decode_yetex_surface(const void *data, size_t size);
+
+/**
+ * @brief Loads the pre-decoded version of an image if one exists.
+ *
+ * @param image_path The path to the original image (or to a .yetex directly).
+ * @return SDL_Texture* The texture, or NULL if there is no usable .yetex for this image.
+ */
+SDL_Texture * ye_load_yetex(const char *image_path);
+
+/**
+ * @brief Same as @ref ye_load_yetex, but decodes into a surface without touching the renderer (safe off the main thread).
+ *
+ * @param image_path The path to the original image (or to a .yetex directly).
+ * @return SDL_Surface* The surface, or NULL if there is no usable .yetex for this image.
+ */
+SDL_Surface * ye_load_yetex_surface(const char *image_path);
+
+/**
+ * @brief Decompresses a single LZ4 block.
+ *
+ * @param src The compressed block.
+ * @param src_size The size of the compressed block.
+ * @param dst The output buffer.
+ * @param dst_size The exact decompressed size.
+ * @return true The block decompressed to exactly dst_size bytes.
+ * @return false The block is malformed.
+ */
+bool ye_lz4_decompress(const unsigned char *src, size_t src_size, unsigned char *dst, size_t dst_size);
+
+#endif
@@ -36,6 +36,9 @@
 #include "graphics.h"
 #include "uthash/uthash.h"
 #include "cache.h"
+#include "pack.h"
+#include "yetex.h"
+#include "manifest.h"
 #include "ui.h"
 #include "ecs/ecs.h"
 #include "ecs/audiosource.h"
@@ -47,8 +50,13 @@
 #include "ecs/collider.h"
 #include "ecs/tag.h"
 #include "ecs/lua_script.h"
+#include "spatial.h"
 #include "utils.h"
 #include "timer.h"
+#include "workers.h"
+#include "replay.h"
+#include "hotreload.h"
+#include "streaming.h"
 #include "audio.h"
 #include "logging.h"
 #include "lua_api.h"
@@ -22,24 +22,109 @@
     - if game wants to auto assign a channel, they do it through a special function that gives them
       the channel int it was assigned to for tracking purposes (this probably wont happen because game has list of tracks
       it wants to play on already anyways and will interrupt itself)
-    - threading audio so it doesnt block the game
 */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
 
+#include <SDL2/SDL.h>
 #include <SDL_mixer.h>
 
 #include <yoyoengine/yoyoengine.h>
 
-// define the max number of audio channels
-#define MAX_CHANNELS 16
+/*
+    What each mixer channel is playing. The voice holds a reference to its cached chunk until the channel finishes.
+*/
+struct ye_voice {
+    Mix_Chunk *chunk;
+    int priority;
+    Uint32 started;     // SDL_GetTicks() when it started
+    unsigned int id;    // unique per play, 0 while the voice is idle
+    bool spatialized;   // volume and panning were overridden by ye_spatialize_channel
+    int base_volume;    // channel volume to put back once it stops being spatialized
+    int volume;         // last spatialized volume and panning, so unchanged ones are not reapplied
+    Uint8 left;
+    Uint8 right;
+};
+
+struct ye_voice *voices = NULL;
+int voice_count = 0;
+unsigned int next_voice_id = 1;
 
-// create array to hold audio chunks in memory
-Mix_Chunk *pChunks[MAX_CHANNELS] = { NULL };
+// set by the mixer when a channel finishes, the reference is dropped on the main thread
+SDL_atomic_t *finished_channels = NULL;
+
+// counted over the current frame, published by ye_audio_update
+int voices_requested = 0;
+int voices_played = 0;
+int voices_stolen = 0;
+int voices_dropped = 0;
 
 // counter for total chunks (used in debug)
 int totalChunks = 0;
 
+// the track streaming through Mix_Music, if any
+Mix_Music *current_music = NULL;
+
+/*
+    A sound being decoded in the background, and every play of it requested in the meantime
+*/
+struct ye_pending_play {
+    int channel;
+    int loops;
+    int priority;
+    struct ye_pending_play *next;
+};
+
+struct ye_sound_decode {
+    char *key;                          // cache key of the sound
+    Mix_Chunk *chunk;                   // filled in by the decode thread, NULL if it failed
+    char error[256];                    // why it failed, SDL errors are per thread so the decode thread copies it here
+    struct ye_pending_play *plays;      // only touched by the main thread
+    struct ye_sound_decode *next;
+    UT_hash_handle hh;
+};
+
+SDL_Thread *audio_decode_thread = NULL;
+SDL_mutex *audio_decode_mutex = NULL;               // guards the request and ready queues
+SDL_cond *audio_decode_cond = NULL;
+bool audio_decode_running = false;                  // guarded by audio_decode_mutex
+struct ye_sound_decode *audio_decode_requests = NULL;
+struct ye_sound_decode *audio_decode_ready = NULL;
+struct ye_sound_decode *audio_decode_pending = NULL;   // by key, only touched by the main thread
+struct ye_sound_decode *audio_decode_failed = NULL;    // keys that failed to decode, so preloads do not retry them every frame
+
+void ye_free_channel(int channel);
+
+int _ye_audio_decode_thread(void *data){
+    (void)data;
+
+    SDL_LockMutex(audio_decode_mutex);
+    while(true){
+        while(audio_decode_running && audio_decode_requests == NULL)
+            SDL_CondWait(audio_decode_cond, audio_decode_mutex);
+        if(!audio_decode_running)
+            break;
+
+        struct ye_sound_decode *decode = audio_decode_requests;
+        audio_decode_requests = decode->next;
+        SDL_UnlockMutex(audio_decode_mutex);
+
+        SDL_RWops *pack_rw = ye_pack_open(decode->key);
+        decode->chunk = pack_rw != NULL ? Mix_LoadWAV_RW(pack_rw, 1) : Mix_LoadWAV(decode->key);
+        if(decode->chunk == NULL)
+            snprintf(decode->error, sizeof(decode->error), "%s", Mix_GetError());
+
+        SDL_LockMutex(audio_decode_mutex);
+        decode->next = audio_decode_ready;
+        audio_decode_ready = decode;
+    }
+    SDL_UnlockMutex(audio_decode_mutex);
+    return 0;
+}
+
 void ye_audio_init(){
     // opens the mixer to the format specified
     if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0) 
@@ -47,70 +132,467 @@ void ye_audio_init(){
         ye_logf(error, "SDL_mixer could not initialize! SDL_mixer Error: %s\n", Mix_GetError());
     }
     // allocate our desired max channels to the mixer
-    Mix_AllocateChannels(MAX_CHANNELS);
+    voice_count = YE_STATE.engine.audio_channels > 0 ? YE_STATE.engine.audio_channels : YE_DEFAULT_AUDIO_CHANNELS;
+    voice_count = Mix_AllocateChannels(voice_count);
+    voices = calloc(voice_count, sizeof(struct ye_voice));
+    finished_channels = calloc(voice_count, sizeof(SDL_atomic_t));
+
+    // Free audio memory when channel finishes
+    Mix_ChannelFinished(ye_free_channel);
+
+    // sounds that are not cached yet are decoded off the main thread
+    audio_decode_mutex = SDL_CreateMutex();
+    audio_decode_cond = SDL_CreateCond();
+    audio_decode_running = true;
+    audio_decode_thread = SDL_CreateThread(_ye_audio_decode_thread, "ye_audio_decode", NULL);
+    if(audio_decode_thread == NULL){
+        ye_logf(warning, "Failed to start audio decode thread, sounds will decode on play: %s\n", SDL_GetError());
+    }
 
     // debug: acknowledge audio initialization
     ye_logf(info, "Audio initialized.\n");
 }
 
+/*
+    Called by the mixer (usually on the audio thread), so all it does is flag the channel
+*/
 void ye_free_channel(int channel) {
     // if the channel is invalid
-    if (channel < 0 || channel >= MAX_CHANNELS) {
-        ye_logf(error, "Invalid channel (%d) to free audio chunk.\n", channel);
+    if (channel < 0 || channel >= voice_count) {
         return; // pass
     }
 
-    // if there is something in the channel we want to free from
-    if (pChunks[channel] != NULL) {
-        // free the chunk indexed from our chunks at the channel specified
-        Mix_FreeChunk(pChunks[channel]);
-        
-        // set the channel the chunk resided in to NULL
-        pChunks[channel] = NULL;
+    SDL_AtomicSet(&finished_channels[channel], 1);
+}
+
+/*
+    Drops the reference held by every channel that finished since we last checked
+*/
+void _ye_collect_finished_channels(){
+    for(int i = 0; i < voice_count; i++){
+        if(SDL_AtomicSet(&finished_channels[i], 0) == 0 || voices[i].chunk == NULL)
+            continue;
+
+        ye_sound_release(voices[i].chunk);
+        voices[i].chunk = NULL;
+        voices[i].id = 0;
         totalChunks--;
+
+        // hand the channel back the way we found it
+        if(voices[i].spatialized){
+            Mix_SetPanning(i, 255, 255);
+            Mix_Volume(i, voices[i].base_volume);
+            voices[i].spatialized = false;
+        }
     }
 
     YE_STATE.runtime.audio_chunk_count = totalChunks;
 }
 
-void ye_play_sound(const char *pFilename, int chan, int loops) {
-    // open our filename into a chunk
-    Mix_Chunk *pSound = Mix_LoadWAV(pFilename);
-    
-    // if opening failed
-    if (pSound == NULL) {
-        ye_logf(error, "Error loading audio file: %s\n", Mix_GetError());
-        return; // alarm in console and pass
+/*
+    Picks the voice to give up for a new sound: the lowest priority one at or below it,
+    then the quietest, then the one that has been playing the longest. -1 if none qualify.
+*/
+int _ye_pick_voice_to_steal(int priority){
+    int victim = -1;
+    int victim_volume = 0;
+    for(int i = 0; i < voice_count; i++){
+        if(voices[i].chunk == NULL || voices[i].priority > priority)
+            continue;
+
+        int volume = Mix_Volume(i, -1) * voices[i].chunk->volume;
+        if(victim == -1
+            || voices[i].priority < voices[victim].priority
+            || (voices[i].priority == voices[victim].priority && volume < victim_volume)
+            || (voices[i].priority == voices[victim].priority && volume == victim_volume && SDL_TICKS_PASSED(voices[victim].started, voices[i].started))){
+            victim = i;
+            victim_volume = volume;
+        }
     }
-    
+    return victim;
+}
+
+/*
+    Plays a chunk we hold a reference to, handing that reference to the channel.
+    Returns the channel it is playing on, -1 if it was dropped.
+*/
+int _ye_play_chunk(Mix_Chunk *pSound, int chan, int loops, int priority){
+    // hold the mixer so a channel cant finish between playing and recording what it plays
+    Mix_LockAudio();
+
     // attempt to play the chunk on the channel,
     // returns which channel it was assigned to
     int channel = Mix_PlayChannel(chan, pSound, loops); 
+
+    // every voice is busy, make room if something less important is playing
+    if(channel == -1 && chan == -1){
+        int victim = _ye_pick_voice_to_steal(priority);
+        if(victim != -1){
+            Mix_HaltChannel(victim);
+            channel = Mix_PlayChannel(victim, pSound, loops);
+            if(channel != -1)
+                voices_stolen++;
+        }
+        else{
+            Mix_UnlockAudio();
+            voices_dropped++;
+            ye_sound_release(pSound);
+            return -1; // nothing we are allowed to interrupt, this one loses
+        }
+    }
+
+    // playing on a busy channel halts whatever was on it
+    _ye_collect_finished_channels();
     
     // if playing failed (assigned channel -1)
     if (channel == -1) {
+        Mix_UnlockAudio();
         ye_logf(error, "Error playing audio file: %s\n", Mix_GetError());
-        Mix_FreeChunk(pSound);
-        return; // alarm in console, free the allocated chunk and pass
+        voices_dropped++;
+        ye_sound_release(pSound);
+        return -1; // alarm in console, release the chunk and pass
     }
 
     // if the channel assigned was out of bounds
-    if(channel < 0 || channel >= MAX_CHANNELS){
+    if(channel < 0 || channel >= voice_count){
+        Mix_HaltChannel(channel);
+        Mix_UnlockAudio();
         ye_logf(error, "Error: channel index out of bounds\n");
-        Mix_FreeChunk(pSound);
-        return; // free the allocated chunk and pass
+        voices_dropped++;
+        ye_sound_release(pSound);
+        return -1; // release the chunk and pass
     }
 
-    // put our channel identifier into the chunks
-    pChunks[channel] = pSound;
+    // put our channel identifier into the voices
+    voices[channel].chunk = pSound;
+    voices[channel].priority = priority;
+    voices[channel].started = SDL_GetTicks();
+    voices[channel].id = next_voice_id++;
+    if(next_voice_id == 0)
+        next_voice_id = 1;
 
     // increment total chunks
     totalChunks++;
+    voices_played++;
 
-    // Free audio memory when channel finishes
-    Mix_ChannelFinished(ye_free_channel);
+    Mix_UnlockAudio();
 
     YE_STATE.runtime.audio_chunk_count = totalChunks;
+    return channel;
+}
+
+/*
+    Size of the encoded file, -1 if it does not exist
+*/
+long _ye_audio_file_size(const char *path){
+    size_t size = 0;
+    if(ye_pack_data(path, &size) != NULL)
+        return (long)size;
+
+    struct stat st;
+    if(stat(path, &st) != 0)
+        return -1;
+    return (long)st.st_size;
+}
+
+/*
+    The decode in flight for a key, starting one if this sound is not already decoding
+*/
+struct ye_sound_decode * _ye_request_decode(const char *key){
+    struct ye_sound_decode *decode = NULL;
+    HASH_FIND_STR(audio_decode_pending, key, decode);
+    if(decode != NULL)
+        return decode;
+
+    decode = calloc(1, sizeof(struct ye_sound_decode));
+    decode->key = strdup(key);
+    HASH_ADD_KEYPTR(hh, audio_decode_pending, decode->key, strlen(decode->key), decode);
+
+    SDL_LockMutex(audio_decode_mutex);
+    decode->next = audio_decode_requests;
+    audio_decode_requests = decode;
+    SDL_CondSignal(audio_decode_cond);
+    SDL_UnlockMutex(audio_decode_mutex);
+    return decode;
+}
+
+void ye_play_sound(const char *pFilename, int chan, int loops) {
+    ye_play_sound_priority(pFilename, chan, loops, YE_DEFAULT_SOUND_PRIORITY);
+}
+
+void ye_play_sound_priority(const char *pFilename, int chan, int loops, int priority) {
+    // let go of anything that finished so it can be evicted if we need room
+    _ye_collect_finished_channels();
+
+    voices_requested++;
+
+    if(chan < -1 || chan >= voice_count){
+        ye_logf(error, "Invalid channel (%d) to play %s on.\n", chan, pFilename);
+        voices_dropped++;
+        return;
+    }
+
+    char key[1024];
+    if(!ye_image_key(pFilename, key, sizeof(key))){
+        ye_logf(error, "Audio path too long: %s\n", pFilename);
+        return;
+    }
+
+    // decoded once and kept in the cache, this only reads from disk the first time
+    if(ye_sound_is_cached(key)){
+        Mix_Chunk *pSound = ye_sound_acquire(key);
+        if(pSound != NULL)
+            _ye_play_chunk(pSound, chan, loops, priority);
+        return;
+    }
+
+    long size = _ye_audio_file_size(key);
+    if(size < 0){
+        ye_logf(error, "Error loading audio file: %s does not exist\n", key);
+        return;
+    }
+
+    // still played as an effect, but long tracks take tens of MB decoded and belong in ye_play_music
+    if(size > YE_LARGE_SOUND_KB * 1024L)
+        ye_logf(warning, "%s is %ldKB, decoding it as a sound effect. Use ye_play_music to stream long tracks.\n", key, size / 1024);
+
+    // no decode thread, do it here
+    if(audio_decode_thread == NULL){
+        Mix_Chunk *pSound = ye_sound_acquire(key);
+        if(pSound != NULL)
+            _ye_play_chunk(pSound, chan, loops, priority);
+        return;
+    }
+
+    // queue the play behind the decode
+    struct ye_pending_play *play = malloc(sizeof(struct ye_pending_play));
+    play->channel = chan;
+    play->loops = loops;
+    play->priority = priority;
+
+    struct ye_sound_decode *decode = _ye_request_decode(key);
+
+    // keep them in the order they were asked for
+    play->next = NULL;
+    struct ye_pending_play **tail = &decode->plays;
+    while(*tail != NULL)
+        tail = &(*tail)->next;
+    *tail = play;
+}
+
+void _ye_mark_decode_failed(const char *key){
+    struct ye_sound_decode *failed = NULL;
+    HASH_FIND_STR(audio_decode_failed, key, failed);
+    if(failed != NULL)
+        return;
+
+    failed = calloc(1, sizeof(struct ye_sound_decode));
+    failed->key = strdup(key);
+    HASH_ADD_KEYPTR(hh, audio_decode_failed, failed->key, strlen(failed->key), failed);
+}
+
+void ye_preload_sound(const char *pFilename){
+    char key[1024];
+    if(!ye_image_key(pFilename, key, sizeof(key))){
+        ye_logf(error, "Audio path too long: %s\n", pFilename);
+        return;
+    }
+
+    if(ye_sound_is_cached(key))
+        return;
+
+    struct ye_sound_decode *failed = NULL;
+    HASH_FIND_STR(audio_decode_failed, key, failed);
+    if(failed != NULL)
+        return;
+
+    if(audio_decode_thread == NULL){
+        if(ye_sound(key) == NULL)
+            _ye_mark_decode_failed(key);
+        return;
+    }
+
+    _ye_request_decode(key);
+}
+
+int ye_play_cached_sound(const char *pFilename, int chan, int loops, int priority){
+    _ye_collect_finished_channels();
+
+    voices_requested++;
+
+    if(chan < -1 || chan >= voice_count){
+        ye_logf(error, "Invalid channel (%d) to play %s on.\n", chan, pFilename);
+        voices_dropped++;
+        return -1;
+    }
+
+    if(!ye_sound_is_cached(pFilename)){
+        voices_dropped++;
+        return -1;
+    }
+
+    Mix_Chunk *pSound = ye_sound_acquire(pFilename);
+    if(pSound == NULL){
+        voices_dropped++;
+        return -1;
+    }
+    return _ye_play_chunk(pSound, chan, loops, priority);
+}
+
+unsigned int ye_channel_voice_id(int channel){
+    if(channel < 0 || channel >= voice_count)
+        return 0;
+    return voices[channel].id;
+}
+
+void ye_spatialize_channel(int channel, int volume, Uint8 left, Uint8 right){
+    if(channel < 0 || channel >= voice_count || voices[channel].chunk == NULL)
+        return;
+
+    struct ye_voice *voice = &voices[channel];
+    if(voice->spatialized && voice->volume == volume && voice->left == left && voice->right == right)
+        return;
+
+    Mix_LockAudio();
+    if(!voice->spatialized){
+        voice->base_volume = Mix_Volume(channel, -1);
+        voice->spatialized = true;
+    }
+    voice->volume = volume;
+    voice->left = left;
+    voice->right = right;
+
+    // scaled by what the channel was set to, so the games volume setting still applies
+    Mix_Volume(channel, volume * voice->base_volume / MIX_MAX_VOLUME);
+    Mix_SetPanning(channel, left, right);
+    Mix_UnlockAudio();
+}
+
+void ye_stop_channel(int channel){
+    if(channel < 0 || channel >= voice_count)
+        return;
+
+    Mix_LockAudio();
+    Mix_HaltChannel(channel);
+    _ye_collect_finished_channels();
+    Mix_UnlockAudio();
+}
+
+void _ye_free_decode(struct ye_sound_decode *decode){
+    while(decode->plays != NULL){
+        struct ye_pending_play *next = decode->plays->next;
+        free(decode->plays);
+        decode->plays = next;
+    }
+    if(decode->chunk != NULL)
+        Mix_FreeChunk(decode->chunk);
+    free(decode->key);
+    free(decode);
+}
+
+void ye_audio_update(){
+    _ye_collect_finished_channels();
+
+    // publish last frame's voice stats and start counting this one
+    YE_STATE.runtime.audio_voices_requested = voices_requested;
+    YE_STATE.runtime.audio_voices_played = voices_played;
+    YE_STATE.runtime.audio_voices_stolen = voices_stolen;
+    YE_STATE.runtime.audio_voices_dropped = voices_dropped;
+    voices_requested = voices_played = voices_stolen = voices_dropped = 0;
+
+    if(audio_decode_thread == NULL)
+        return;
+
+    SDL_LockMutex(audio_decode_mutex);
+    struct ye_sound_decode *decode = audio_decode_ready;
+    audio_decode_ready = NULL;
+    SDL_UnlockMutex(audio_decode_mutex);
+
+    while(decode != NULL){
+        struct ye_sound_decode *next = decode->next;
+        HASH_DEL(audio_decode_pending, decode);
+
+        if(decode->chunk == NULL){
+            ye_logf(error, "Error loading audio file %s: %s\n", decode->key, decode->error);
+            _ye_mark_decode_failed(decode->key);
+        }
+        else{
+            // the cache owns it from here on
+            ye_cache_sound_preloaded(decode->key, decode->chunk);
+            decode->chunk = NULL;
+
+            for(struct ye_pending_play *play = decode->plays; play != NULL; play = play->next){
+                Mix_Chunk *pSound = ye_sound_acquire(decode->key);
+                if(pSound != NULL)
+                    _ye_play_chunk(pSound, play->channel, play->loops, play->priority);
+            }
+        }
+
+        _ye_free_decode(decode);
+        decode = next;
+    }
+}
+
+/*
+    MUSIC
+*/
+
+bool ye_play_music(const char *path, int loops, int fade_in_ms){
+    char key[1024];
+    if(!ye_image_key(path, key, sizeof(key))){
+        ye_logf(error, "Audio path too long: %s\n", path);
+        return false;
+    }
+
+    // Mix_Music reads as it plays, so it keeps this open (or reads straight out of the pack mapping)
+    SDL_RWops *pack_rw = ye_pack_open(key);
+    Mix_Music *music = pack_rw != NULL ? Mix_LoadMUS_RW(pack_rw, 1) : Mix_LoadMUS(key);
+    if(music == NULL){
+        ye_logf(error, "Error loading music %s: %s\n", key, Mix_GetError());
+        return false;
+    }
+
+    ye_stop_music(0);
+    current_music = music;
+
+    int result = fade_in_ms > 0 ? Mix_FadeInMusic(music, loops, fade_in_ms) : Mix_PlayMusic(music, loops);
+    if(result != 0){
+        ye_logf(error, "Error playing music %s: %s\n", key, Mix_GetError());
+        ye_stop_music(0);
+        return false;
+    }
+    return true;
+}
+
+void ye_stop_music(int fade_out_ms){
+    if(current_music == NULL)
+        return;
+
+    // fading out finishes on its own, the track is freed when the next one starts (or on shutdown)
+    if(fade_out_ms > 0 && Mix_PlayingMusic()){
+        Mix_FadeOutMusic(fade_out_ms);
+        return;
+    }
+
+    Mix_HaltMusic();
+    Mix_FreeMusic(current_music);
+    current_music = NULL;
+}
+
+void ye_pause_music(){
+    Mix_PauseMusic();
+}
+
+void ye_resume_music(){
+    Mix_ResumeMusic();
+}
+
+bool ye_music_playing(){
+    return current_music != NULL && Mix_PlayingMusic();
+}
+
+void ye_set_music_volume(int volume){
+    Mix_VolumeMusic(volume);
 }
 
 void ye_set_volume(int channel, int volume){
@@ -124,13 +606,47 @@ void ye_audio_shutdown(){
     ye_logf(debug, "Halted playing all channels.\n");
 
 
-    // Free all audio chunks in the chunks array
-    for (int i = 0; i < MAX_CHANNELS; i++) {
-        if (pChunks[i] != NULL) {
-            Mix_FreeChunk(pChunks[i]);
-            pChunks[i] = NULL;
-        }
+    // stop decoding, dropping plays that never started
+    if(audio_decode_thread != NULL){
+        SDL_LockMutex(audio_decode_mutex);
+        audio_decode_running = false;
+        SDL_CondSignal(audio_decode_cond);
+        SDL_UnlockMutex(audio_decode_mutex);
+        SDL_WaitThread(audio_decode_thread, NULL);
+        audio_decode_thread = NULL;
+    }
+    struct ye_sound_decode *decode, *tmp;
+    HASH_ITER(hh, audio_decode_pending, decode, tmp){
+        HASH_DEL(audio_decode_pending, decode);
+        _ye_free_decode(decode);
+    }
+    HASH_ITER(hh, audio_decode_failed, decode, tmp){
+        HASH_DEL(audio_decode_failed, decode);
+        _ye_free_decode(decode);
     }
+    audio_decode_requests = NULL;
+    audio_decode_ready = NULL;
+    if(audio_decode_cond != NULL){
+        SDL_DestroyCond(audio_decode_cond);
+        audio_decode_cond = NULL;
+    }
+    if(audio_decode_mutex != NULL){
+        SDL_DestroyMutex(audio_decode_mutex);
+        audio_decode_mutex = NULL;
+    }
+
+    // stop and free the music stream
+    ye_stop_music(0);
+
+    // release what the channels were playing, nothing holds a sound now so the whole cache can go
+    _ye_collect_finished_channels();
+    ye_clear_sound_cache();
+
+    free(voices);
+    free(finished_channels);
+    voices = NULL;
+    finished_channels = NULL;
+    voice_count = 0;
 
     // Close the audio mixer
     Mix_CloseAudio();
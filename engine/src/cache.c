@@ -25,6 +25,200 @@
 struct ye_texture_node * cached_textures_head;
 struct ye_font_node * cached_fonts_head;
 struct ye_color_node * cached_colors_head;
+struct ye_sound_node * cached_sounds_head;
+
+// same idea as the texture indices below
+struct ye_sound_node * cached_sounds_by_chunk;
+struct ye_sound_node * sound_lru_head;
+struct ye_sound_node * sound_lru_tail;
+
+/*
+    Second index over the cached textures keyed by texture pointer (so we can release by pointer),
+    and a doubly linked list of them ordered from most to least recently used.
+*/
+struct ye_texture_node * cached_textures_by_ptr;
+struct ye_texture_node * texture_lru_head;
+struct ye_texture_node * texture_lru_tail;
+
+/*
+    Third index keyed by the hash of the file each texture was decoded from, and the extra
+    paths that turned out to be byte-identical to an already cached texture.
+*/
+struct ye_texture_node * cached_textures_by_content;
+struct ye_texture_alias * cached_texture_aliases;
+
+// defined in graphics.c, shared by every path that failed to load so we must never destroy it
+extern SDL_Texture *missing_texture;
+
+bool _ye_path_under(const char *normalized, const char *root){
+    char normalized_root[1024];
+    if(root == NULL || !ye_normalize_path(root, normalized_root, sizeof(normalized_root)))
+        return false;
+
+    size_t length = strlen(normalized_root);
+    return strncmp(normalized, normalized_root, length) == 0 && normalized[length] == '/';
+}
+
+/*
+    Every path handed to the texture cache becomes one canonical key, so a path relative to
+    the resources folder, its "./" variants and the resolved path all find the same entry
+*/
+bool ye_image_key(const char *path, char *key, size_t size){
+    char normalized[1024];
+    if(!ye_normalize_path(path, normalized, sizeof(normalized)))
+        return false;
+
+    const char *root = YE_STATE.engine.game_resources_path;
+    bool absolute = normalized[0] == '/' || (normalized[0] != '\0' && normalized[1] == ':');
+    if(root == NULL || absolute || _ye_path_under(normalized, root) || _ye_path_under(normalized, YE_STATE.engine.engine_resources_path))
+        return snprintf(key, size, "%s", normalized) < (int)size;
+
+    // relative to the game resources, same as ye_get_resource_static
+    char joined[2048];
+    snprintf(joined, sizeof(joined), "%s/%s", root, normalized);
+    return ye_normalize_path(joined, key, size);
+}
+
+struct ye_texture_node * _ye_texture_find(const char *key){
+    struct ye_texture_node *node = NULL;
+    HASH_FIND_STR(cached_textures_head, key, node);
+    if(node != NULL)
+        return node;
+
+    struct ye_texture_alias *alias = NULL;
+    HASH_FIND_STR(cached_texture_aliases, key, alias);
+    return alias != NULL ? alias->node : NULL;
+}
+
+void _ye_texture_add_alias(struct ye_texture_node *node, const char *key){
+    struct ye_texture_alias *alias = malloc(sizeof(struct ye_texture_alias));
+    alias->path = strdup(key);
+    alias->node = node;
+    alias->next = node->aliases;
+    node->aliases = alias;
+    HASH_ADD_KEYPTR(hh, cached_texture_aliases, alias->path, strlen(alias->path), alias);
+}
+
+/*
+    The hash only finds candidates, make sure the file cached under path really has the same bytes
+*/
+bool _ye_texture_source_matches(const char *path, const struct ye_image_source *source){
+    struct ye_image_source cached;
+    if(!ye_image_source_open(path, &cached))
+        return false;
+
+    bool same = cached.size == source->size && memcmp(cached.data, source->data, source->size) == 0;
+    ye_image_source_close(&cached);
+    return same;
+}
+
+bool _ye_texture_files_match(const char *a, const char *b){
+    struct ye_image_source source;
+    if(!ye_image_source_open(b, &source))
+        return false;
+
+    bool same = _ye_texture_source_matches(a, &source);
+    ye_image_source_close(&source);
+    return same;
+}
+
+void _ye_texture_lru_unlink(struct ye_texture_node *node){
+    if(node->lru_prev != NULL) node->lru_prev->lru_next = node->lru_next;
+    else texture_lru_head = node->lru_next;
+    if(node->lru_next != NULL) node->lru_next->lru_prev = node->lru_prev;
+    else texture_lru_tail = node->lru_prev;
+    node->lru_prev = NULL;
+    node->lru_next = NULL;
+}
+
+void _ye_texture_lru_touch(struct ye_texture_node *node){
+    if(texture_lru_head == node)
+        return;
+    if(node->lru_prev != NULL || node->lru_next != NULL || texture_lru_tail == node)
+        _ye_texture_lru_unlink(node);
+
+    node->lru_next = texture_lru_head;
+    if(texture_lru_head != NULL) texture_lru_head->lru_prev = node;
+    texture_lru_head = node;
+    if(texture_lru_tail == NULL) texture_lru_tail = node;
+}
+
+size_t _ye_texture_bytes(SDL_Texture *texture){
+    if(texture == NULL || texture == missing_texture)
+        return 0;
+
+    Uint32 format;
+    int w, h;
+    if(SDL_QueryTexture(texture, &format, NULL, &w, &h) != 0)
+        return 0;
+
+    int bpp = SDL_BYTESPERPIXEL(format);
+    if(bpp == 0) bpp = 4; // compressed/fourcc formats, assume the worst case
+    return (size_t)w * (size_t)h * (size_t)bpp;
+}
+
+/*
+    Variants are copies of the texture, so they have to go whenever it changes
+*/
+void _ye_texture_drop_variants(struct ye_texture_node *node){
+    for(int i = 0; i < node->variant_count; i++){
+        size_t bytes = _ye_texture_bytes(node->variants[i]);
+        node->bytes -= bytes;
+        YE_STATE.runtime.texture_cache_bytes -= bytes;
+        SDL_DestroyTexture(node->variants[i]);
+    }
+    node->variant_count = 0;
+    node->variants_wanted = 0;
+}
+
+/*
+    Remove a single node from every index and free it (and its texture)
+*/
+void _ye_texture_node_destroy(struct ye_texture_node *node){
+    _ye_texture_drop_variants(node);
+    HASH_DELETE(hh, cached_textures_head, node);
+    if(node->texture != missing_texture){
+        HASH_DELETE(hh_texture, cached_textures_by_ptr, node);
+        SDL_DestroyTexture(node->texture);
+    }
+    if(node->content_hash != 0)
+        HASH_DELETE(hh_content, cached_textures_by_content, node);
+    while(node->aliases != NULL){
+        struct ye_texture_alias *next = node->aliases->next;
+        HASH_DEL(cached_texture_aliases, node->aliases);
+        free(node->aliases->path);
+        free(node->aliases);
+        node->aliases = next;
+    }
+    _ye_texture_lru_unlink(node);
+
+    YE_STATE.runtime.texture_cache_bytes -= node->bytes;
+    YE_STATE.runtime.texture_cache_count--;
+
+    free(node->path);
+    free(node);
+}
+
+/*
+    Evict least recently used, unreferenced textures until we fit in the budget.
+    keep is never evicted (its the texture we are about to hand out).
+*/
+void _ye_texture_enforce_budget(struct ye_texture_node *keep){
+    size_t budget = (size_t)YE_STATE.engine.texture_cache_budget_mb * 1024 * 1024;
+    if(budget == 0)
+        return;
+
+    struct ye_texture_node *node = texture_lru_tail;
+    while(node != NULL && YE_STATE.runtime.texture_cache_bytes > budget){
+        struct ye_texture_node *prev = node->lru_prev;
+        if(node != keep && node->refcount <= 0 && node->bytes > 0){
+            // ye_logf(debug,"Evicting texture: %s\n",node->path);
+            _ye_texture_node_destroy(node);
+            YE_STATE.runtime.texture_cache_evictions++;
+        }
+        node = prev;
+    }
+}
 
 /*
     TODO: properly error check and validate every field
@@ -202,18 +396,36 @@ void ye_pre_cache_styles(const char *styles_path){
 
 void ye_init_cache(){
     cached_textures_head = NULL;
+    cached_textures_by_ptr = NULL;
+    cached_textures_by_content = NULL;
+    cached_texture_aliases = NULL;
+    texture_lru_head = NULL;
+    texture_lru_tail = NULL;
     cached_fonts_head = NULL;
     cached_colors_head = NULL;
+    cached_sounds_head = NULL;
+    cached_sounds_by_chunk = NULL;
+    sound_lru_head = NULL;
+    sound_lru_tail = NULL;
 }
 
 void ye_clear_texture_cache(){
     // free cached textures
     struct ye_texture_node *texture_node, *texture_tmp;
     HASH_ITER(hh, cached_textures_head, texture_node, texture_tmp) {
-        HASH_DEL(cached_textures_head, texture_node);
-        SDL_DestroyTexture(texture_node->texture);
-        free(texture_node->path);
-        free(texture_node);
+        _ye_texture_node_destroy(texture_node);
+    }
+}
+
+void _ye_sound_node_destroy(struct ye_sound_node *node);
+
+void ye_clear_sound_cache(){
+    struct ye_sound_node *sound_node, *sound_tmp;
+    HASH_ITER(hh, cached_sounds_head, sound_node, sound_tmp) {
+        // still playing, freeing it would pull the samples out from under the mixer
+        if(sound_node->refcount > 0)
+            continue;
+        _ye_sound_node_destroy(sound_node);
     }
 }
 
@@ -260,18 +472,178 @@ void ye_shutdown_cache(){
     This is the intended interface with the cache system, but assumes you have pre cached fonts and colors.
 */
 
-SDL_Texture * ye_image(const char *path){
+/*
+    Finds (or loads) the node for a path and marks it as most recently used
+*/
+struct ye_texture_node * _ye_image_node(const char *path){
+    char key[1024];
+    if(!ye_image_key(path, key, sizeof(key))){
+        ye_logf(error,"Texture path too long: %s\n",path);
+        return NULL;
+    }
+
     // check cache for texture named by path
-    struct ye_texture_node *node = cached_textures_head;
-    HASH_FIND_STR(cached_textures_head, path, node);
+    struct ye_texture_node *node = _ye_texture_find(key);
     if(node != NULL){
         // ye_logf(debug,"CACHE HIT: %s\n",path);
-        return node->texture;
+        YE_STATE.runtime.texture_cache_hits++;
+        _ye_texture_lru_touch(node);
+        return node;
     }
 
     // if not found, load texture and add to cache
     // ye_logf(warning,"CACHE MISS: %s\n",path);
-    return ye_cache_texture(path);
+    YE_STATE.runtime.texture_cache_misses++;
+    ye_cache_texture(key);
+    return _ye_texture_find(key);
+}
+
+SDL_Texture * ye_image(const char *path){
+    struct ye_texture_node *node = _ye_image_node(path);
+    return node != NULL ? node->texture : missing_texture;
+}
+
+bool ye_image_is_cached(const char *path){
+    char key[1024];
+    return ye_image_key(path, key, sizeof(key)) && _ye_texture_find(key) != NULL;
+}
+
+SDL_Texture * ye_image_acquire(const char *path){
+    struct ye_texture_node *node = _ye_image_node(path);
+    if(node == NULL)
+        return missing_texture;
+
+    node->refcount++;
+    return node->texture;
+}
+
+// set when a variant is asked for that does not exist yet
+bool texture_variants_requested = false;
+
+SDL_Texture * ye_image_variant(SDL_Texture *texture, int w, int h){
+    if(YE_TEXTURE_VARIANT_LEVELS <= 0 || texture == NULL || texture == missing_texture)
+        return texture;
+
+    int texture_w, texture_h;
+    if(SDL_QueryTexture(texture, NULL, NULL, &texture_w, &texture_h) != 0)
+        return texture;
+
+    // deepest level that is still at least as big as what is on screen
+    if(w < 1) w = 1;
+    if(h < 1) h = 1;
+    int level = 0;
+    while(level < YE_TEXTURE_VARIANT_LEVELS && (texture_w >> (level + 1)) >= w && (texture_h >> (level + 1)) >= h)
+        level++;
+    if(level == 0)
+        return texture;
+
+    struct ye_texture_node *node = NULL;
+    HASH_FIND(hh_texture, cached_textures_by_ptr, &texture, sizeof(SDL_Texture*), node);
+    if(node == NULL)
+        return texture;
+
+    if(level > node->variant_count && level > node->variants_wanted){
+        node->variants_wanted = level;
+        texture_variants_requested = true;
+    }
+
+    int available = level < node->variant_count ? level : node->variant_count;
+    return available > 0 ? node->variants[available - 1] : texture;
+}
+
+/*
+    Draws source into a new target texture half its size
+*/
+SDL_Texture * _ye_texture_halve(SDL_Renderer *renderer, SDL_Texture *source){
+    int w, h;
+    if(SDL_QueryTexture(source, NULL, NULL, &w, &h) != 0)
+        return NULL;
+    w = w / 2 > 0 ? w / 2 : 1;
+    h = h / 2 > 0 ? h / 2 : 1;
+
+    SDL_Texture *variant = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, w, h);
+    if(variant == NULL)
+        return NULL;
+
+    // copy the pixels (alpha included) straight across, filtered
+    SDL_BlendMode blend;
+    SDL_ScaleMode scale;
+    Uint8 alpha;
+    SDL_GetTextureBlendMode(source, &blend);
+    SDL_GetTextureScaleMode(source, &scale);
+    SDL_GetTextureAlphaMod(source, &alpha);
+    SDL_SetTextureBlendMode(source, SDL_BLENDMODE_NONE);
+    SDL_SetTextureScaleMode(source, SDL_ScaleModeLinear);
+    SDL_SetTextureAlphaMod(source, 255);
+
+    SDL_SetRenderTarget(renderer, variant);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    SDL_RenderClear(renderer);
+    SDL_RenderCopy(renderer, source, NULL, NULL);
+
+    SDL_SetTextureBlendMode(source, blend);
+    SDL_SetTextureScaleMode(source, scale);
+    SDL_SetTextureAlphaMod(source, alpha);
+
+    SDL_SetTextureBlendMode(variant, blend);
+    SDL_SetTextureScaleMode(variant, scale);
+    return variant;
+}
+
+void ye_generate_texture_variants(){
+    if(!texture_variants_requested)
+        return;
+    texture_variants_requested = false;
+
+    SDL_Renderer *renderer = YE_STATE.runtime.renderer;
+    if(!SDL_RenderTargetSupported(renderer))
+        return;
+
+    SDL_Texture *previous_target = SDL_GetRenderTarget(renderer);
+
+    struct ye_texture_node *node, *tmp;
+    HASH_ITER(hh, cached_textures_head, node, tmp){
+        // each level is made from the one above it, which is cheaper and looks better than one big step
+        while(node->variant_count < node->variants_wanted){
+            SDL_Texture *source = node->variant_count == 0 ? node->texture : node->variants[node->variant_count - 1];
+            SDL_Texture *variant = _ye_texture_halve(renderer, source);
+            if(variant == NULL){
+                ye_logf(warning, "Failed to generate texture variant for %s: %s\n", node->path, SDL_GetError());
+                node->variants_wanted = node->variant_count;
+                break;
+            }
+
+            size_t bytes = _ye_texture_bytes(variant);
+            node->bytes += bytes;
+            YE_STATE.runtime.texture_cache_bytes += bytes;
+            node->variants[node->variant_count++] = variant;
+        }
+    }
+
+    SDL_SetRenderTarget(renderer, previous_target);
+    _ye_texture_enforce_budget(NULL);
+}
+
+void ye_image_release(SDL_Texture *texture){
+    if(texture == NULL || texture == missing_texture)
+        return;
+
+    struct ye_texture_node *node = NULL;
+    HASH_FIND(hh_texture, cached_textures_by_ptr, &texture, sizeof(SDL_Texture*), node);
+    if(node == NULL){
+        // the cache was cleared (or the texture evicted) while someone still held it
+        return;
+    }
+
+    if(node->refcount <= 0){
+        ye_logf(warning,"Texture released more times than it was acquired: %s\n",node->path);
+        return;
+    }
+    node->refcount--;
+
+    // now that it might be unreferenced, it might be evictable
+    if(node->refcount == 0)
+        _ye_texture_enforce_budget(NULL);
 }
 
 TTF_Font * ye_font(const char *name, int size){
@@ -315,17 +687,215 @@ SDL_Color * ye_color(const char *name){
     This is used by the primary API but can also be used directly by the developer.
 */
 
+struct ye_texture_node * _ye_texture_node_create(const char *key, SDL_Texture *texture, uint64_t content_hash);
+
 SDL_Texture * ye_cache_texture(const char *path){
-    SDL_Texture *texture = ye_create_image_texture(path);
+    char key[1024];
+    if(!ye_image_key(path, key, sizeof(key))){
+        ye_logf(error,"Texture path too long: %s\n",path);
+        return missing_texture;
+    }
+
+    struct ye_image_source source;
+    if(!ye_image_source_open(key, &source)){
+        ye_logf(error, "Could not access file '%s'.\n", key);
+        return ye_cache_texture_preloaded(key, missing_texture, 0);
+    }
+
+    // dont bother decoding a file we already hold under another path
+    struct ye_texture_node *twin = NULL;
+    HASH_FIND(hh_content, cached_textures_by_content, &source.hash, sizeof(uint64_t), twin);
+    if(twin != NULL && !_ye_texture_source_matches(twin->path, &source))
+        twin = NULL;
+    SDL_Texture *texture = twin != NULL ? twin->texture : ye_image_source_texture(&source);
+    uint64_t content_hash = source.hash;
+    ye_image_source_close(&source);
+
+    if(texture == NULL)
+        return ye_cache_texture_preloaded(key, missing_texture, 0);
+    return ye_cache_texture_preloaded(key, texture, content_hash);
+}
+
+SDL_Texture * ye_cache_texture_preloaded(const char *path, SDL_Texture *texture, uint64_t content_hash){
+    char key[1024];
+    if(!ye_image_key(path, key, sizeof(key))){
+        ye_logf(error,"Texture path too long: %s\n",path);
+        if(texture != missing_texture)
+            SDL_DestroyTexture(texture);
+        return missing_texture;
+    }
+
+    // someone beat us to it, keep the one already handed out
+    struct ye_texture_node *existing = _ye_texture_find(key);
+    if(existing != NULL){
+        if(texture != existing->texture && texture != missing_texture)
+            SDL_DestroyTexture(texture);
+        _ye_texture_lru_touch(existing);
+        return existing->texture;
+    }
 
-    // cache the texture
+    // a byte-identical file is already cached under another path, share its texture
+    if(content_hash != 0 && texture != missing_texture){
+        HASH_FIND(hh_content, cached_textures_by_content, &content_hash, sizeof(uint64_t), existing);
+        if(existing != NULL && (texture == existing->texture || _ye_texture_files_match(existing->path, key))){
+            if(texture != existing->texture)
+                SDL_DestroyTexture(texture);
+            _ye_texture_add_alias(existing, key);
+            _ye_texture_lru_touch(existing);
+            YE_STATE.runtime.texture_cache_dedupes++;
+            return existing->texture;
+        }
+
+        // a hash collision, keep it out of the content index so it can never be mistaken for the other file
+        if(existing != NULL)
+            content_hash = 0;
+    }
+
+    _ye_texture_node_create(key, texture, content_hash);
+    return texture;
+}
+
+/*
+    Adds a new node to every index, taking ownership of texture
+*/
+struct ye_texture_node * _ye_texture_node_create(const char *key, SDL_Texture *texture, uint64_t content_hash){
     struct ye_texture_node *new_node = malloc(sizeof(struct ye_texture_node));
     new_node->texture = texture;
-    new_node->path = malloc(strlen(path) + 1);
-    strcpy(new_node->path, path);
+    new_node->path = strdup(key);
+    new_node->content_hash = texture != missing_texture ? content_hash : 0;
+    new_node->aliases = NULL;
+    new_node->variant_count = 0;
+    new_node->variants_wanted = 0;
+    new_node->bytes = _ye_texture_bytes(texture);
+    new_node->refcount = 0;
+    new_node->lru_prev = NULL;
+    new_node->lru_next = NULL;
     HASH_ADD_KEYPTR(hh, cached_textures_head, new_node->path, strlen(new_node->path), new_node);
-    // ye_logf(debug,"Cached texture: %s\n",path);
-    return texture;
+
+    // the missing texture is shared between every failed path, so it cant be looked up by pointer
+    if(texture != missing_texture)
+        HASH_ADD(hh_texture, cached_textures_by_ptr, texture, sizeof(SDL_Texture*), new_node);
+    if(new_node->content_hash != 0)
+        HASH_ADD(hh_content, cached_textures_by_content, content_hash, sizeof(uint64_t), new_node);
+    _ye_texture_lru_touch(new_node);
+
+    YE_STATE.runtime.texture_cache_bytes += new_node->bytes;
+    YE_STATE.runtime.texture_cache_count++;
+    _ye_texture_enforce_budget(new_node);
+
+    // ye_logf(debug,"Cached texture: %s\n",key);
+    return new_node;
+}
+
+/*
+    Takes key out of a node whose texture is shared by byte-identical files. If key is the nodes own
+    path, the node is renamed to one of its aliases (which keeps the texture and its other aliases).
+*/
+void _ye_texture_unshare(struct ye_texture_node *node, const char *key){
+    struct ye_texture_alias **link = &node->aliases;
+    if(strcmp(node->path, key) == 0){
+        // promote the first alias to own the node
+        struct ye_texture_alias *alias = node->aliases;
+        HASH_DEL(cached_texture_aliases, alias);
+        node->aliases = alias->next;
+
+        HASH_DELETE(hh, cached_textures_head, node);
+        free(node->path);
+        node->path = alias->path;
+        HASH_ADD_KEYPTR(hh, cached_textures_head, node->path, strlen(node->path), node);
+        free(alias);
+        return;
+    }
+
+    while(*link != NULL && strcmp((*link)->path, key) != 0)
+        link = &(*link)->next;
+    if(*link == NULL)
+        return;
+
+    struct ye_texture_alias *alias = *link;
+    *link = alias->next;
+    HASH_DEL(cached_texture_aliases, alias);
+    free(alias->path);
+    free(alias);
+}
+
+bool ye_cache_reload_texture(const char *path, SDL_Surface *surface){
+    char key[1024];
+    if(surface == NULL || !ye_image_key(path, key, sizeof(key)))
+        return false;
+
+    struct ye_texture_node *node = _ye_texture_find(key);
+    if(node == NULL)
+        return false;
+
+    /*
+        Other paths share this texture only because their files were identical, which this one no longer is.
+        Split it off into its own node with its own texture, and move whoever holds it through this path over.
+    */
+    if(node->aliases != NULL){
+        SDL_Texture *texture = SDL_CreateTextureFromSurface(YE_STATE.runtime.renderer, surface);
+        if(texture == NULL){
+            ye_logf(error,"Failed to recreate texture %s: %s\n", path, SDL_GetError());
+            return false;
+        }
+
+        _ye_texture_unshare(node, key);
+        struct ye_texture_node *split = _ye_texture_node_create(key, texture, 0);
+
+        int moved = ye_renderer_retarget_texture_path(key, node->texture, texture);
+        node->refcount -= moved < node->refcount ? moved : node->refcount;
+        split->refcount += moved;
+        return true;
+    }
+
+    // regenerated from the new pixels if they are still needed
+    _ye_texture_drop_variants(node);
+
+    // the contents no longer match the file it was hashed from
+    if(node->content_hash != 0){
+        HASH_DELETE(hh_content, cached_textures_by_content, node);
+        node->content_hash = 0;
+    }
+
+    // it failed to load last time, so holders only have the shared missing texture and cant be told apart.
+    // drop the node so the next lookup (ex: a renderer update or scene reload) loads the fixed file
+    if(node->texture == missing_texture){
+        _ye_texture_node_destroy(node);
+        return true;
+    }
+
+    // same size: overwrite the pixels of the existing texture, every holder sees it immediately
+    Uint32 format;
+    int access, w, h;
+    if(SDL_QueryTexture(node->texture, &format, &access, &w, &h) == 0 && w == surface->w && h == surface->h && access == SDL_TEXTUREACCESS_STATIC){
+        SDL_Surface *converted = SDL_ConvertSurfaceFormat(surface, format, 0);
+        if(converted != NULL){
+            int result = SDL_UpdateTexture(node->texture, NULL, converted->pixels, converted->pitch);
+            SDL_FreeSurface(converted);
+            if(result == 0)
+                return true;
+        }
+    }
+
+    // otherwise make a new texture and point everything holding the old one at it
+    SDL_Texture *texture = SDL_CreateTextureFromSurface(YE_STATE.runtime.renderer, surface);
+    if(texture == NULL){
+        ye_logf(error,"Failed to recreate texture %s: %s\n", path, SDL_GetError());
+        return false;
+    }
+
+    SDL_Texture *old_texture = node->texture;
+    HASH_DELETE(hh_texture, cached_textures_by_ptr, node);
+    node->texture = texture;
+    HASH_ADD(hh_texture, cached_textures_by_ptr, texture, sizeof(SDL_Texture*), node);
+
+    YE_STATE.runtime.texture_cache_bytes -= node->bytes;
+    node->bytes = _ye_texture_bytes(texture);
+    YE_STATE.runtime.texture_cache_bytes += node->bytes;
+
+    ye_renderer_retarget_texture(old_texture, texture);
+    SDL_DestroyTexture(old_texture);
+    return true;
 }
 
 TTF_Font * ye_cache_font(const char *name, /*int size,*/ const char *path){
@@ -351,4 +921,173 @@ SDL_Color * ye_cache_color(const char *name, SDL_Color color){
     HASH_ADD_KEYPTR(hh, cached_colors_head, new_node->name, strlen(new_node->name), new_node);
     // ye_logf(debug,"Cached color: %s\n",name);
     return &new_node->color;
-}
\ No newline at end of file
+}
+
+/*
+    SOUNDS
+*/
+
+void _ye_sound_lru_unlink(struct ye_sound_node *node){
+    if(node->lru_prev != NULL) node->lru_prev->lru_next = node->lru_next;
+    else sound_lru_head = node->lru_next;
+    if(node->lru_next != NULL) node->lru_next->lru_prev = node->lru_prev;
+    else sound_lru_tail = node->lru_prev;
+    node->lru_prev = NULL;
+    node->lru_next = NULL;
+}
+
+void _ye_sound_lru_touch(struct ye_sound_node *node){
+    if(sound_lru_head == node)
+        return;
+    if(node->lru_prev != NULL || node->lru_next != NULL || sound_lru_tail == node)
+        _ye_sound_lru_unlink(node);
+
+    node->lru_next = sound_lru_head;
+    if(sound_lru_head != NULL) sound_lru_head->lru_prev = node;
+    sound_lru_head = node;
+    if(sound_lru_tail == NULL) sound_lru_tail = node;
+}
+
+void _ye_sound_node_destroy(struct ye_sound_node *node){
+    HASH_DELETE(hh, cached_sounds_head, node);
+    HASH_DELETE(hh_chunk, cached_sounds_by_chunk, node);
+    _ye_sound_lru_unlink(node);
+
+    YE_STATE.runtime.sound_cache_bytes -= node->bytes;
+    YE_STATE.runtime.sound_cache_count--;
+
+    Mix_FreeChunk(node->chunk);
+    free(node->path);
+    free(node);
+}
+
+void _ye_sound_enforce_budget(struct ye_sound_node *keep){
+    size_t budget = (size_t)YE_STATE.engine.sound_cache_budget_mb * 1024 * 1024;
+    if(budget == 0)
+        return;
+
+    struct ye_sound_node *node = sound_lru_tail;
+    while(node != NULL && YE_STATE.runtime.sound_cache_bytes > budget){
+        struct ye_sound_node *prev = node->lru_prev;
+        if(node != keep && node->refcount <= 0){
+            _ye_sound_node_destroy(node);
+            YE_STATE.runtime.sound_cache_evictions++;
+        }
+        node = prev;
+    }
+}
+
+struct ye_sound_node * _ye_sound_node(const char *path){
+    // sounds are keyed the same way textures are
+    char key[1024];
+    if(!ye_image_key(path, key, sizeof(key))){
+        ye_logf(error,"Sound path too long: %s\n",path);
+        return NULL;
+    }
+
+    struct ye_sound_node *node = NULL;
+    HASH_FIND_STR(cached_sounds_head, key, node);
+    if(node != NULL){
+        YE_STATE.runtime.sound_cache_hits++;
+        _ye_sound_lru_touch(node);
+        return node;
+    }
+
+    YE_STATE.runtime.sound_cache_misses++;
+    if(ye_cache_sound(key) == NULL)
+        return NULL;
+    HASH_FIND_STR(cached_sounds_head, key, node);
+    return node;
+}
+
+Mix_Chunk * ye_sound(const char *path){
+    struct ye_sound_node *node = _ye_sound_node(path);
+    return node != NULL ? node->chunk : NULL;
+}
+
+bool ye_sound_is_cached(const char *path){
+    char key[1024];
+    struct ye_sound_node *node = NULL;
+    if(ye_image_key(path, key, sizeof(key)))
+        HASH_FIND_STR(cached_sounds_head, key, node);
+    return node != NULL;
+}
+
+Mix_Chunk * ye_sound_acquire(const char *path){
+    struct ye_sound_node *node = _ye_sound_node(path);
+    if(node == NULL)
+        return NULL;
+
+    node->refcount++;
+    return node->chunk;
+}
+
+void ye_sound_release(Mix_Chunk *chunk){
+    if(chunk == NULL)
+        return;
+
+    struct ye_sound_node *node = NULL;
+    HASH_FIND(hh_chunk, cached_sounds_by_chunk, &chunk, sizeof(Mix_Chunk*), node);
+    if(node == NULL)
+        return;
+
+    if(node->refcount <= 0){
+        ye_logf(warning,"Sound released more times than it was acquired: %s\n",node->path);
+        return;
+    }
+    node->refcount--;
+
+    if(node->refcount == 0)
+        _ye_sound_enforce_budget(NULL);
+}
+
+Mix_Chunk * ye_cache_sound(const char *path){
+    char key[1024];
+    if(!ye_image_key(path, key, sizeof(key))){
+        ye_logf(error,"Sound path too long: %s\n",path);
+        return NULL;
+    }
+
+    SDL_RWops *pack_rw = ye_pack_open(key);
+    Mix_Chunk *chunk = pack_rw != NULL ? Mix_LoadWAV_RW(pack_rw, 1) : Mix_LoadWAV(key);
+    if(chunk == NULL){
+        ye_logf(error, "Error loading audio file %s: %s\n", key, Mix_GetError());
+        return NULL;
+    }
+    return ye_cache_sound_preloaded(key, chunk);
+}
+
+Mix_Chunk * ye_cache_sound_preloaded(const char *path, Mix_Chunk *chunk){
+    char key[1024];
+    if(!ye_image_key(path, key, sizeof(key))){
+        ye_logf(error,"Sound path too long: %s\n",path);
+        Mix_FreeChunk(chunk);
+        return NULL;
+    }
+
+    struct ye_sound_node *existing = NULL;
+    HASH_FIND_STR(cached_sounds_head, key, existing);
+    if(existing != NULL){
+        if(chunk != existing->chunk)
+            Mix_FreeChunk(chunk);
+        _ye_sound_lru_touch(existing);
+        return existing->chunk;
+    }
+
+    struct ye_sound_node *node = malloc(sizeof(struct ye_sound_node));
+    node->chunk = chunk;
+    node->path = strdup(key);
+    node->bytes = chunk->alen;
+    node->refcount = 0;
+    node->lru_prev = NULL;
+    node->lru_next = NULL;
+    HASH_ADD_KEYPTR(hh, cached_sounds_head, node->path, strlen(node->path), node);
+    HASH_ADD(hh_chunk, cached_sounds_by_chunk, chunk, sizeof(Mix_Chunk*), node);
+    _ye_sound_lru_touch(node);
+
+    YE_STATE.runtime.sound_cache_bytes += node->bytes;
+    YE_STATE.runtime.sound_cache_count++;
+    _ye_sound_enforce_budget(node);
+
+    return chunk;
+}
@@ -16,4 +16,165 @@
     along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
-#include <yoyoengine/yoyoengine.h>
\ No newline at end of file
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <yoyoengine/yoyoengine.h>
+
+void ye_add_audiosource_component(struct ye_entity *entity, const char *pFilename, int loops){
+    struct ye_component_audiosource *audiosource = malloc(sizeof(struct ye_component_audiosource));
+    audiosource->active = true;
+    audiosource->playing = false;
+    audiosource->filename = strdup(pFilename);
+    audiosource->loops = loops;
+    audiosource->volume = MIX_MAX_VOLUME;
+    audiosource->priority = YE_DEFAULT_SOUND_PRIORITY;
+    audiosource->relative = true;
+    audiosource->rect = (struct ye_rectf){0, 0, 0, 0};
+    audiosource->range = YE_AUDIOSOURCE_DEFAULT_RANGE;
+    audiosource->channel = -1;
+    audiosource->voice_id = 0;
+    audiosource->audible = false;
+    audiosource->computed_volume = 0;
+    audiosource->computed_left = 255;
+    audiosource->computed_right = 255;
+    entity->audiosource = audiosource;
+    ye_entity_list_add(&audiosource_list_head, entity);
+
+    // get the decode out of the way before it is needed
+    ye_preload_sound(pFilename);
+}
+
+void ye_play_audiosource(struct ye_entity *entity){
+    if(entity->audiosource == NULL)
+        return;
+
+    // restart it if it is already going
+    ye_pause_audiosource(entity);
+    entity->audiosource->playing = true;
+}
+
+void ye_pause_audiosource(struct ye_entity *entity){
+    struct ye_component_audiosource *audiosource = entity->audiosource;
+    if(audiosource == NULL)
+        return;
+
+    if(audiosource->channel != -1 && ye_channel_voice_id(audiosource->channel) == audiosource->voice_id)
+        ye_stop_channel(audiosource->channel);
+    audiosource->channel = -1;
+    audiosource->playing = false;
+}
+
+void ye_remove_audiosource_component(struct ye_entity *entity){
+    ye_pause_audiosource(entity);
+    free(entity->audiosource->filename);
+    free(entity->audiosource);
+    entity->audiosource = NULL;
+    ye_entity_list_remove(&audiosource_list_head, entity);
+}
+
+void ye_system_audio(){
+    // the listener sits in the middle of whatever the target camera sees
+    struct ye_entity *camera = YE_STATE.engine.target_camera;
+    bool has_listener = camera != NULL && camera->camera != NULL && camera->camera->active;
+    float listener_x = 0.0f;
+    float listener_y = 0.0f;
+    float half_width = 1.0f;
+    if(has_listener){
+        struct ye_rectf view = ye_get_position(camera, YE_COMPONENT_CAMERA);
+        listener_x = view.x + view.w / 2.0f;
+        listener_y = view.y + view.h / 2.0f;
+        if(view.w > 0)
+            half_width = view.w / 2.0f;
+    }
+
+    /*
+        First pass: work out how every source should sound this frame.
+        Nothing here touches the mixer, so it stays a tight loop over the list.
+    */
+    for(struct ye_entity_node *current = audiosource_list_head; current != NULL; current = current->next){
+        struct ye_entity *entity = current->entity;
+        struct ye_component_audiosource *audiosource = entity->audiosource;
+
+        if(!entity->active || !audiosource->active || !audiosource->playing){
+            audiosource->audible = false;
+            continue;
+        }
+
+        if(!has_listener || audiosource->range <= 0){
+            audiosource->computed_volume = audiosource->volume;
+            audiosource->computed_left = 255;
+            audiosource->computed_right = 255;
+            audiosource->audible = audiosource->volume >= YE_AUDIOSOURCE_CULL_VOLUME;
+            continue;
+        }
+
+        struct ye_rectf pos = ye_get_position(entity, YE_COMPONENT_AUDIOSOURCE);
+        float dx = pos.x + pos.w / 2.0f - listener_x;
+        float dy = pos.y + pos.h / 2.0f - listener_y;
+
+        // linear falloff to silence at the edge of its range
+        float gain = 1.0f - sqrtf(dx * dx + dy * dy) / audiosource->range;
+        if(gain < 0.0f)
+            gain = 0.0f;
+        audiosource->computed_volume = (int)(audiosource->volume * gain + 0.5f);
+        audiosource->audible = audiosource->computed_volume >= YE_AUDIOSOURCE_CULL_VOLUME;
+
+        // fully to one side once it is off the edge of the screen
+        float pan = dx / half_width;
+        if(pan < -1.0f) pan = -1.0f;
+        if(pan > 1.0f) pan = 1.0f;
+        audiosource->computed_left = pan > 0.0f ? (Uint8)(255.0f * (1.0f - pan)) : 255;
+        audiosource->computed_right = pan < 0.0f ? (Uint8)(255.0f * (1.0f + pan)) : 255;
+    }
+
+    /*
+        Second pass: cull, start and update voices, holding the mixer once for all of them
+    */
+    Mix_LockAudio();
+    for(struct ye_entity_node *current = audiosource_list_head; current != NULL; current = current->next){
+        struct ye_entity *entity = current->entity;
+        struct ye_component_audiosource *audiosource = entity->audiosource;
+
+        // the sound finished or had its voice stolen, one shots are done either way
+        if(audiosource->channel != -1 && ye_channel_voice_id(audiosource->channel) != audiosource->voice_id){
+            audiosource->channel = -1;
+            if(audiosource->loops != -1)
+                audiosource->playing = false;
+        }
+
+        bool wanted = entity->active && audiosource->active && audiosource->playing;
+        if(!wanted || !audiosource->audible){
+            // give the voice back to someone who can be heard
+            if(audiosource->channel != -1){
+                ye_stop_channel(audiosource->channel);
+                audiosource->channel = -1;
+            }
+
+            // a one shot nobody was around to hear is just missed
+            if(wanted && audiosource->loops != -1)
+                audiosource->playing = false;
+            continue;
+        }
+
+        if(audiosource->channel == -1){
+            // wait for it to decode rather than stalling the frame
+            if(!ye_sound_is_cached(audiosource->filename)){
+                ye_preload_sound(audiosource->filename);
+                continue;
+            }
+
+            audiosource->channel = ye_play_cached_sound(audiosource->filename, -1, audiosource->loops, audiosource->priority);
+            if(audiosource->channel == -1){
+                if(audiosource->loops != -1)
+                    audiosource->playing = false;
+                continue;
+            }
+            audiosource->voice_id = ye_channel_voice_id(audiosource->channel);
+        }
+
+        ye_spatialize_channel(audiosource->channel, audiosource->computed_volume, audiosource->computed_left, audiosource->computed_right);
+    }
+    Mix_UnlockAudio();
+}
@@ -25,10 +25,12 @@ void ye_add_static_collider_component(struct ye_entity *entity, struct ye_rectf
     collider->is_trigger = false;
     entity->collider = collider;
     ye_entity_list_add(&collider_list_head, entity);
+    ye_spatial_invalidate();
 }
 
 void ye_remove_collider_component(struct ye_entity *entity){
     free(entity->collider);
     entity->collider = NULL;
     ye_entity_list_remove(&collider_list_head, entity);
+    ye_spatial_invalidate();
 }
\ No newline at end of file
@@ -115,6 +115,7 @@ struct ye_entity_node *physics_list_head;
 struct ye_entity_node *tag_list_head;
 struct ye_entity_node *collider_list_head;
 struct ye_entity_node *lua_script_list_head;
+struct ye_entity_node *audiosource_list_head;
 
 // struct ye_entity_node *interactible_list_head;
 
@@ -141,6 +142,7 @@ struct ye_entity * ye_create_entity(){
     entity->physics = NULL;
     entity->collider = NULL;
     entity->tag = NULL;
+    entity->audiosource = NULL;
 
     // add the entity to the entity list
     ye_entity_list_add(&entity_list_head, entity);
@@ -169,6 +171,7 @@ struct ye_entity * ye_create_entity_named(const char *name){
     entity->physics = NULL;
     entity->collider = NULL;
     entity->tag = NULL;
+    entity->audiosource = NULL;
 
     // add the entity to the entity list
     ye_entity_list_add(&entity_list_head, entity);
@@ -237,6 +240,14 @@ struct ye_entity * ye_duplicate_entity(struct ye_entity *entity){
             ye_add_static_collider_component(new_entity, entity->collider->rect);
         }
     }    
+    if(entity->audiosource != NULL){
+        ye_add_audiosource_component(new_entity, entity->audiosource->filename, entity->audiosource->loops);
+        new_entity->audiosource->volume = entity->audiosource->volume;
+        new_entity->audiosource->priority = entity->audiosource->priority;
+        new_entity->audiosource->relative = entity->audiosource->relative;
+        new_entity->audiosource->rect = entity->audiosource->rect;
+        new_entity->audiosource->range = entity->audiosource->range;
+    }
     if(entity->tag != NULL){
         ye_add_tag_component(new_entity);
         for(int i = 0; i < YE_TAG_MAX_NUMBER; i++){
@@ -258,6 +269,9 @@ void ye_destroy_entity(struct ye_entity * entity){
     // remove from the entity list (frees its node)
     ye_entity_list_remove(&entity_list_head, entity);
 
+    // scripts may still be holding on to it
+    ye_lua_forget_entity(entity);
+
     // check for non null components and free them
     if(entity->transform != NULL) ye_remove_transform_component(entity);
     if(entity->renderer != NULL) ye_remove_renderer_component(entity);
@@ -267,6 +281,7 @@ void ye_destroy_entity(struct ye_entity * entity){
     if(entity->lua_script != NULL) ye_remove_lua_script_component(entity);
     // if(entity->interactible != NULL) ye_remove_interactible_component(entity);
     if(entity->collider != NULL) ye_remove_collider_component(entity);
+    if(entity->audiosource != NULL) ye_remove_audiosource_component(entity);
     // free the entity name
     free(entity->name);
 
@@ -338,6 +353,7 @@ void ye_init_ecs(){
     physics_list_head = ye_entity_list_create();
     tag_list_head = ye_entity_list_create();
     collider_list_head = ye_entity_list_create();
+    audiosource_list_head = ye_entity_list_create();
     // lua_script_list_head = ye_entity_list_create();
     ye_logf(info, "Initialized ECS\n");
 }
@@ -376,6 +392,7 @@ void ye_shutdown_ecs(){
     ye_entity_list_destroy(&tag_list_head);
     ye_entity_list_destroy(&collider_list_head);
     ye_entity_list_destroy(&lua_script_list_head);
+    ye_entity_list_destroy(&audiosource_list_head);
 
     // take care of cleaning up any entity pointers that exist in global state
     YE_STATE.engine.target_camera = NULL;
@@ -392,7 +409,7 @@ void ye_print_entities(){
     int i = 0;
     while(current != NULL){
         char b[100];
-        snprintf(b, sizeof(b), "\"%s\" -> ID:%d Trn:%d Rdr:%d Cam:%d Int:%d Scr:%d Phy:%d Col:%d Tag:%d\n",
+        snprintf(b, sizeof(b), "\"%s\" -> ID:%d Trn:%d Rdr:%d Cam:%d Int:%d Scr:%d Phy:%d Col:%d Tag:%d Aud:%d\n",
             current->entity->name, current->entity->id, 
             current->entity->transform != NULL, 
             current->entity->renderer != NULL, 
@@ -401,7 +418,8 @@ void ye_print_entities(){
             current->entity->lua_script != NULL,
             current->entity->physics != NULL,
             current->entity->collider != NULL,
-            current->entity->tag != NULL
+            current->entity->tag != NULL,
+            current->entity->audiosource != NULL
         );
         ye_logf(debug, b);
         current = current->next;
@@ -16,85 +16,644 @@
     along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
 #include <yoyoengine/yoyoengine.h>
 
 // marcro for getting the state
 // #define ls_state entity->lua_script->state
 
+// the state every script runs in when they share one
+lua_State *lua_shared_state = NULL;
+
+// registry reference to the metatable given to every script environment ({__index = _G})
+int lua_env_metatable_ref = LUA_NOREF;
+
+// collection progress of the shared state
+struct ye_lua_gc lua_shared_gc = {0};
+
+/*
+    Sets the collector mode, and hands collection over to the engine if it has a budget for it
+*/
+void _ye_lua_configure_gc(lua_State *state){
+    if(YE_STATE.engine.lua_gc_generational)
+        lua_gc(state, LUA_GCGEN, 0, 0);
+    else
+        lua_gc(state, LUA_GCINC, 0, 0, 0);
+
+    if(YE_STATE.engine.lua_gc_budget_ms > 0)
+        lua_gc(state, LUA_GCSTOP);
+}
+
+/*
+    An error escaped every protected call, lua is about to abort
+*/
+int _ye_lua_panic(lua_State *state){
+    const char *message = lua_tostring(state, -1);
+    ye_logf(error,"Unprotected lua error: %s\n", message != NULL ? message : "(not a string)");
+    return 0;
+}
+
+/*
+    Creates a fresh state with the standard libraries and engine API, allocating from the lua pools
+*/
+lua_State * _ye_lua_new_state(){
+    lua_State *state = lua_newstate(ye_lua_alloc, NULL);
+    if(state == NULL){
+        ye_logf(error,"Failed to initialize lua state\n");
+        return NULL;
+    }
+    lua_atpanic(state, _ye_lua_panic);
+
+    // threads copy this from the main thread, only task threads should point at a task
+    *(void**)lua_getextraspace(state) = NULL;
+    _ye_lua_configure_gc(state);
+    luaL_openlibs(state);
+    // TODO: we also need to individually register each api function here
+    ye_register_lua_scripting_api(state);
+    return state;
+}
+
+/*
+    GARBAGE COLLECTION
+*/
+
+struct ye_lua_gc_target {
+    lua_State *state;
+    struct ye_lua_gc *gc;
+};
+
+// every state alive this frame, rebuilt each frame
+struct ye_lua_gc_target *lua_gc_targets = NULL;
+int lua_gc_target_capacity = 0;
+
+// which state gets the first step next frame, so one busy state cant starve the rest
+int lua_gc_cursor = 0;
+
+size_t ye_lua_state_memory(lua_State *state){
+    return (size_t)lua_gc(state, LUA_GCCOUNT) * 1024 + (size_t)lua_gc(state, LUA_GCCOUNTB);
+}
+
+int _ye_lua_gather_gc_targets(){
+    int count = 0;
+    int needed = lua_shared_state != NULL ? 1 : 0;
+    for(struct ye_entity_node *current = lua_script_list_head; current != NULL; current = current->next)
+        if(!current->entity->lua_script->shared_state)
+            needed++;
+
+    if(needed > lua_gc_target_capacity){
+        int capacity = lua_gc_target_capacity > 0 ? lua_gc_target_capacity : 16;
+        while(capacity < needed)
+            capacity *= 2;
+        struct ye_lua_gc_target *targets = realloc(lua_gc_targets, capacity * sizeof(struct ye_lua_gc_target));
+        if(targets == NULL)
+            return 0;
+        lua_gc_targets = targets;
+        lua_gc_target_capacity = capacity;
+    }
+
+    if(lua_shared_state != NULL)
+        lua_gc_targets[count++] = (struct ye_lua_gc_target){lua_shared_state, &lua_shared_gc};
+    for(struct ye_entity_node *current = lua_script_list_head; current != NULL; current = current->next){
+        struct ye_component_lua_script *script = current->entity->lua_script;
+        if(!script->shared_state)
+            lua_gc_targets[count++] = (struct ye_lua_gc_target){script->state, &script->gc};
+    }
+    return count;
+}
+
+void ye_lua_gc_step(){
+    int count = _ye_lua_gather_gc_targets();
+
+    // memory per state
+    size_t total = 0;
+    size_t largest = 0;
+    for(int i = 0; i < count; i++){
+        size_t memory = ye_lua_state_memory(lua_gc_targets[i].state);
+        total += memory;
+        if(memory > largest)
+            largest = memory;
+    }
+    YE_STATE.runtime.lua_state_count = count;
+    YE_STATE.runtime.lua_memory_bytes = total;
+    YE_STATE.runtime.lua_max_state_memory_bytes = largest;
+    YE_STATE.runtime.lua_gc_time = 0.0f;
+    ye_lua_alloc_publish_stats();
+
+    // lua is collecting on its own
+    if(YE_STATE.engine.lua_gc_budget_ms <= 0 || count == 0)
+        return;
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    Uint64 budget = (Uint64)(YE_STATE.engine.lua_gc_budget_ms * SDL_GetPerformanceFrequency() / 1000.0);
+
+    int collecting = 0;
+    for(int i = 0; i < count; i++){
+        struct ye_lua_gc_target *target = &lua_gc_targets[i];
+        size_t memory = ye_lua_state_memory(target->state);
+
+        // a state allocating faster than the budget lets us keep up with gets collected now
+        if(target->gc->baseline > 0 && memory * 100 > target->gc->baseline * YE_LUA_GC_EMERGENCY_PERCENT){
+            ye_logf(debug,"Lua state grew to %zuKB, running a full collection.\n", memory / 1024);
+            lua_gc(target->state, LUA_GCCOLLECT);
+            target->gc->baseline = ye_lua_state_memory(target->state);
+            target->gc->collecting = false;
+            continue;
+        }
+
+        if(!target->gc->collecting && memory * 100 >= target->gc->baseline * YE_LUA_GC_PAUSE_PERCENT)
+            target->gc->collecting = true;
+        if(target->gc->collecting)
+            collecting++;
+    }
+
+    int first = lua_gc_cursor++ % count;
+
+    /*
+        A generational step is a whole young collection and never reports a finished cycle (the collector
+        never returns to its pause state), so each state that is due gets exactly one per frame
+    */
+    if(YE_STATE.engine.lua_gc_generational){
+        for(int i = 0; i < count && SDL_GetPerformanceCounter() - start < budget; i++){
+            struct ye_lua_gc_target *target = &lua_gc_targets[(first + i) % count];
+            if(!target->gc->collecting)
+                continue;
+
+            lua_gc(target->state, LUA_GCSTEP, 0);
+            target->gc->baseline = ye_lua_state_memory(target->state);
+            target->gc->collecting = false;
+        }
+        YE_STATE.runtime.lua_gc_time = (SDL_GetPerformanceCounter() - start) * 1000.0f / SDL_GetPerformanceFrequency();
+        return;
+    }
+
+    // take turns stepping whoever is mid cycle until they finish or we run out of time
+    while(collecting > 0 && SDL_GetPerformanceCounter() - start < budget){
+        for(int i = 0; i < count && SDL_GetPerformanceCounter() - start < budget; i++){
+            struct ye_lua_gc_target *target = &lua_gc_targets[(first + i) % count];
+            if(!target->gc->collecting)
+                continue;
+
+            if(lua_gc(target->state, LUA_GCSTEP, YE_LUA_GC_STEP_KB)){
+                target->gc->baseline = ye_lua_state_memory(target->state);
+                target->gc->collecting = false;
+                collecting--;
+            }
+        }
+    }
+
+    YE_STATE.runtime.lua_gc_time = (SDL_GetPerformanceCounter() - start) * 1000.0f / SDL_GetPerformanceFrequency();
+}
+
+void ye_init_lua_scripting(){
+    if(!YE_STATE.engine.lua_shared_state){
+        ye_logf(info,"Lua scripts will each get their own state.\n");
+        return;
+    }
+
+    lua_shared_state = _ye_lua_new_state();
+    if(lua_shared_state == NULL){
+        ye_logf(warning,"Failed to create the shared lua state, scripts will each get their own.\n");
+        return;
+    }
+
+    // script environments read through to the shared globals
+    lua_newtable(lua_shared_state);
+    lua_rawgeti(lua_shared_state, LUA_REGISTRYINDEX, LUA_RIDX_GLOBALS);
+    lua_setfield(lua_shared_state, -2, "__index");
+    lua_env_metatable_ref = luaL_ref(lua_shared_state, LUA_REGISTRYINDEX);
+
+    lua_shared_gc = (struct ye_lua_gc){0};
+
+    ye_logf(info,"Initialized shared lua state.\n");
+}
+
+void ye_shutdown_lua_scripting(){
+    ye_clear_lua_bytecode_cache();
+
+    free(lua_gc_targets);
+    lua_gc_targets = NULL;
+    lua_gc_target_capacity = 0;
+
+    ye_lua_scheduler_shutdown();
+
+    if(lua_shared_state != NULL){
+        lua_close(lua_shared_state);
+        lua_shared_state = NULL;
+        lua_env_metatable_ref = LUA_NOREF;
+
+        ye_logf(info,"Shut down shared lua state.\n");
+    }
+
+    // every state is closed, nothing points into the pools anymore
+    ye_lua_alloc_shutdown();
+}
+
+void ye_lua_script_push_env(struct ye_component_lua_script *script){
+    if(script->shared_state)
+        lua_rawgeti(script->state, LUA_REGISTRYINDEX, script->env_ref);
+    else
+        lua_rawgeti(script->state, LUA_REGISTRYINDEX, LUA_RIDX_GLOBALS);
+}
+
+/*
+    BYTECODE CACHE
+
+    Every script file is compiled once, the dumped bytecode is what each entity using it loads.
+    It is recompiled if the file changes on disk, and with "lua_bytecode_cache_path" set the bytecode
+    is also written there (named by a hash of the path and one of the source) so the next run can skip
+    compiling entirely.
+*/
+
+struct ye_script_chunk {
+    char *key;                  // normalized path to the script
+    bool packed;                // came from the resource pack, so it can never change
+    time_t source_mtime;        // when the source we compiled was modified
+    off_t source_size;          // and how big it was, to notice edits without rereading it
+    uint64_t source_hash;
+    char *bytecode;
+    size_t bytecode_size;
+    UT_hash_handle hh;
+};
+
+struct ye_script_chunk *script_chunks = NULL;
+
+struct ye_bytecode_buffer {
+    char *data;
+    size_t size;
+    size_t capacity;
+};
+
+int _ye_lua_dump_writer(lua_State *L, const void *p, size_t size, void *ud){
+    (void)L;
+    struct ye_bytecode_buffer *buffer = ud;
+    if(buffer->size + size > buffer->capacity){
+        size_t capacity = buffer->capacity > 0 ? buffer->capacity : 4096;
+        while(capacity < buffer->size + size)
+            capacity *= 2;
+        char *data = realloc(buffer->data, capacity);
+        if(data == NULL)
+            return 1;
+        buffer->data = data;
+        buffer->capacity = capacity;
+    }
+    memcpy(buffer->data + buffer->size, p, size);
+    buffer->size += size;
+    return 0;
+}
+
+/*
+    Where the bytecode for a script is persisted, false if persisting is off. Keyed by path as well as
+    source hash, since the dump records the file it came from (for error messages and tracebacks).
+*/
+bool _ye_bytecode_cache_file(const char *key, uint64_t source_hash, char *out, size_t size){
+    if(YE_STATE.engine.lua_bytecode_cache_path == NULL || YE_STATE.engine.lua_bytecode_cache_path[0] == '\0')
+        return false;
+
+    // bytecode only loads in the lua version that dumped it
+    uint64_t path_hash = ye_hash_bytes(key, strlen(key));
+    int written = snprintf(out, size, "%s/%016" PRIx64 "-%016" PRIx64 "-%d.luac", YE_STATE.engine.lua_bytecode_cache_path, path_hash, source_hash, LUA_VERSION_NUM);
+    return written > 0 && (size_t)written < size;
+}
+
+/*
+    Cache files are the dumped bytecode preceded by a hash of it
+*/
+#define YE_BYTECODE_CHECKSUM_SIZE sizeof(uint64_t)
+
+void _ye_write_bytecode_cache(const char *cache_file, const struct ye_bytecode_buffer *bytecode){
+    // written next to it and renamed into place, so a crash or a second instance never leaves a partial file behind
+    char temp_file[1040];
+    snprintf(temp_file, sizeof(temp_file), "%s.tmp", cache_file);
+
+    uint64_t checksum = ye_hash_bytes(bytecode->data, bytecode->size);
+    FILE *file = fopen(temp_file, "wb");
+    bool written = file != NULL
+        && fwrite(&checksum, 1, sizeof(checksum), file) == sizeof(checksum)
+        && fwrite(bytecode->data, 1, bytecode->size, file) == bytecode->size;
+    if(file != NULL && fclose(file) != 0)
+        written = false;
+
+    if(written && rename(temp_file, cache_file) != 0){
+        // windows will not rename over an existing file
+        remove(cache_file);
+        written = rename(temp_file, cache_file) == 0;
+    }
+
+    if(!written){
+        ye_logf(warning,"Could not write bytecode cache file %s\n", cache_file);
+        remove(temp_file);
+    }
+}
+
+/*
+    Compiles (or reads back persisted bytecode for) a script source
+*/
+bool _ye_compile_script(lua_State *L, const char *chunkname, const unsigned char *source, size_t source_size, uint64_t source_hash, struct ye_bytecode_buffer *out){
+    char cache_file[1024];
+    bool persist = _ye_bytecode_cache_file(chunkname + 1, source_hash, cache_file, sizeof(cache_file));
+
+    if(persist){
+        size_t size = 0;
+        char *file = (char*)ye_read_file(cache_file, &size);
+
+        /*
+            Lua does not verify bytecode, a bad file can crash the VM rather than fail to load. The checksum
+            catches truncated or corrupted files, but the cache folder itself has to be trusted (only the
+            engine should ever write to it).
+        */
+        uint64_t checksum = 0;
+        if(file != NULL && size > YE_BYTECODE_CHECKSUM_SIZE)
+            memcpy(&checksum, file, YE_BYTECODE_CHECKSUM_SIZE);
+        char *bytecode = file != NULL ? file + YE_BYTECODE_CHECKSUM_SIZE : NULL;
+        size_t bytecode_size = size > YE_BYTECODE_CHECKSUM_SIZE ? size - YE_BYTECODE_CHECKSUM_SIZE : 0;
+
+        if(file != NULL && bytecode_size > 0 && checksum == ye_hash_bytes(bytecode, bytecode_size)){
+            if(luaL_loadbufferx(L, bytecode, bytecode_size, chunkname, "b") == LUA_OK){
+                lua_pop(L, 1);
+                memmove(file, bytecode, bytecode_size);
+                out->data = file;
+                out->size = out->capacity = bytecode_size;
+                return true;
+            }
+            ye_logf(warning,"Ignoring unloadable cached bytecode %s: %s\n", cache_file, lua_tostring(L, -1));
+            lua_pop(L, 1);
+        }
+        else if(file != NULL){
+            ye_logf(warning,"Ignoring corrupt cached bytecode %s\n", cache_file);
+        }
+        free(file);
+    }
+
+    if(luaL_loadbufferx(L, (const char*)source, source_size, chunkname, "t") != LUA_OK){
+        ye_logf(error,"Error compiling lua script: %s\n", lua_tostring(L, -1));
+        lua_pop(L, 1);
+        return false;
+    }
+
+    // keep debug info so errors still point at the right lines
+    int failed = lua_dump(L, _ye_lua_dump_writer, out, 0);
+    lua_pop(L, 1);
+    if(failed || out->size == 0){
+        ye_logf(error,"Failed to dump bytecode for %s\n", chunkname + 1);
+        free(out->data);
+        return false;
+    }
+
+    if(persist)
+        _ye_write_bytecode_cache(cache_file, out);
+    return true;
+}
+
+/*
+    The compiled chunk for a script, compiling it if it is not cached or changed on disk
+*/
+struct ye_script_chunk * _ye_script_chunk(lua_State *L, const char *path){
+    char key[1024];
+    if(!ye_normalize_path(path, key, sizeof(key))){
+        ye_logf(error,"Lua script path too long: %s\n", path);
+        return NULL;
+    }
+
+    struct ye_script_chunk *chunk = NULL;
+    HASH_FIND_STR(script_chunks, key, chunk);
+
+    // scripts in the resource pack are read straight out of the mapping
+    size_t source_size = 0;
+    const unsigned char *source = ye_pack_data(key, &source_size);
+    unsigned char *owned = NULL;
+    struct stat st = {0};
+    if(source != NULL){
+        if(chunk != NULL)
+            return chunk;
+    }
+    else{
+        if(stat(key, &st) != 0){
+            ye_logf(error,"Lua script %s does not exist\n", key);
+            return NULL;
+        }
+        if(chunk != NULL && !chunk->packed && chunk->source_mtime == st.st_mtime && chunk->source_size == st.st_size)
+            return chunk;
+
+        source = owned = ye_read_file(key, &source_size);
+        if(source == NULL){
+            ye_logf(error,"Could not read lua script %s\n", key);
+            return NULL;
+        }
+    }
+
+    uint64_t source_hash = ye_hash_bytes(source, source_size);
+
+    // touched but not actually changed
+    if(chunk != NULL && chunk->source_hash == source_hash){
+        chunk->source_mtime = st.st_mtime;
+        chunk->source_size = st.st_size;
+        free(owned);
+        return chunk;
+    }
+
+    char chunkname[1026];
+    snprintf(chunkname, sizeof(chunkname), "@%s", key);
+
+    bool packed = owned == NULL;
+    struct ye_bytecode_buffer bytecode = {0};
+    bool compiled = _ye_compile_script(L, chunkname, source, source_size, source_hash, &bytecode);
+    free(owned);
+    if(!compiled)
+        return NULL;
+
+    if(chunk == NULL){
+        chunk = calloc(1, sizeof(struct ye_script_chunk));
+        chunk->key = strdup(key);
+        HASH_ADD_KEYPTR(hh, script_chunks, chunk->key, strlen(chunk->key), chunk);
+    }
+    else{
+        ye_logf(debug,"Recompiled changed lua script %s\n", key);
+        free(chunk->bytecode);
+    }
+    chunk->packed = packed;
+    chunk->source_mtime = st.st_mtime;
+    chunk->source_size = st.st_size;
+    chunk->source_hash = source_hash;
+    chunk->bytecode = bytecode.data;
+    chunk->bytecode_size = bytecode.size;
+    return chunk;
+}
+
+void ye_clear_lua_bytecode_cache(){
+    struct ye_script_chunk *chunk, *tmp;
+    HASH_ITER(hh, script_chunks, chunk, tmp){
+        HASH_DEL(script_chunks, chunk);
+        free(chunk->bytecode);
+        free(chunk->key);
+        free(chunk);
+    }
+}
+
 /*
     Helper functions
 */
 
-bool _run_script(lua_State *state, char *path){
-    if (luaL_loadfile(state, path) || lua_pcall(state, 0, 0, 0)) {
+bool _run_script(struct ye_component_lua_script *script, char *path){
+    lua_State *state = script->state;
+
+    struct ye_script_chunk *chunk = _ye_script_chunk(state, path);
+    if(chunk == NULL)
+        return false;
+
+    char chunkname[1026];
+    snprintf(chunkname, sizeof(chunkname), "@%s", chunk->key);
+    uint32_t previous_owner = ye_lua_memory_owner_swap(script->memory_owner);
+    struct ye_component_lua_script *previous_script = lua_running_script;
+    lua_running_script = script;
+    if (luaL_loadbufferx(state, chunk->bytecode, chunk->bytecode_size, chunkname, "b")) {
+        ye_logf(error,"Error bootstrapping lua script: %s\n", lua_tostring(state, -1));
+        lua_pop(state, 1);
+        lua_running_script = previous_script;
+        ye_lua_memory_owner_swap(previous_owner);
+        return false;
+    }
+
+    // the chunks only upvalue is _ENV, point it at the scripts environment so its globals land there
+    if(script->shared_state){
+        ye_lua_script_push_env(script);
+        lua_setupvalue(state, -2, 1);
+    }
+
+    if (lua_pcall(state, 0, 0, 0)) {
         /*
             We have failed to load and run the script, log the error
             and then disable this script component and cleanup.
         */
         ye_logf(error,"Error bootstrapping lua script: %s\n", lua_tostring(state, -1));
+        lua_pop(state, 1);
+        lua_running_script = previous_script;
+        ye_lua_memory_owner_swap(previous_owner);
         return false;
     }
+    lua_running_script = previous_script;
+    ye_lua_memory_owner_swap(previous_owner);
     return true;
 }
 
-void _extract_signature(struct ye_component_lua_script *script, const char *funcName, bool *hasRef) {
+void _extract_signature(struct ye_component_lua_script *script, const char *funcName, int *ref) {
     lua_State *L = script->state;
 
-    lua_getglobal(L, funcName);
+    ye_lua_script_push_env(script);
+    lua_getfield(L, -1, funcName);
     if (lua_isfunction(L, -1)) {
         // ye_logf(debug,"Found function %s in script\n", funcName);
-        *hasRef = true;
+        *ref = luaL_ref(L, LUA_REGISTRYINDEX); // Pops the function
     } else {
         // ye_logf(debug,"Did not find function %s in script\n", funcName);
-        *hasRef = false;
+        *ref = LUA_NOREF;
+        lua_pop(L, 1); // Pop the nil value
+    }
+    lua_pop(L, 1); // Pop the environment from the stack
+}
+
+/*
+    Drops the scripts environment or closes its own state
+*/
+void _ye_release_script_state(struct ye_component_lua_script *script){
+    if(script->state == NULL)
+        return;
+
+    // before its state goes away, tasks hold references into it
+    ye_lua_cancel_script_tasks(script);
+
+    if(script->shared_state){
+        luaL_unref(script->state, LUA_REGISTRYINDEX, script->on_mount_ref);
+        luaL_unref(script->state, LUA_REGISTRYINDEX, script->on_update_ref);
+        luaL_unref(script->state, LUA_REGISTRYINDEX, script->on_unmount_ref);
+        luaL_unref(script->state, LUA_REGISTRYINDEX, script->env_ref);
     }
-    lua_pop(L, 1); // Pop the function or nil value from the stack
+    else{
+        lua_close(script->state);
+    }
+
+    // anything the script still has alive in the shared state keeps being tracked until it is collected
+    ye_lua_memory_owner_release(script->memory_owner);
+    script->memory_owner = 0;
+
+    script->state = NULL;
+    script->env_ref = LUA_NOREF;
 }
 
 bool ye_add_lua_script_component(struct ye_entity *entity, char *script_path){
     ye_logf(debug,"Adding lua script component to entity %s\n", entity->name);
     
     // allocate and assign the component
-    entity->lua_script = malloc(sizeof(struct ye_component_lua_script));
-    entity->lua_script->active = true;
+    struct ye_component_lua_script *script = malloc(sizeof(struct ye_component_lua_script));
+    script->active = true;
+    script->script_path = strdup(script_path);
+    script->env_ref = LUA_NOREF;
+    script->entity = entity;
+    script->gc = (struct ye_lua_gc){0};
+    script->on_mount_ref = LUA_NOREF;
+    script->on_update_ref = LUA_NOREF;
+    script->on_unmount_ref = LUA_NOREF;
+    script->tasks = NULL;
+    script->memory_owner = ye_lua_memory_owner_create((size_t)YE_STATE.engine.lua_script_memory_limit_kb * 1024);
+
+    // everything the script allocates from here on (including its own state) is charged to it
+    uint32_t previous_owner = ye_lua_memory_owner_swap(script->memory_owner);
     
     /*
-        Initialize state and load libs
+        Share the state if we can, giving the script its own environment table,
+        otherwise initialize a state and load libs just for it
     */
-    entity->lua_script->state = luaL_newstate();
-    luaL_openlibs(entity->lua_script->state);
-    // TODO: we also need to individually register each api function here
-    ye_register_lua_scripting_api(entity->lua_script->state);
+    if(lua_shared_state != NULL){
+        script->state = lua_shared_state;
+        script->shared_state = true;
+
+        lua_newtable(script->state);
+        lua_rawgeti(script->state, LUA_REGISTRYINDEX, lua_env_metatable_ref);
+        lua_setmetatable(script->state, -2);
+        script->env_ref = luaL_ref(script->state, LUA_REGISTRYINDEX);
+    }
+    else{
+        script->state = _ye_lua_new_state();
+        script->shared_state = false;
+    }
+    ye_lua_memory_owner_swap(previous_owner);
 
     // validate state and print errors
-    if(entity->lua_script->state == NULL){
-        ye_logf(error,"Failed to initialize lua state\n");
+    if(script->state == NULL){
+        ye_lua_memory_owner_release(script->memory_owner);
+        free(script->script_path);
+        free(script);
         return false;
     }
 
     /*
         Load our script into the lua state, which will inherently run it
     */
-    if(!_run_script(entity->lua_script->state, script_path)){
-        lua_close(entity->lua_script->state);
-        entity->lua_script->active = false;
+    if(!_run_script(script, script_path)){
+        _ye_release_script_state(script);
+        free(script->script_path);
+        free(script);
         return false;
     }
 
+    entity->lua_script = script;
+
     /*
         Look through the file and interpret what functions exist in this script
         ex: on_mount, on_update, on_trigger_enter, etc and assign struct fields
     */
-    _extract_signature(entity->lua_script, "on_mount", &(entity->lua_script->has_on_mount));
-    _extract_signature(entity->lua_script, "on_update", &(entity->lua_script->has_on_update));
-    _extract_signature(entity->lua_script, "on_unmount", &(entity->lua_script->has_on_unmount));
+    _extract_signature(entity->lua_script, "on_mount", &(entity->lua_script->on_mount_ref));
+    _extract_signature(entity->lua_script, "on_update", &(entity->lua_script->on_update_ref));
+    _extract_signature(entity->lua_script, "on_unmount", &(entity->lua_script->on_unmount_ref));
 
     /*
         call the lua scripts on_mount function in its state
     */
-    if(entity->lua_script->has_on_mount){
-        ye_run_lua_on_mount(entity->lua_script);
-    }
+    ye_run_lua_on_mount(entity->lua_script);
 
     // add to the lua_script list
     ye_entity_list_add(&lua_script_list_head, entity);
@@ -118,11 +677,11 @@ void ye_remove_lua_script_component(struct ye_entity *entity){
     // run the unmount function
     ye_run_lua_on_unmount(entity->lua_script);
 
-    // shut down the state
-    lua_close(entity->lua_script->state);
-    entity->lua_script->state = NULL;
+    // shut down the state (or just let go of the environment if shared)
+    _ye_release_script_state(entity->lua_script);
 
     // free the allocated memory
+    free(entity->lua_script->script_path);
     free(entity->lua_script);
     entity->lua_script = NULL;
 
@@ -130,6 +689,20 @@ void ye_remove_lua_script_component(struct ye_entity *entity){
     ye_entity_list_remove(&lua_script_list_head, entity);
 }
 
+void ye_set_lua_script_memory_limit(struct ye_entity *entity, size_t limit){
+    if(entity->lua_script == NULL){
+        ye_logf(warning,"Attempted to set the memory limit of a lua script on entity %s, which does not have one\n", entity->name);
+        return;
+    }
+    ye_lua_memory_owner_set_limit(entity->lua_script->memory_owner, limit);
+}
+
+size_t ye_lua_script_memory(struct ye_entity *entity){
+    if(entity->lua_script == NULL)
+        return 0;
+    return ye_lua_memory_owner_usage(entity->lua_script->memory_owner);
+}
+
 void ye_system_lua_scripting(){
     struct ye_entity_node *current = lua_script_list_head;
     while(current != NULL){
@@ -139,4 +712,4 @@ void ye_system_lua_scripting(){
         }
         current = current->next;
     }
-}
\ No newline at end of file
+}
@@ -16,6 +16,9 @@
     along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <stdlib.h>
+#include <math.h>
+
 #include <yoyoengine/yoyoengine.h>
 
 /*
@@ -33,6 +36,8 @@ void ye_add_physics_component(struct ye_entity *entity, float velocity_x, float
     entity->physics->velocity.x = velocity_x;
     entity->physics->velocity.y = velocity_y;
     entity->physics->rotational_velocity = 0; // directly modified by pointer because not often used
+    entity->physics->restitution = 0;
+    entity->physics->friction = 0;
     // entity->physics->acceleration.x = acceleration_x;
     // entity->physics->acceleration.y = acceleration_y;
 
@@ -65,6 +70,396 @@ bool ye_rectf_collision(struct ye_rectf rect1, struct ye_rectf rect2){
     return false;
 }
 
+/*
+    Per step scratch state for the physics system, kept as structure of arrays so the
+    hot loops run over contiguous floats and can be vectorized.
+
+    The components stay the source of truth: every step gathers what it needs out of the ECS
+    into these arrays in one pass, integrates and resolves entirely on the arrays, and scatters
+    the new transforms and rotations back in one pass at the end. Nothing here outlives a step.
+
+    Every physics entity gets a body, and every (moving solid body, collider it could hit)
+    combination found by the broadphase gets a pair. All arrays only ever grow. They are
+    static so their short names stay out of the engine's link namespace.
+*/
+static struct ye_entity **body_entity = NULL;
+static float *body_vx = NULL, *body_vy = NULL;                         // velocity, copied in from the component
+static float *body_dx = NULL, *body_dy = NULL;                         // how far the body wants to move this step
+static float *body_x = NULL, *body_y = NULL, *body_w = NULL, *body_h = NULL; // collider world position at the start of the step
+static float *body_tx = NULL, *body_ty = NULL;                         // transform position, advanced in place
+static float *body_rotation = NULL, *body_spin = NULL;                 // renderer rotation and rotational velocity
+static bool *body_solid = NULL;                                        // has an active, non trigger collider so it needs CCD
+static int *body_pair_start = NULL, *body_pair_count = NULL;
+static int physics_body_count = 0;
+static int physics_body_capacity = 0;
+
+/*
+    Pairs carry a copy of the body's start position and movement so the
+    narrowphase never has to gather through body indices.
+*/
+static int *pair_body = NULL;
+static float *pair_ax = NULL, *pair_ay = NULL, *pair_aw = NULL, *pair_ah = NULL;   // body at the start of the step
+static float *pair_dx = NULL, *pair_dy = NULL;                                     // body movement this step
+static float *pair_bx = NULL, *pair_by = NULL, *pair_bw = NULL, *pair_bh = NULL;   // the collider we might hit
+static bool *pair_trigger = NULL;                                                  // triggers never stop a body
+static int *pair_hit = NULL;                                                       // first substep overlapping, -1 if none
+static int physics_pair_count = 0;
+static int physics_pair_capacity = 0;
+
+static struct ye_spatial_hit *physics_query_hits = NULL;
+static int physics_query_capacity = 0;
+
+static float physics_step_delta = 0;
+
+bool _ye_physics_grow(void **buffer, int capacity, size_t element_size){
+    void *grown = realloc(*buffer, capacity * element_size);
+    if(grown == NULL){
+        ye_logf(error, "Failed to grow physics buffer to %d elements.\n", capacity);
+        return false;
+    }
+    *buffer = grown;
+    return true;
+}
+
+int _ye_physics_next_capacity(int capacity, int needed){
+    int new_capacity = capacity > 0 ? capacity : 64;
+    while(new_capacity < needed)
+        new_capacity *= 2;
+    return new_capacity;
+}
+
+bool _ye_physics_reserve_bodies(int needed){
+    if(needed <= physics_body_capacity)
+        return true;
+
+    int c = _ye_physics_next_capacity(physics_body_capacity, needed);
+    if(!_ye_physics_grow((void**)&body_entity, c, sizeof(struct ye_entity*)) ||
+       !_ye_physics_grow((void**)&body_vx, c, sizeof(float)) || !_ye_physics_grow((void**)&body_vy, c, sizeof(float)) ||
+       !_ye_physics_grow((void**)&body_dx, c, sizeof(float)) || !_ye_physics_grow((void**)&body_dy, c, sizeof(float)) ||
+       !_ye_physics_grow((void**)&body_x, c, sizeof(float)) || !_ye_physics_grow((void**)&body_y, c, sizeof(float)) ||
+       !_ye_physics_grow((void**)&body_w, c, sizeof(float)) || !_ye_physics_grow((void**)&body_h, c, sizeof(float)) ||
+       !_ye_physics_grow((void**)&body_tx, c, sizeof(float)) || !_ye_physics_grow((void**)&body_ty, c, sizeof(float)) ||
+       !_ye_physics_grow((void**)&body_rotation, c, sizeof(float)) || !_ye_physics_grow((void**)&body_spin, c, sizeof(float)) ||
+       !_ye_physics_grow((void**)&body_solid, c, sizeof(bool)) ||
+       !_ye_physics_grow((void**)&body_pair_start, c, sizeof(int)) || !_ye_physics_grow((void**)&body_pair_count, c, sizeof(int)))
+        return false;
+
+    physics_body_capacity = c;
+    return true;
+}
+
+bool _ye_physics_reserve_pairs(int needed){
+    if(needed <= physics_pair_capacity)
+        return true;
+
+    int c = _ye_physics_next_capacity(physics_pair_capacity, needed);
+    if(!_ye_physics_grow((void**)&pair_body, c, sizeof(int)) ||
+       !_ye_physics_grow((void**)&pair_ax, c, sizeof(float)) || !_ye_physics_grow((void**)&pair_ay, c, sizeof(float)) ||
+       !_ye_physics_grow((void**)&pair_aw, c, sizeof(float)) || !_ye_physics_grow((void**)&pair_ah, c, sizeof(float)) ||
+       !_ye_physics_grow((void**)&pair_dx, c, sizeof(float)) || !_ye_physics_grow((void**)&pair_dy, c, sizeof(float)) ||
+       !_ye_physics_grow((void**)&pair_bx, c, sizeof(float)) || !_ye_physics_grow((void**)&pair_by, c, sizeof(float)) ||
+       !_ye_physics_grow((void**)&pair_bw, c, sizeof(float)) || !_ye_physics_grow((void**)&pair_bh, c, sizeof(float)) ||
+       !_ye_physics_grow((void**)&pair_trigger, c, sizeof(bool)) || !_ye_physics_grow((void**)&pair_hit, c, sizeof(int)))
+        return false;
+
+    physics_pair_capacity = c;
+    return true;
+}
+
+/*
+    SIMD kernels
+
+    Picked at compile time: AVX if the compiler targets it, otherwise SSE2 (always there on x86_64),
+    otherwise plain C. Every kernel finishes its tail with the scalar code, so results are identical
+    on every path. Define YE_PHYSICS_NO_SIMD to force the scalar path.
+*/
+#if !defined(YE_PHYSICS_NO_SIMD) && defined(__AVX__)
+    #define YE_PHYSICS_AVX
+    #include <immintrin.h>
+#elif !defined(YE_PHYSICS_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+    #define YE_PHYSICS_SSE
+    #include <emmintrin.h>
+#endif
+
+/*
+    out[i] = in[i] * scale for i in [start, end)
+*/
+void _ye_physics_scale(float *out, const float *in, float scale, int start, int end){
+    int i = start;
+#if defined(YE_PHYSICS_AVX)
+    __m256 s8 = _mm256_set1_ps(scale);
+    for(; i + 8 <= end; i += 8)
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_loadu_ps(in + i), s8));
+#endif
+#if defined(YE_PHYSICS_AVX) || defined(YE_PHYSICS_SSE)
+    __m128 s4 = _mm_set1_ps(scale);
+    for(; i + 4 <= end; i += 4)
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_loadu_ps(in + i), s4));
+#endif
+    for(; i < end; i++)
+        out[i] = in[i] * scale;
+}
+
+/*
+    out[i] += in[i] * scale for i in [start, end)
+*/
+void _ye_physics_accumulate(float *out, const float *in, float scale, int start, int end){
+    int i = start;
+#if defined(YE_PHYSICS_AVX)
+    __m256 s8 = _mm256_set1_ps(scale);
+    for(; i + 8 <= end; i += 8)
+        _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_loadu_ps(out + i), _mm256_mul_ps(_mm256_loadu_ps(in + i), s8)));
+#endif
+#if defined(YE_PHYSICS_AVX) || defined(YE_PHYSICS_SSE)
+    __m128 s4 = _mm_set1_ps(scale);
+    for(; i + 4 <= end; i += 4)
+        _mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(out + i), _mm_mul_ps(_mm_loadu_ps(in + i), s4)));
+#endif
+    for(; i < end; i++)
+        out[i] += in[i] * scale;
+}
+
+/*
+    For every pair in [start, end), write the first substep at which the moving
+    body overlaps the other collider into pair_hit (or -1). Matches ye_rectf_collision.
+*/
+void _ye_physics_substep_test(int start, int end){
+    int i = start;
+#if defined(YE_PHYSICS_AVX)
+    for(; i + 8 <= end; i += 8){
+        __m256 ax = _mm256_loadu_ps(pair_ax + i), ay = _mm256_loadu_ps(pair_ay + i);
+        __m256 aw = _mm256_loadu_ps(pair_aw + i), ah = _mm256_loadu_ps(pair_ah + i);
+        __m256 dx = _mm256_loadu_ps(pair_dx + i), dy = _mm256_loadu_ps(pair_dy + i);
+        __m256 bx = _mm256_loadu_ps(pair_bx + i), by = _mm256_loadu_ps(pair_by + i);
+        __m256 bx2 = _mm256_add_ps(bx, _mm256_loadu_ps(pair_bw + i));
+        __m256 by2 = _mm256_add_ps(by, _mm256_loadu_ps(pair_bh + i));
+
+        for(int k = 0; k < 8; k++) pair_hit[i + k] = -1;
+        int found = 0;
+        for(int step = 0; step < YE_PHYSICS_SUBSTEPS && found != 0xFF; step++){
+            __m256 f = _mm256_set1_ps((step + 1) / (float)YE_PHYSICS_SUBSTEPS);
+            __m256 nx = _mm256_add_ps(ax, _mm256_mul_ps(f, dx));
+            __m256 ny = _mm256_add_ps(ay, _mm256_mul_ps(f, dy));
+            __m256 overlap = _mm256_and_ps(
+                _mm256_and_ps(_mm256_cmp_ps(nx, bx2, _CMP_LT_OQ), _mm256_cmp_ps(_mm256_add_ps(nx, aw), bx, _CMP_GT_OQ)),
+                _mm256_and_ps(_mm256_cmp_ps(ny, by2, _CMP_LT_OQ), _mm256_cmp_ps(_mm256_add_ps(ny, ah), by, _CMP_GT_OQ)));
+
+            int fresh = _mm256_movemask_ps(overlap) & ~found;
+            for(int k = 0; k < 8; k++)
+                if(fresh & (1 << k)) pair_hit[i + k] = step;
+            found |= fresh;
+        }
+    }
+#endif
+#if defined(YE_PHYSICS_AVX) || defined(YE_PHYSICS_SSE)
+    for(; i + 4 <= end; i += 4){
+        __m128 ax = _mm_loadu_ps(pair_ax + i), ay = _mm_loadu_ps(pair_ay + i);
+        __m128 aw = _mm_loadu_ps(pair_aw + i), ah = _mm_loadu_ps(pair_ah + i);
+        __m128 dx = _mm_loadu_ps(pair_dx + i), dy = _mm_loadu_ps(pair_dy + i);
+        __m128 bx = _mm_loadu_ps(pair_bx + i), by = _mm_loadu_ps(pair_by + i);
+        __m128 bx2 = _mm_add_ps(bx, _mm_loadu_ps(pair_bw + i));
+        __m128 by2 = _mm_add_ps(by, _mm_loadu_ps(pair_bh + i));
+
+        for(int k = 0; k < 4; k++) pair_hit[i + k] = -1;
+        int found = 0;
+        for(int step = 0; step < YE_PHYSICS_SUBSTEPS && found != 0xF; step++){
+            __m128 f = _mm_set1_ps((step + 1) / (float)YE_PHYSICS_SUBSTEPS);
+            __m128 nx = _mm_add_ps(ax, _mm_mul_ps(f, dx));
+            __m128 ny = _mm_add_ps(ay, _mm_mul_ps(f, dy));
+            __m128 overlap = _mm_and_ps(
+                _mm_and_ps(_mm_cmplt_ps(nx, bx2), _mm_cmpgt_ps(_mm_add_ps(nx, aw), bx)),
+                _mm_and_ps(_mm_cmplt_ps(ny, by2), _mm_cmpgt_ps(_mm_add_ps(ny, ah), by)));
+
+            int fresh = _mm_movemask_ps(overlap) & ~found;
+            for(int k = 0; k < 4; k++)
+                if(fresh & (1 << k)) pair_hit[i + k] = step;
+            found |= fresh;
+        }
+    }
+#endif
+    for(; i < end; i++){
+        pair_hit[i] = -1;
+        for(int step = 0; step < YE_PHYSICS_SUBSTEPS; step++){
+            float f = (step + 1) / (float)YE_PHYSICS_SUBSTEPS;
+            float nx = pair_ax[i] + f * pair_dx[i];
+            float ny = pair_ay[i] + f * pair_dy[i];
+            if(nx < pair_bx[i] + pair_bw[i] && nx + pair_aw[i] > pair_bx[i] &&
+               ny < pair_by[i] + pair_bh[i] && ny + pair_ah[i] > pair_by[i]){
+                pair_hit[i] = step;
+                break;
+            }
+        }
+    }
+}
+
+/*
+    Integration phase (parallel): work out where every body wants to go and spin it.
+    Only touches the flat arrays, in its own body slots.
+*/
+void _ye_physics_integrate(int start, int end, void *data){
+    (void)data;
+    _ye_physics_scale(body_dx, body_vx, physics_step_delta, start, end);
+    _ye_physics_scale(body_dy, body_vy, physics_step_delta, start, end);
+    _ye_physics_accumulate(body_rotation, body_spin, physics_step_delta, start, end);
+
+    for(int i = start; i < end; i++){
+        if(body_rotation[i] > 360) body_rotation[i] -= 360;
+        if(body_rotation[i] < 0) body_rotation[i] += 360;
+    }
+}
+
+/*
+    Advance phase (parallel): apply the movement resolve settled on to the transforms.
+*/
+void _ye_physics_advance(int start, int end, void *data){
+    (void)data;
+    _ye_physics_accumulate(body_tx, body_dx, 1.0f, start, end);
+    _ye_physics_accumulate(body_ty, body_dy, 1.0f, start, end);
+}
+
+/*
+    Narrowphase (parallel): record the first substep each pair overlaps.
+    Writes only to its own pair slots.
+*/
+void _ye_physics_narrowphase(int start, int end, void *data){
+    (void)data;
+    _ye_physics_substep_test(start, end);
+}
+
+/*
+    Broadphase (serial): find every collider each moving solid body could touch along its path,
+    using the spatial index over the positions at the start of the step.
+*/
+void _ye_physics_broadphase(){
+    physics_pair_count = 0;
+
+    for(int i = 0; i < physics_body_count; i++){
+        body_pair_start[i] = physics_pair_count;
+        if(!body_solid[i] || (body_dx[i] == 0 && body_dy[i] == 0))
+            continue;
+
+        struct ye_rectf swept = {body_x[i], body_y[i], body_w[i], body_h[i]};
+        if(body_dx[i] < 0) swept.x += body_dx[i];
+        if(body_dy[i] < 0) swept.y += body_dy[i];
+        swept.w += fabsf(body_dx[i]);
+        swept.h += fabsf(body_dy[i]);
+
+        // grow the hit buffer until the query fits in it
+        int hit_count;
+        while(true){
+            hit_count = ye_query_rect(swept, YE_SPATIAL_COLLIDERS, physics_query_hits, physics_query_capacity);
+            if(hit_count < physics_query_capacity)
+                break;
+            int c = _ye_physics_next_capacity(physics_query_capacity, physics_query_capacity + 1);
+            if(!_ye_physics_grow((void**)&physics_query_hits, c, sizeof(struct ye_spatial_hit)))
+                break;
+            physics_query_capacity = c;
+        }
+
+        if(!_ye_physics_reserve_pairs(physics_pair_count + hit_count))
+            return;
+
+        for(int h = 0; h < hit_count; h++){
+            if(physics_query_hits[h].entity == body_entity[i])
+                continue;
+
+            int p = physics_pair_count++;
+            struct ye_rectf other = physics_query_hits[h].bounds;
+            pair_body[p] = i;
+            pair_ax[p] = body_x[i];   pair_ay[p] = body_y[i];
+            pair_aw[p] = body_w[i];   pair_ah[p] = body_h[i];
+            pair_dx[p] = body_dx[i];  pair_dy[p] = body_dy[i];
+            pair_bx[p] = other.x;     pair_by[p] = other.y;
+            pair_bw[p] = other.w;     pair_bh[p] = other.h;
+            pair_trigger[p] = physics_query_hits[h].entity->collider->is_trigger;
+            pair_hit[p] = -1;
+        }
+        body_pair_count[i] = physics_pair_count - body_pair_start[i];
+    }
+}
+
+/*
+    Minimum translation needed to push a out of b, along whichever axis overlaps the least.
+    Zero if they do not overlap.
+*/
+struct ye_vec2f _ye_physics_separation(struct ye_rectf a, struct ye_rectf b){
+    if(!ye_rectf_collision(a, b))
+        return (struct ye_vec2f){0, 0};
+
+    float push_left = (a.x + a.w) - b.x;    // move a by -push_left to clear b on the left
+    float push_right = (b.x + b.w) - a.x;   // move a by +push_right to clear b on the right
+    float push_up = (a.y + a.h) - b.y;
+    float push_down = (b.y + b.h) - a.y;
+
+    float x = push_left < push_right ? -push_left : push_right;
+    float y = push_up < push_down ? -push_up : push_down;
+
+    if(fabsf(x) < fabsf(y))
+        return (struct ye_vec2f){x, 0};
+    return (struct ye_vec2f){0, y};
+}
+
+/*
+    Collision response for body i, whose earliest solid contact is pair contact.
+
+    1. move up to the last substep that was still free
+    2. take the contact normal from the minimum translation out of the collider at the hit substep
+    3. slide the rest of the movement along the surface (the part into it is dropped), scaled by friction
+    4. push out of anything we still overlap, once per contact
+    5. bounce the velocity along the normal by restitution and damp it along the surface by friction
+
+    Friction is applied as a per step factor raised to the step length (see YE_PHYSICS_FRICTION_RATE),
+    so a sliding body loses the same speed per second no matter how many steps that second is split into.
+
+    Returns how far the collider moved this step.
+*/
+struct ye_vec2f _ye_physics_respond(int i, int contact){
+    struct ye_component_physics *physics = body_entity[i]->physics;
+    float friction = fminf(fmaxf(physics->friction, 0), 1);
+    float keep = powf(1.0f - friction, physics_step_delta * YE_PHYSICS_FRICTION_RATE); // share of sliding speed left after this step
+    float restitution = fminf(fmaxf(physics->restitution, 0), 1);
+
+    float free = pair_hit[contact] / (float)YE_PHYSICS_SUBSTEPS;
+    float hit = (pair_hit[contact] + 1) / (float)YE_PHYSICS_SUBSTEPS;
+
+    struct ye_rectf position = {body_x[i] + body_dx[i] * free, body_y[i] + body_dy[i] * free, body_w[i], body_h[i]};
+    struct ye_rectf at_hit = {body_x[i] + body_dx[i] * hit, body_y[i] + body_dy[i] * hit, body_w[i], body_h[i]};
+    struct ye_rectf other = {pair_bx[contact], pair_by[contact], pair_bw[contact], pair_bh[contact]};
+
+    struct ye_vec2f mtv = _ye_physics_separation(at_hit, other);
+    bool normal_x = mtv.x != 0;
+
+    // slide whatever movement is left along the surface
+    float remaining = 1.0f - free;
+    if(normal_x)
+        position.y += body_dy[i] * remaining * keep;
+    else
+        position.x += body_dx[i] * remaining * keep;
+
+    // separate from every solid contact we ended up inside
+    for(int p = body_pair_start[i]; p < body_pair_start[i] + body_pair_count[i]; p++){
+        if(pair_trigger[p])
+            continue;
+        struct ye_vec2f push = _ye_physics_separation(position, (struct ye_rectf){pair_bx[p], pair_by[p], pair_bw[p], pair_bh[p]});
+        position.x += push.x;
+        position.y += push.y;
+    }
+
+    // only bounce if we were actually heading into the surface
+    if(normal_x){
+        if(body_vx[i] * mtv.x < 0)
+            body_vx[i] = -body_vx[i] * restitution;
+        body_vy[i] *= keep;
+    }
+    else{
+        if(body_vy[i] * mtv.y < 0)
+            body_vy[i] = -body_vy[i] * restitution;
+        body_vx[i] *= keep;
+    }
+
+    return (struct ye_vec2f){position.x - body_x[i], position.y - body_y[i]};
+}
+
 /*
     Physics system
 
@@ -77,6 +472,22 @@ bool ye_rectf_collision(struct ye_rectf rect1, struct ye_rectf rect2){
     thresholds, or if we are below a certain framerate. We could also expose a bool for CCD on the physics
     component to allow more fine grained control, as well as an integer for specifying the number of steps.
 
+    Per step state lives in flat float arrays (see above) rather than being read through
+    the component pointers, so integration, the substep AABB tests and the final position update
+    run 4 or 8 bodies at a time. The components are read once in gather and written once in scatter.
+
+    The step is split into phases so the heavy parts can run on the worker pool:
+    1. gather (serial): copy every active physics entity's state into the arrays, in list order
+    2. integrate (parallel): compute each body's movement and rotation
+    3. broadphase (serial): query the spatial index for colliders along each solid body's path
+    4. narrowphase (parallel): find the first substep each pair overlaps
+    5. resolve (serial, list order): respond to the earliest solid hit (separate and slide)
+    6. advance (parallel): add each body's final movement to its transform position
+    7. scatter (serial): write transforms, velocities and rotations back to the ECS
+
+    Every body is tested against where colliders were at the start of the step, and nothing is written
+    to the ECS until the scatter phase, so the result is the same no matter how many threads ran it.
+
     TODO/Considerations:
     - maybe we want to check for hitting multiple overlapping triggers?
     - trigger colliders are needed
@@ -84,116 +495,105 @@ bool ye_rectf_collision(struct ye_rectf rect1, struct ye_rectf rect2){
     Physics entities need a transform component to work, we apply these forces to the transform not the component position.
 */
 void ye_system_physics(){
-    // current time - left for debugging
-    // unsigned long start = SDL_GetTicks64();
+    physics_step_delta = ye_delta_time();
 
-    float delta = ye_delta_time();
-    // iterate over all entities with physics
+    // gather, copying everything the step works on out of the ECS
+    physics_body_count = 0;
     struct ye_entity_node *current = physics_list_head;
     while (current != NULL) {
-        // if we have a physics component and a transform component
-        if (current->entity->physics->active && current->entity->transform != NULL) {
-            // if we have velocity proceed with checks
-            if(current->entity->physics->velocity.x != 0 || current->entity->physics->velocity.y != 0){
-                
-                /*
-                    CASE THAT ENTITY HAS NO COLLIDER
-                    We just apply its velocity to its transform (also account for rotational)
-                */
-                if(current->entity->collider == NULL){
-                    current->entity->transform->x += current->entity->physics->velocity.x * delta;
-                    current->entity->transform->y += current->entity->physics->velocity.y * delta;
-                    
-                    // do the rotation as well
-                    if(current->entity->physics->rotational_velocity != 0 && current->entity->renderer != NULL){
-                        // update the entity's rotation based on its rotational velocity
-                        current->entity->renderer->rotation += current->entity->physics->rotational_velocity * delta;
-                        if(current->entity->renderer->rotation > 360) current->entity->renderer->rotation -= 360;
-                        if(current->entity->renderer->rotation < 0) current->entity->renderer->rotation += 360;
-                    }
-
-                    current = current->next;
-                    continue;
-                }
-
-                /*
-                    CASE THAT ENTITY HAS A COLLIDER
-                    We need to check if we are colliding with any other colliders (CCD)
-                */
-                // get the current collider position
-                struct ye_rectf old_position = ye_get_position(current->entity,YE_COMPONENT_COLLIDER);
-                struct ye_rectf new_position = old_position;
-
-                // calculate the change in position based on the velocity
-                float dx = current->entity->physics->velocity.x * delta;
-                float dy = current->entity->physics->velocity.y * delta;
-
-                // if this entity has a static collider, we need to check if we are colliding with any other static colliders
-                if(current->entity->collider && !current->entity->collider->is_trigger && current->entity->collider->active){
-                    for(int i = 0; i < YE_PHYSICS_SUBSTEPS; i++){
-                        float substep = (i + 1) / (float)YE_PHYSICS_SUBSTEPS;  // Calculate sub-step factor
-
-                        // Calculate the interpolated position based on the sub-step
-                        new_position.x = old_position.x + substep * dx;
-                        new_position.y = old_position.y + substep * dy;
-                        
-                        // check for collisions by comparing this interpolated position with all other colliders
-                        struct ye_entity_node *current_collider = collider_list_head;
-                        while (current_collider != NULL) {
-                            // if a collider is on a different entity and is active
-                            if (current_collider->entity->id != current->entity->id && current_collider->entity->collider != NULL && current_collider->entity->collider->active) {
-                                // check if we collide with it
-                                if(ye_rectf_collision(new_position, ye_get_position(current_collider->entity,YE_COMPONENT_COLLIDER))){
-                                    break;
-                                }
-                            }
-                            current_collider = current_collider->next;
-                        }
-
-                        // if we actually hit a collider this step, current_collider will not be NULL
-                        if(current_collider != NULL){
-                            // ye_logf(debug, "Hit collider on entity %d\n", current_collider->entity->id);
-                            // if collider we touched is static
-                            if(!current_collider->entity->collider->is_trigger){
-                                current->entity->physics->velocity.x = 0;
-                                current->entity->physics->velocity.y = 0;
-
-                                /*
-                                    Saving for later as it may be relevant to the future:
-
-                                    // calculate the distance between the entity and the collider in both directions
-                                    int dx = current_collider->entity->collider->rect.x - (current->entity->transform->rect.w + current->entity->collider->rect.w) - current->entity->transform->rect.x;
-                                    int dy = current_collider->entity->collider->rect.y - (current->entity->transform->rect.h + current->entity->collider->rect.h) - current->entity->transform->rect.y;
-
-                                    // move the entity in the direction with the smaller distance, unless already overlapping
-                                    if (abs(dx) < abs(dy) && dx != 0) {
-                                        current->entity->transform->rect.x += dx + current->entity->collider->rect.w;
-                                    } else if (abs(dy) < abs(dx) && dy != 0) {
-                                        current->entity->transform->rect.y += dy;
-                                    }
-                                */
-                                
-                                break; // break out of the substep loop
-                            }
-                        } // TODO: do we want to cancel rotational velocity here too?
-                    }
-                }
-                /*
-                    even if we havent changed our new position at all from the old, this line is still true.
-                    We are changing whatever position this entity needs to be based on whatever substep max it hit or change it needs to be.
-                */
-                current->entity->transform->x = new_position.x;
-                current->entity->transform->y = new_position.y;
-            }
-            // if we have rotational velocity apply it (if we have a renderer)
-            if(current->entity->physics->rotational_velocity != 0 && current->entity->renderer != NULL){
-                // update the entity's rotation based on its rotational velocity
-                current->entity->renderer->rotation += current->entity->physics->rotational_velocity * delta;
-                if(current->entity->renderer->rotation > 360) current->entity->renderer->rotation -= 360;
-                if(current->entity->renderer->rotation < 0) current->entity->renderer->rotation += 360;
+        struct ye_entity *entity = current->entity;
+        if (entity->physics->active && entity->transform != NULL) {
+            if(!_ye_physics_reserve_bodies(physics_body_count + 1))
+                break;
+            int i = physics_body_count++;
+            body_entity[i] = entity;
+            body_vx[i] = entity->physics->velocity.x;
+            body_vy[i] = entity->physics->velocity.y;
+            body_tx[i] = entity->transform->x;
+            body_ty[i] = entity->transform->y;
+            body_rotation[i] = entity->renderer != NULL ? entity->renderer->rotation : 0;
+            body_spin[i] = entity->renderer != NULL ? entity->physics->rotational_velocity : 0;
+
+            // collider in world space, same as ye_get_position(entity, YE_COMPONENT_COLLIDER)
+            body_solid[i] = entity->collider != NULL && entity->collider->active && !entity->collider->is_trigger;
+            struct ye_rectf collider = body_solid[i] ? entity->collider->rect : (struct ye_rectf){0,0,0,0};
+            if(body_solid[i] && entity->collider->relative){
+                collider.x += body_tx[i];
+                collider.y += body_ty[i];
             }
+            body_x[i] = collider.x;
+            body_y[i] = collider.y;
+            body_w[i] = collider.w;
+            body_h[i] = collider.h;
+            body_pair_start[i] = 0;
+            body_pair_count[i] = 0;
         }
         current = current->next;
     }
-    // printf("Physics system took %lu ms\n", SDL_GetTicks64() - start);
-}
\ No newline at end of file
+    if(physics_body_count == 0)
+        return;
+
+    // integrate
+    ye_parallel_for(physics_body_count, YE_PHYSICS_PARALLEL_GRAIN, _ye_physics_integrate, NULL);
+
+    // broadphase, anything could have moved since the index was built so make sure its fresh
+    ye_spatial_invalidate();
+    _ye_physics_broadphase();
+
+    // narrowphase
+    ye_parallel_for(physics_pair_count, YE_PHYSICS_PARALLEL_GRAIN, _ye_physics_narrowphase, NULL);
+
+    // resolve, turning each body's wanted movement into the movement it actually gets
+    for(int i = 0; i < physics_body_count; i++){
+        // find the earliest substep we hit something solid, on ties the first pair wins
+        int contact = -1;
+        for(int p = body_pair_start[i]; p < body_pair_start[i] + body_pair_count[i]; p++){
+            if(pair_trigger[p] || pair_hit[p] < 0)
+                continue;
+            if(contact < 0 || pair_hit[p] < pair_hit[contact])
+                contact = p;
+        }
+
+        if(contact >= 0){
+            struct ye_vec2f moved = _ye_physics_respond(i, contact);
+            body_dx[i] = moved.x;
+            body_dy[i] = moved.y;
+        } // TODO: do we want to cancel rotational velocity here too?
+    }
+
+    // advance
+    ye_parallel_for(physics_body_count, YE_PHYSICS_PARALLEL_GRAIN, _ye_physics_advance, NULL);
+
+    // scatter, the only place we write back to the ECS
+    for(int i = 0; i < physics_body_count; i++){
+        struct ye_entity *entity = body_entity[i];
+        entity->transform->x = body_tx[i];
+        entity->transform->y = body_ty[i];
+        entity->physics->velocity.x = body_vx[i];
+        entity->physics->velocity.y = body_vy[i];
+        if(body_spin[i] != 0)
+            entity->renderer->rotation = body_rotation[i];
+    }
+
+    // we moved things, so the next query needs a rebuild
+    ye_spatial_invalidate();
+}
+
+void ye_shutdown_physics(){
+    void **buffers[] = {
+        (void**)&body_entity, (void**)&body_vx, (void**)&body_vy, (void**)&body_dx, (void**)&body_dy,
+        (void**)&body_x, (void**)&body_y, (void**)&body_w, (void**)&body_h,
+        (void**)&body_tx, (void**)&body_ty, (void**)&body_rotation, (void**)&body_spin,
+        (void**)&body_solid, (void**)&body_pair_start, (void**)&body_pair_count,
+        (void**)&pair_body, (void**)&pair_ax, (void**)&pair_ay, (void**)&pair_aw, (void**)&pair_ah,
+        (void**)&pair_dx, (void**)&pair_dy, (void**)&pair_bx, (void**)&pair_by, (void**)&pair_bw, (void**)&pair_bh,
+        (void**)&pair_trigger, (void**)&pair_hit, (void**)&physics_query_hits
+    };
+    for(size_t i = 0; i < sizeof(buffers) / sizeof(buffers[0]); i++){
+        free(*buffers[i]);
+        *buffers[i] = NULL;
+    }
+    physics_body_count = physics_body_capacity = 0;
+    physics_pair_count = physics_pair_capacity = 0;
+    physics_query_capacity = 0;
+}
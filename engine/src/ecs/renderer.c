@@ -18,14 +18,18 @@
 
 #include <yoyoengine/yoyoengine.h>
 
+extern SDL_Texture *missing_texture;
+
 void ye_update_renderer_component(struct ye_entity *entity){
     /*The purpose of this function is to be invoked when we know we have changed some internal variables of the renderer, and need to recompute the outputted texture*/
     switch(entity->renderer->type){
-        case YE_RENDERER_TYPE_IMAGE:
-            entity->renderer->texture = ye_image(
-                ye_get_resource_static(entity->renderer->renderer_impl.image->src)
-            );
+        case YE_RENDERER_TYPE_IMAGE: {
+            // acquire the new one before releasing the old, in case they are the same texture
+            SDL_Texture *old_texture = entity->renderer->texture;
+            entity->renderer->texture = ye_image_acquire_streamed(entity->renderer->renderer_impl.image->src);
+            ye_image_release(old_texture);
             break;
+        }
         case YE_RENDERER_TYPE_TEXT:
             // destroy old text texture (not managed in cache)
             SDL_DestroyTexture(entity->renderer->texture);
@@ -91,6 +95,7 @@ void ye_add_renderer_component(
 
     // add this entity to the renderer component list
     ye_entity_list_add_sorted_renderer_z(&renderer_list_head, entity);
+    ye_spatial_invalidate();
 
     // log that we added a renderer and to what ID
     // ye_logf(debug, "Added renderer to entity %d\n", entity->id);
@@ -105,8 +110,8 @@ void ye_temp_add_image_renderer_component(struct ye_entity *entity, int z, const
     // create the renderer top level
     ye_add_renderer_component(entity, YE_RENDERER_TYPE_IMAGE, z, image);
 
-    // create the image texture
-    entity->renderer->texture = ye_image(src);
+    // create the image texture (held until the renderer is removed), a placeholder until it streams in
+    entity->renderer->texture = ye_image_acquire_streamed(src);
 
     // update rect based off generated image
     SDL_Rect size = ye_get_real_texture_size_rect(entity->renderer->texture);
@@ -181,7 +186,7 @@ void ye_temp_add_animation_renderer_component(struct ye_entity *entity, int z, c
     for (size_t i = 0; i < (size_t)count; ++i) {
         char filename[256];  // Assuming a maximum filename length of 255 characters
         snprintf(filename, sizeof(filename), "%s/%d.%s", ye_get_resource_static(path), (int)i, format); // TODO: dumb optimization but could cut out all except frame num insertion here
-        animation->frames[i] = ye_image(filename);
+        animation->frames[i] = ye_image_acquire(filename);
     }
 
     // create the renderer top level
@@ -201,6 +206,7 @@ void ye_temp_add_animation_renderer_component(struct ye_entity *entity, int z, c
 void ye_remove_renderer_component(struct ye_entity *entity){
     // free contents of renderer_impl
     if(entity->renderer->type == YE_RENDERER_TYPE_IMAGE){
+        ye_image_release(entity->renderer->texture);
         free(entity->renderer->renderer_impl.image->src);
         free(entity->renderer->renderer_impl.image);
     }
@@ -226,7 +232,10 @@ void ye_remove_renderer_component(struct ye_entity *entity){
         SDL_DestroyTexture(entity->renderer->texture);
     }
     else if(entity->renderer->type == YE_RENDERER_TYPE_ANIMATION){
-        // cache will handle freeing the frames as needed
+        // cache will handle freeing the frames as needed, we just let go of them
+        for(size_t i = 0; i < entity->renderer->renderer_impl.animation->frame_count; i++){
+            ye_image_release(entity->renderer->renderer_impl.animation->frames[i]);
+        }
 
         free(entity->renderer->renderer_impl.animation->animation_path);
         free(entity->renderer->renderer_impl.animation->image_format);
@@ -241,6 +250,90 @@ void ye_remove_renderer_component(struct ye_entity *entity){
 
     // remove the entity from the renderer component list
     ye_entity_list_remove(&renderer_list_head, entity);
+    ye_spatial_invalidate();
+}
+
+void ye_renderer_retarget_texture(SDL_Texture *old_texture, SDL_Texture *new_texture){
+    struct ye_entity_node *current = renderer_list_head;
+    while(current != NULL){
+        struct ye_component_renderer *renderer = current->entity->renderer;
+        if(renderer->texture == old_texture)
+            renderer->texture = new_texture;
+
+        if(renderer->type == YE_RENDERER_TYPE_ANIMATION){
+            struct ye_component_renderer_animation *animation = renderer->renderer_impl.animation;
+            for(size_t i = 0; i < animation->frame_count; i++){
+                if(animation->frames[i] == old_texture)
+                    animation->frames[i] = new_texture;
+            }
+        }
+        current = current->next;
+    }
+}
+
+/*
+    Whether an image path resolves to the cache key
+*/
+bool _ye_renderer_path_is(const char *path, const char *key){
+    char path_key[1024];
+    return ye_image_key(path, path_key, sizeof(path_key)) && strcmp(path_key, key) == 0;
+}
+
+int ye_renderer_retarget_texture_path(const char *key, SDL_Texture *old_texture, SDL_Texture *new_texture){
+    int moved = 0;
+    struct ye_entity_node *current = renderer_list_head;
+    while(current != NULL){
+        struct ye_component_renderer *renderer = current->entity->renderer;
+
+        if(renderer->type == YE_RENDERER_TYPE_IMAGE){
+            if(renderer->texture == old_texture && _ye_renderer_path_is(renderer->renderer_impl.image->src, key)){
+                renderer->texture = new_texture;
+                moved++;
+            }
+        }
+        else if(renderer->type == YE_RENDERER_TYPE_ANIMATION){
+            struct ye_component_renderer_animation *animation = renderer->renderer_impl.animation;
+            for(size_t i = 0; i < animation->frame_count; i++){
+                if(animation->frames[i] != old_texture)
+                    continue;
+
+                // same filename the frame was acquired with
+                char filename[256];
+                snprintf(filename, sizeof(filename), "%s/%d.%s", ye_get_resource_static(animation->animation_path), (int)i, animation->image_format);
+                if(!_ye_renderer_path_is(filename, key))
+                    continue;
+
+                if(renderer->texture == animation->frames[i])
+                    renderer->texture = new_texture;
+                animation->frames[i] = new_texture;
+                moved++;
+            }
+        }
+        current = current->next;
+    }
+    return moved;
+}
+
+void ye_renderer_texture_streamed(const char *key){
+    SDL_Rect placeholder = ye_get_real_texture_size_rect(missing_texture);
+
+    struct ye_entity_node *current = renderer_list_head;
+    while(current != NULL){
+        struct ye_component_renderer *renderer = current->entity->renderer;
+        char src_key[1024];
+        if(renderer->type == YE_RENDERER_TYPE_IMAGE && renderer->texture == missing_texture
+            && ye_image_key(renderer->renderer_impl.image->src, src_key, sizeof(src_key)) && strcmp(src_key, key) == 0){
+            renderer->texture = ye_image_acquire(renderer->renderer_impl.image->src);
+
+            // it was sized off the placeholder, not by the user
+            if(renderer->rect.w == placeholder.w && renderer->rect.h == placeholder.h){
+                SDL_Rect size = ye_get_real_texture_size_rect(renderer->texture);
+                renderer->rect.w = size.w;
+                renderer->rect.h = size.h;
+            }
+        }
+        current = current->next;
+    }
 }
 
 void ye_system_renderer(SDL_Renderer *renderer) {
@@ -277,6 +370,10 @@ void ye_system_renderer(SDL_Renderer *renderer) {
     camera_rect.h = view_field.h;
     // update camera rect to contain the view field w,h
 
+    // how many screen pixels a world unit covers, so zoomed out images can draw a smaller variant
+    float scale_x, scale_y;
+    SDL_RenderGetScale(renderer, &scale_x, &scale_y);
+
     // Traverse tracked entities with renderer components
     struct ye_entity_node *current = renderer_list_head;
     while (current != NULL) {
@@ -346,8 +443,13 @@ void ye_system_renderer(SDL_Renderer *renderer) {
                     // ye_logf(debug, "Occluded entity %s\n", current->entity->name);
                 }
                 else{
+                    SDL_Texture *texture = current->entity->renderer->texture;
+                    if(current->entity->renderer->type == YE_RENDERER_TYPE_IMAGE || current->entity->renderer->type == YE_RENDERER_TYPE_ANIMATION){
+                        texture = ye_image_variant(texture, (int)(entity_rect.w * scale_x), (int)(entity_rect.h * scale_y));
+                    }
+
                     // set alpha (log failure) TODO: profile efficiency of this
-                    if (SDL_SetTextureAlphaMod(current->entity->renderer->texture, current->entity->renderer->alpha) != 0) {
+                    if (SDL_SetTextureAlphaMod(texture, current->entity->renderer->alpha) != 0) {
                         ye_logf(warning, "Failed to set alpha for entity %s\n", current->entity->name);
                         // log the sdl get error
                         ye_logf(warning, "SDL_GetError: %s\n", SDL_GetError());
@@ -369,13 +471,13 @@ void ye_system_renderer(SDL_Renderer *renderer) {
                         else if(current->entity->renderer->flipped_y){
                             flip = SDL_FLIP_VERTICAL;
                         }
-                        SDL_RenderCopyEx(renderer, current->entity->renderer->texture, NULL, &entity_rect, (int)current->entity->renderer->rotation, NULL, flip);
+                        SDL_RenderCopyEx(renderer, texture, NULL, &entity_rect, (int)current->entity->renderer->rotation, NULL, flip);
                     }
                     else if(current->entity->renderer->rotation != 0.0){
-                        SDL_RenderCopyEx(renderer, current->entity->renderer->texture, NULL, &entity_rect, (int)current->entity->renderer->rotation, &current->entity->renderer->center, SDL_FLIP_NONE);
+                        SDL_RenderCopyEx(renderer, texture, NULL, &entity_rect, (int)current->entity->renderer->rotation, &current->entity->renderer->center, SDL_FLIP_NONE);
                     }
                     else{
-                        SDL_RenderCopy(renderer, current->entity->renderer->texture, NULL, &entity_rect);
+                        SDL_RenderCopy(renderer, texture, NULL, &entity_rect);
                     }
                     
                     YE_STATE.runtime.painted_entity_count++;
@@ -20,6 +20,7 @@
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #include <SDL2/SDL.h>
 #include <SDL_ttf.h>
@@ -40,28 +41,98 @@ struct ye_engine_state YE_STATE; // TODO: should null out pointers and stuff? ma
 // Global variables for resource paths
 char *executable_path = NULL;
 
-char* ye_get_resource_static(const char *sub_path) {
-    static char resource_buffer[256];  // Adjust the buffer size as per your requirement
+/*
+    Resolved resource paths are interned: each unique sub path is joined with its root once,
+    and the same stable pointer is handed back on every later call (from any thread).
+*/
+struct ye_resource_path {
+    char *sub_path;
+    char *resolved;
+    size_t root_length;
+    struct ye_resource_path *retired_next;
+    UT_hash_handle hh;
+};
+
+struct ye_resource_path *resource_paths = NULL;
+struct ye_resource_path *engine_resource_paths = NULL;
+struct ye_resource_path *retired_resource_paths = NULL;    // replaced after a root changed, kept alive for anyone still holding them
+SDL_SpinLock resource_path_lock = 0;
+
+char * _ye_intern_resource_path(struct ye_resource_path **table, const char *root, const char *sub_path){
+    size_t root_length = strlen(root);
+
+    SDL_AtomicLock(&resource_path_lock);
+
+    struct ye_resource_path *entry = NULL;
+    HASH_FIND_STR(*table, sub_path, entry);
+    if(entry != NULL && entry->root_length == root_length && strncmp(entry->resolved, root, root_length) == 0){
+        SDL_AtomicUnlock(&resource_path_lock);
+        return entry->resolved;
+    }
 
+    // the root moved (ex: the editor opened another project), retire the stale join
+    if(entry != NULL){
+        HASH_DEL(*table, entry);
+        entry->retired_next = retired_resource_paths;
+        retired_resource_paths = entry;
+    }
+
+    size_t resolved_size = root_length + 1 + strlen(sub_path) + 1;
+    entry = malloc(sizeof(struct ye_resource_path));
+    entry->sub_path = strdup(sub_path);
+    entry->resolved = malloc(resolved_size);
+    snprintf(entry->resolved, resolved_size, "%s/%s", root, sub_path);
+    entry->root_length = root_length;
+    entry->retired_next = NULL;
+    HASH_ADD_KEYPTR(hh, *table, entry->sub_path, strlen(entry->sub_path), entry);
+
+    SDL_AtomicUnlock(&resource_path_lock);
+    return entry->resolved;
+}
+
+void _ye_free_resource_path(struct ye_resource_path *entry){
+    free(entry->sub_path);
+    free(entry->resolved);
+    free(entry);
+}
+
+void _ye_free_resource_paths(){
+    SDL_AtomicLock(&resource_path_lock);
+
+    struct ye_resource_path *entry, *tmp;
+    HASH_ITER(hh, resource_paths, entry, tmp){
+        HASH_DEL(resource_paths, entry);
+        _ye_free_resource_path(entry);
+    }
+    HASH_ITER(hh, engine_resource_paths, entry, tmp){
+        HASH_DEL(engine_resource_paths, entry);
+        _ye_free_resource_path(entry);
+    }
+    while(retired_resource_paths != NULL){
+        entry = retired_resource_paths->retired_next;
+        _ye_free_resource_path(retired_resource_paths);
+        retired_resource_paths = entry;
+    }
+
+    SDL_AtomicUnlock(&resource_path_lock);
+}
+
+char* ye_get_resource_static(const char *sub_path) {
     if (YE_STATE.engine.game_resources_path == NULL) {
         ye_logf(error, "Resource paths not set!\n");
         return NULL;
     }
 
-    snprintf(resource_buffer, sizeof(resource_buffer), "%s/%s", YE_STATE.engine.game_resources_path, sub_path);
-    return resource_buffer;
+    return _ye_intern_resource_path(&resource_paths, YE_STATE.engine.game_resources_path, sub_path);
 }
 
 char* ye_get_engine_resource_static(const char *sub_path) {
-    static char engine_reserved_buffer[256];  // Adjust the buffer size as per your requirement
-
     if (YE_STATE.engine.engine_resources_path == NULL) {
         ye_logf(error, "Engine reserved paths not set!\n");
         return NULL;
     }
 
-    snprintf(engine_reserved_buffer, sizeof(engine_reserved_buffer), "%s/%s", YE_STATE.engine.engine_resources_path, sub_path);
-    return engine_reserved_buffer;
+    return _ye_intern_resource_path(&engine_resource_paths, YE_STATE.engine.engine_resources_path, sub_path);
 }
 
 // event polled for per frame
@@ -77,6 +148,23 @@ void ye_process_frame(){
     YE_STATE.runtime.delta_time = (SDL_GetTicks64() - last_frame_time) / 1000.0f;
     last_frame_time = SDL_GetTicks64();
 
+    // a fixed timestep makes the simulation independent of how long frames take
+    if(YE_STATE.engine.fixed_timestep > 0){
+        YE_STATE.runtime.delta_time = YE_STATE.engine.fixed_timestep;
+    }
+
+    // record this frames delta, or swap in the recorded one if we are replaying
+    YE_STATE.runtime.delta_time = ye_replay_begin_frame(YE_STATE.runtime.delta_time);
+
+    // anything could have moved since last frame, rebuild spatial index on next query
+    ye_spatial_invalidate();
+
+    // swap in any textures that changed on disk
+    ye_hot_reload_poll();
+
+    // start sounds that finished decoding, let go of ones that finished playing
+    ye_audio_update();
+
     // C pre frame callback
     if(YE_STATE.engine.callbacks.pre_frame != NULL){
         YE_STATE.engine.callbacks.pre_frame();
@@ -84,7 +172,7 @@ void ye_process_frame(){
 
     int input_time = SDL_GetTicks64();
     ui_begin_input_checks();
-    while (SDL_PollEvent(&e)) {
+    while (ye_replay_poll_event(&e)) {
         ui_handle_input(&e);
 
         // if resize event, set resized to true
@@ -186,8 +274,19 @@ void ye_process_frame(){
     // run all scripting before the frame is rendered
     ye_system_lua_scripting();
 
-    // render frame
-    ye_render_all();
+    // wake the script tasks whose waits are over
+    ye_lua_scheduler_step();
+
+    // collect what the scripts left behind, within budget
+    ye_lua_gc_step();
+
+    // place audio sources against wherever the camera ended up
+    ye_system_audio();
+
+    // render frame (unless we are replaying without a display)
+    if(!ye_replay_is_headless()){
+        ye_render_all();
+    }
 
     YE_STATE.runtime.frame_time = SDL_GetTicks64() - last_frame_time;
 
@@ -239,6 +338,11 @@ void ye_update_resources(char *path){
     // update the engine state
     free(YE_STATE.engine.game_resources_path);
     YE_STATE.engine.game_resources_path = strdup(path);
+
+    // point the watcher at the new folder
+    if(YE_STATE.engine.hot_reload || YE_STATE.editor.editor_mode){
+        ye_init_hot_reload();
+    }
 }
 
 void ye_init_engine() {
@@ -246,13 +350,23 @@ void ye_init_engine() {
     executable_path = SDL_GetBasePath(); // Don't forget to free memory later
 
     // Set default paths for engineResourcesPath and gameResourcesPath
-    char engine_default_path[256], game_default_path[256], log_default_path[256];
+    char engine_default_path[256], game_default_path[256], log_default_path[256], pack_default_path[256];
     snprintf(engine_default_path, sizeof(engine_default_path), "%sengine_resources", executable_path);
     snprintf(game_default_path, sizeof(game_default_path), "%sresources", executable_path);
     snprintf(log_default_path, sizeof(log_default_path), "%sdebug.log", executable_path);
+    snprintf(pack_default_path, sizeof(pack_default_path), "%sresources.yepk", executable_path);
 
     // set defaults for engine state
     YE_STATE.engine.framecap = -1;
+    YE_STATE.engine.fixed_timestep = 0;
+    YE_STATE.engine.texture_cache_budget_mb = YE_DEFAULT_TEXTURE_CACHE_BUDGET_MB;
+    YE_STATE.engine.texture_upload_budget_ms = YE_DEFAULT_TEXTURE_UPLOAD_BUDGET_MS;
+    YE_STATE.engine.sound_cache_budget_mb = YE_DEFAULT_SOUND_CACHE_BUDGET_MB;
+    YE_STATE.engine.audio_channels = YE_DEFAULT_AUDIO_CHANNELS;
+    YE_STATE.engine.stream_textures = true;
+    YE_STATE.engine.lua_shared_state = true;
+    YE_STATE.engine.lua_gc_budget_ms = YE_DEFAULT_LUA_GC_BUDGET_MS;
+    YE_STATE.engine.lua_script_memory_limit_kb = 0;
     YE_STATE.engine.screen_width = 1920;
     YE_STATE.engine.screen_height = 1080;
     YE_STATE.engine.window_mode = 0;
@@ -263,6 +377,7 @@ void ye_init_engine() {
     YE_STATE.engine.engine_resources_path = strdup(engine_default_path);
     YE_STATE.engine.game_resources_path = strdup(game_default_path);
     YE_STATE.engine.log_file_path = strdup(log_default_path);
+    YE_STATE.engine.resource_pack_path = strdup(pack_default_path);
     YE_STATE.engine.icon_path = strdup(ye_get_engine_resource_static("enginelogo.png"));
 
     YE_STATE.engine.log_level = 4;
@@ -287,12 +402,25 @@ void ye_init_engine() {
         set_setting_int("screen_width", &YE_STATE.engine.screen_width, SETTINGS);
         set_setting_int("screen_height", &YE_STATE.engine.screen_height, SETTINGS);
         set_setting_int("framecap", &YE_STATE.engine.framecap, SETTINGS);
+        set_setting_float("fixed_timestep", &YE_STATE.engine.fixed_timestep, SETTINGS);
+        set_setting_int("texture_cache_budget_mb", &YE_STATE.engine.texture_cache_budget_mb, SETTINGS);
+        set_setting_float("texture_upload_budget_ms", &YE_STATE.engine.texture_upload_budget_ms, SETTINGS);
+        set_setting_float("lua_gc_budget_ms", &YE_STATE.engine.lua_gc_budget_ms, SETTINGS);
+        set_setting_int("sound_cache_budget_mb", &YE_STATE.engine.sound_cache_budget_mb, SETTINGS);
+        set_setting_int("audio_channels", &YE_STATE.engine.audio_channels, SETTINGS);
+        set_setting_int("lua_script_memory_limit_kb", &YE_STATE.engine.lua_script_memory_limit_kb, SETTINGS);
+        set_setting_string("resource_pack_path", &YE_STATE.engine.resource_pack_path, SETTINGS);
+        set_setting_string("lua_bytecode_cache_path", &YE_STATE.engine.lua_bytecode_cache_path, SETTINGS);
 
         set_setting_bool("debug_mode", &YE_STATE.engine.debug_mode, SETTINGS);
         set_setting_bool("skip_intro", &YE_STATE.engine.skipintro, SETTINGS);
         set_setting_bool("editor_mode", &YE_STATE.editor.editor_mode, SETTINGS);
 
         set_setting_bool("stretch_resolution", &YE_STATE.engine.stretch_resolution, SETTINGS);
+        set_setting_bool("hot_reload", &YE_STATE.engine.hot_reload, SETTINGS);
+        set_setting_bool("stream_textures", &YE_STATE.engine.stream_textures, SETTINGS);
+        set_setting_bool("lua_shared_state", &YE_STATE.engine.lua_shared_state, SETTINGS);
+        set_setting_bool("lua_gc_generational", &YE_STATE.engine.lua_gc_generational, SETTINGS);
 
         // we will decref settings later on after we load the scene, so the path to the entry scene still exists
     }
@@ -303,6 +431,15 @@ void ye_init_engine() {
 
     // ----------------- Begin Setup -------------------
 
+    // if the game shipped a resource pack, mount it so resources load out of it instead of loose files.
+    // this comes first, anything loaded during setup (like the window icon) may only exist in the pack
+    if(access(YE_STATE.engine.resource_pack_path, F_OK) != -1){
+        ye_pack_mount(YE_STATE.engine.resource_pack_path);
+    }
+    else{
+        ye_logf(debug, "No resource pack found at %s, using loose resources.\n", YE_STATE.engine.resource_pack_path);
+    }
+
     // initialize graphics systems, creating window renderer, etc
     // TODO: should this just take in engine state struct? would make things a lot easier tbh
     ye_init_graphics();
@@ -310,6 +447,9 @@ void ye_init_engine() {
     // init timers
     ye_init_timers();
 
+    // spin up the worker pool used to spread systems across cores
+    ye_init_workers();
+
     // initialize the cache
     ye_init_cache();
 
@@ -338,6 +478,17 @@ void ye_init_engine() {
     // initialize entity component system
     ye_init_ecs();
 
+    // initialize spatial queries
+    ye_init_spatial();
+
+    // initialize lua scripting (the shared state scripts run in)
+    ye_init_lua_scripting();
+
+    // watch resources for changes so art can be iterated on without restarting
+    if(YE_STATE.engine.hot_reload || YE_STATE.editor.editor_mode){
+        ye_init_hot_reload();
+    }
+
     // if we are in debug mode
     if(YE_STATE.engine.debug_mode){
         // display in console
@@ -413,6 +564,9 @@ void ye_init_engine() {
         ye_destroy_entity(splash_gear);
     }
 
+    // started after the splash so it is never shown half loaded
+    ye_init_texture_streaming();
+
     // debug output
     ye_logf(info, "Engine Fully Initialized.\n");
 
@@ -436,6 +590,15 @@ void ye_init_engine() {
 void ye_shutdown_engine(){
     ye_logf(info, "Shutting down engine...\n");
 
+    // stop any recording or playback so the file is flushed
+    ye_replay_stop();
+
+    // stop watching resources before anything it reloads into goes away
+    ye_shutdown_hot_reload();
+
+    // stop streaming textures in before the cache goes away
+    ye_shutdown_texture_streaming();
+
     // shut tricks down
     ye_shutdown_tricks();
 
@@ -449,6 +612,18 @@ void ye_shutdown_engine(){
     // shutdown ECS
     ye_shutdown_ecs();
 
+    // shutdown lua scripting, every script was removed with the ECS
+    ye_shutdown_lua_scripting();
+
+    // shutdown physics scratch state
+    ye_shutdown_physics();
+
+    // shutdown spatial queries
+    ye_shutdown_spatial();
+
+    // stop the worker pool
+    ye_shutdown_workers();
+
     // shutdown timers
     ye_shutdown_timers();
 
@@ -463,13 +638,19 @@ void ye_shutdown_engine(){
     ye_audio_shutdown();
     ye_logf(info, "Shut down audio.\n");
 
+    // nothing is reading from the resource pack anymore
+    ye_pack_unmount();
+
     // shutdown logging
     // note: must happen before SDL because it relies on SDL path to open file
     ye_log_shutdown();
     free(YE_STATE.engine.log_file_path);
+    free(YE_STATE.engine.resource_pack_path);
+    free(YE_STATE.engine.lua_bytecode_cache_path);
     free(YE_STATE.engine.engine_resources_path);
     free(YE_STATE.engine.game_resources_path);
     free(YE_STATE.engine.icon_path);
+    _ye_free_resource_paths();
     SDL_free(base_path); // free base path after (used by logging)
     SDL_free(executable_path); // free base path after (used by logging)
 
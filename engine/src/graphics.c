@@ -17,6 +17,8 @@
 */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <math.h>
 
@@ -48,6 +50,19 @@ TTF_Font * ye_load_font(const char *pFontPath/*, int fontSize*/) {
         }
     */
     const char *fontpath = pFontPath;
+
+    // fonts in the resource pack are read straight out of the mapping (it outlives the font)
+    SDL_RWops *pack_rw = ye_pack_open(fontpath);
+    if(pack_rw != NULL){
+        TTF_Font *pFont = TTF_OpenFontRW(pack_rw, 1, 1);
+        if (pFont == NULL) {
+            ye_logf(error, "Failed to load font: %s\n", TTF_GetError());
+            return YE_STATE.engine.pEngineFont;
+        }
+        ye_logf(debug, "Loaded font from pack: %s\n", pFontPath);
+        return pFont;
+    }
+
     if(access(fontpath, F_OK) == -1){
         ye_logf(error, "Could not access file '%s'.\n", fontpath);
         return YE_STATE.engine.pEngineFont;
@@ -124,36 +139,85 @@ SDL_Texture *createTextTexture(const char *pText, TTF_Font *pFont, SDL_Color *pC
     return pTexture;
 }
 
-SDL_Texture * ye_create_image_texture(const char *pPath) {
-    // check the file exists
-    if(access(pPath, F_OK) == -1){
-        ye_logf(error, "Could not access file '%s'.\n", pPath);
-        return missing_texture; // return missing texture, error has been logged
+bool ye_image_source_open(const char *path, struct ye_image_source *source){
+    memset(source, 0, sizeof(*source));
+    if(path == NULL)
+        return false;
+
+    // a pre-decoded .yetex takes priority over the image itself (see yetex.h)
+    char yetex_path[1024];
+    snprintf(yetex_path, sizeof(yetex_path), "%s%s", path, YE_YETEX_EXTENSION);
+    const char *candidates[2] = {yetex_path, path};
+
+    // prefer the resource pack, its already in memory. check it for both before touching the disk,
+    // so a packed image without a .yetex never costs a failed open of the .yetex
+    for(int i = 0; i < 2 && source->data == NULL; i++){
+        source->yetex = i == 0;
+        source->data = ye_pack_data(candidates[i], &source->size);
     }
+    for(int i = 0; i < 2 && source->data == NULL; i++){
+        source->yetex = i == 0;
+        source->data = ye_read_file(candidates[i], &source->size);
+        source->owned = source->data != NULL;
+    }
+    if(source->data == NULL)
+        return false;
 
-    // create surface from loading the image
-    SDL_Surface *pImage_surface = IMG_Load(pPath);
-    
-    // error out if surface load failed
-    if (!pImage_surface) {
+    source->hash = ye_hash_bytes(source->data, source->size);
+    return true;
+}
+
+SDL_Surface * ye_image_source_decode(struct ye_image_source *source){
+    if(source->yetex)
+        return ye_decode_yetex_surface(source->data, source->size);
+
+    SDL_Surface *surface = IMG_Load_RW(SDL_RWFromConstMem(source->data, (int)source->size), 1);
+    if(surface == NULL)
         ye_logf(error, "Error loading image: %s\n", IMG_GetError());
-        return missing_texture; // return missing texture, error has been logged
-    }
+    return surface;
+}
+
+SDL_Texture * ye_image_source_texture(struct ye_image_source *source){
+    // pre-decoded pixels skip SDL_image and the intermediate surface entirely
+    if(source->yetex)
+        return ye_create_yetex_texture(source->data, source->size);
+
+    SDL_Surface *pImage_surface = ye_image_source_decode(source);
+    if(pImage_surface == NULL)
+        return NULL;
 
     // create texture from surface
     SDL_Texture *pTexture = SDL_CreateTextureFromSurface(pRenderer, pImage_surface);
-    
+
+    // release surface from memory
+    SDL_FreeSurface(pImage_surface);
+
     // error out if texture creation failed
     if (!pTexture) {
         ye_logf(error, "Error creating texture: %s\n", SDL_GetError());
+        return NULL;
+    }
+    return pTexture;
+}
+
+void ye_image_source_close(struct ye_image_source *source){
+    if(source->owned)
+        free((void*)source->data);
+    memset(source, 0, sizeof(*source));
+}
+
+SDL_Texture * ye_create_image_texture(const char *pPath) {
+    struct ye_image_source source;
+    if(!ye_image_source_open(pPath, &source)){
+        ye_logf(error, "Could not access file '%s'.\n", pPath);
         return missing_texture; // return missing texture, error has been logged
     }
 
-    // release surface from memory
-    SDL_FreeSurface(pImage_surface);
+    SDL_Texture *pTexture = ye_image_source_texture(&source);
+    ye_image_source_close(&source);
 
-    // return the created texture
-    return pTexture;
+    // return the created texture, or missing texture if it failed (error has been logged)
+    return pTexture != NULL ? pTexture : missing_texture;
 }
 
 // variables for render all :3
@@ -183,6 +247,9 @@ void ye_render_all() {
         }
     }
 
+    // make any downscaled textures the renderer asked for last frame, while nothing is drawn yet
+    ye_generate_texture_variants();
+
     /*
         Clear the screen
     */
@@ -228,6 +295,9 @@ void ye_render_all() {
         SDL_RenderSetLogicalSize(pRenderer, YE_STATE.engine.target_camera->camera->view_field.w, YE_STATE.engine.target_camera->camera->view_field.h);
     }
 
+    // upload whatever streamed textures fit in this frame, before anything samples them
+    ye_texture_stream_update();
+
     ye_system_renderer(pRenderer);
 
     /*
@@ -380,10 +450,15 @@ void ye_init_graphics(){
     }
     ye_logf(info, "IMG initialized.\n");
 
-    // load icon to surface
-    SDL_Surface *pIconSurface = IMG_Load(YE_STATE.engine.icon_path);
+    // load icon to surface, from the pack or a .yetex if the build packed or pre-decoded it
+    struct ye_image_source icon_source;
+    SDL_Surface *pIconSurface = NULL;
+    if (ye_image_source_open(YE_STATE.engine.icon_path, &icon_source)) {
+        pIconSurface = ye_image_source_decode(&icon_source);
+        ye_image_source_close(&icon_source);
+    }
     if (pIconSurface == NULL) {
-        ye_logf(error, "IMG_Load error: %s", IMG_GetError());
+        ye_logf(error, "Failed to load window icon: %s\n", YE_STATE.engine.icon_path);
         exit(1);
     }
     // set icon
@@ -0,0 +1,378 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/yoyolick/yoyoengine)
+    Copyright (C) 2023  Ryan Zmuda
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#ifdef __linux__
+    #include <poll.h>
+    #include <unistd.h>
+    #include <sys/inotify.h>
+#endif
+
+#include <SDL2/SDL.h>
+#include <SDL_image.h>
+
+#include <yoyoengine/yoyoengine.h>
+
+/*
+    A decoded file waiting for the main thread to swap it in
+*/
+struct ye_hot_reload_result {
+    char *path;                             // cache key (the image path, even if the .yetex changed)
+    SDL_Surface *surface;
+    struct ye_hot_reload_result *next;
+};
+
+/*
+    Last seen state of a file, used by the polling fallback
+*/
+struct ye_hot_reload_file {
+    char *path;
+    time_t mtime;
+    off_t size;
+    UT_hash_handle hh;
+};
+
+SDL_Thread *hot_reload_thread = NULL;
+SDL_mutex *hot_reload_mutex = NULL;                     // guards hot_reload_ready
+SDL_atomic_t hot_reload_running;
+struct ye_hot_reload_result *hot_reload_ready = NULL;
+char *hot_reload_root = NULL;
+struct ye_hot_reload_file *hot_reload_files = NULL;     // only touched by the watcher thread
+
+#ifdef __linux__
+int hot_reload_inotify = -1;
+struct ye_hot_reload_watch {
+    int wd;
+    char *path;
+} *hot_reload_watches = NULL;
+int hot_reload_watch_count = 0;
+int hot_reload_watch_capacity = 0;
+#endif
+
+bool _ye_hot_reload_has_suffix(const char *path, const char *suffix){
+    size_t path_length = strlen(path);
+    size_t suffix_length = strlen(suffix);
+    return path_length >= suffix_length && strcasecmp(path + path_length - suffix_length, suffix) == 0;
+}
+
+bool _ye_hot_reload_is_image(const char *path){
+    const char *extensions[] = {".png", ".jpg", ".jpeg", ".bmp", ".tga", ".gif", ".webp", YE_YETEX_EXTENSION};
+    for(size_t i = 0; i < sizeof(extensions) / sizeof(extensions[0]); i++){
+        if(_ye_hot_reload_has_suffix(path, extensions[i]))
+            return true;
+    }
+    return false;
+}
+
+/*
+    Re-decodes a changed file on the watcher thread and queues it for the main thread.
+    Returns false if it could not be decoded (ex: it is still being written).
+*/
+bool _ye_hot_reload_changed(const char *path){
+    if(!_ye_hot_reload_is_image(path))
+        return true;
+
+    char key[1024];
+    snprintf(key, sizeof(key), "%s", path);
+
+    SDL_Surface *surface = NULL;
+    if(_ye_hot_reload_has_suffix(path, YE_YETEX_EXTENSION)){
+        key[strlen(key) - strlen(YE_YETEX_EXTENSION)] = '\0';
+        surface = ye_load_yetex_surface(path);
+    }
+    else{
+        // if the image has a .yetex, that is what got loaded, and its own change will reload it
+        char yetex_path[1024];
+        struct stat st;
+        snprintf(yetex_path, sizeof(yetex_path), "%s%s", path, YE_YETEX_EXTENSION);
+        if(stat(yetex_path, &st) == 0)
+            return true;
+        surface = IMG_Load(path);
+    }
+
+    if(surface == NULL){
+        ye_logf(debug, "Hot reload could not decode %s yet.\n", path);
+        return false;
+    }
+
+    // replace a reload of the same file that has not been applied yet
+    SDL_LockMutex(hot_reload_mutex);
+    struct ye_hot_reload_result *result = hot_reload_ready;
+    while(result != NULL && strcmp(result->path, key) != 0)
+        result = result->next;
+    if(result != NULL){
+        SDL_FreeSurface(result->surface);
+        result->surface = surface;
+    }
+    else{
+        result = malloc(sizeof(struct ye_hot_reload_result));
+        result->path = strdup(key);
+        result->surface = surface;
+        result->next = hot_reload_ready;
+        hot_reload_ready = result;
+    }
+    SDL_UnlockMutex(hot_reload_mutex);
+    return true;
+}
+
+/*
+    POLLING FALLBACK
+*/
+
+/*
+    Walks the folder, reporting anything new or modified since the last scan (if report is set)
+*/
+void _ye_hot_reload_scan(const char *directory, bool report){
+    DIR *dir = opendir(directory);
+    if(dir == NULL)
+        return;
+
+    struct dirent *entry;
+    while((entry = readdir(dir)) != NULL){
+        if(strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+            continue;
+
+        char path[1024];
+        snprintf(path, sizeof(path), "%s/%s", directory, entry->d_name);
+
+        struct stat st;
+        if(stat(path, &st) != 0)
+            continue;
+        if(S_ISDIR(st.st_mode)){
+            _ye_hot_reload_scan(path, report);
+            continue;
+        }
+
+        struct ye_hot_reload_file *file = NULL;
+        HASH_FIND_STR(hot_reload_files, path, file);
+        if(file == NULL){
+            file = malloc(sizeof(struct ye_hot_reload_file));
+            file->path = strdup(path);
+            HASH_ADD_KEYPTR(hh, hot_reload_files, file->path, strlen(file->path), file);
+        }
+        else if(file->mtime == st.st_mtime && file->size == st.st_size){
+            continue;
+        }
+        file->mtime = st.st_mtime;
+        file->size = st.st_size;
+
+        // forget the timestamp of anything we could not decode so the next scan retries it
+        if(report && !_ye_hot_reload_changed(path))
+            file->mtime = 0;
+    }
+    closedir(dir);
+}
+
+void _ye_hot_reload_poll_loop(){
+    ye_logf(info, "Hot reload polling %s every %dms.\n", hot_reload_root, YE_HOT_RELOAD_POLL_MS);
+
+    _ye_hot_reload_scan(hot_reload_root, false);
+    while(SDL_AtomicGet(&hot_reload_running)){
+        // sleep in short steps so shutdown does not wait on a full interval
+        for(int waited = 0; waited < YE_HOT_RELOAD_POLL_MS && SDL_AtomicGet(&hot_reload_running); waited += 50)
+            SDL_Delay(50);
+        _ye_hot_reload_scan(hot_reload_root, true);
+    }
+}
+
+/*
+    INOTIFY
+*/
+
+#ifdef __linux__
+void _ye_hot_reload_add_watch(const char *directory){
+    int wd = inotify_add_watch(hot_reload_inotify, directory, IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_ONLYDIR);
+    if(wd < 0)
+        return;
+
+    if(hot_reload_watch_count == hot_reload_watch_capacity){
+        hot_reload_watch_capacity = hot_reload_watch_capacity > 0 ? hot_reload_watch_capacity * 2 : 16;
+        hot_reload_watches = realloc(hot_reload_watches, sizeof(struct ye_hot_reload_watch) * hot_reload_watch_capacity);
+    }
+    hot_reload_watches[hot_reload_watch_count].wd = wd;
+    hot_reload_watches[hot_reload_watch_count].path = strdup(directory);
+    hot_reload_watch_count++;
+
+    // inotify is not recursive, watch every subfolder too
+    DIR *dir = opendir(directory);
+    if(dir == NULL)
+        return;
+    struct dirent *entry;
+    while((entry = readdir(dir)) != NULL){
+        if(strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+            continue;
+        char path[1024];
+        snprintf(path, sizeof(path), "%s/%s", directory, entry->d_name);
+        struct stat st;
+        if(stat(path, &st) == 0 && S_ISDIR(st.st_mode))
+            _ye_hot_reload_add_watch(path);
+    }
+    closedir(dir);
+}
+
+const char * _ye_hot_reload_watch_path(int wd){
+    for(int i = 0; i < hot_reload_watch_count; i++){
+        if(hot_reload_watches[i].wd == wd)
+            return hot_reload_watches[i].path;
+    }
+    return NULL;
+}
+
+void _ye_hot_reload_inotify_loop(){
+    ye_logf(info, "Hot reload watching %s (%d folders).\n", hot_reload_root, hot_reload_watch_count);
+
+    // aligned for the event structs we read out of it
+    char buffer[16 * 1024] __attribute__((aligned(__alignof__(struct inotify_event))));
+    struct pollfd pfd = {hot_reload_inotify, POLLIN, 0};
+
+    while(SDL_AtomicGet(&hot_reload_running)){
+        // wake up regularly to notice shutdown
+        if(poll(&pfd, 1, 100) <= 0)
+            continue;
+
+        ssize_t length = read(hot_reload_inotify, buffer, sizeof(buffer));
+        if(length <= 0)
+            continue;
+
+        for(char *p = buffer; p < buffer + length; p += sizeof(struct inotify_event) + ((struct inotify_event*)p)->len){
+            struct inotify_event *event = (struct inotify_event*)p;
+            const char *directory = _ye_hot_reload_watch_path(event->wd);
+            if(directory == NULL || event->len == 0)
+                continue;
+
+            char path[1024];
+            snprintf(path, sizeof(path), "%s/%s", directory, event->name);
+
+            if(event->mask & IN_ISDIR){
+                if(event->mask & (IN_CREATE | IN_MOVED_TO))
+                    _ye_hot_reload_add_watch(path);
+            }
+            else if(event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)){
+                _ye_hot_reload_changed(path);
+            }
+        }
+    }
+}
+#endif
+
+int _ye_hot_reload_thread(void *data){
+    (void)data;
+
+#ifdef __linux__
+    hot_reload_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if(hot_reload_inotify >= 0){
+        _ye_hot_reload_add_watch(hot_reload_root);
+        if(hot_reload_watch_count > 0){
+            _ye_hot_reload_inotify_loop();
+            return 0;
+        }
+    }
+    ye_logf(warning, "%s", "inotify unavailable, hot reload falling back to polling.\n");
+#endif
+
+    _ye_hot_reload_poll_loop();
+    return 0;
+}
+
+void ye_init_hot_reload(){
+    ye_shutdown_hot_reload();
+
+    if(YE_STATE.engine.game_resources_path == NULL)
+        return;
+
+    hot_reload_root = strdup(YE_STATE.engine.game_resources_path);
+    hot_reload_mutex = SDL_CreateMutex();
+    SDL_AtomicSet(&hot_reload_running, 1);
+
+    hot_reload_thread = SDL_CreateThread(_ye_hot_reload_thread, "ye_hot_reload", NULL);
+    if(hot_reload_thread == NULL){
+        ye_logf(error, "Failed to start hot reload thread: %s\n", SDL_GetError());
+        ye_shutdown_hot_reload();
+    }
+}
+
+void ye_hot_reload_poll(){
+    if(hot_reload_mutex == NULL)
+        return;
+
+    // take everything that is ready, then apply it without holding the lock
+    SDL_LockMutex(hot_reload_mutex);
+    struct ye_hot_reload_result *result = hot_reload_ready;
+    hot_reload_ready = NULL;
+    SDL_UnlockMutex(hot_reload_mutex);
+
+    while(result != NULL){
+        struct ye_hot_reload_result *next = result->next;
+        if(ye_cache_reload_texture(result->path, result->surface))
+            ye_logf(info, "Hot reloaded %s\n", result->path);
+        SDL_FreeSurface(result->surface);
+        free(result->path);
+        free(result);
+        result = next;
+    }
+}
+
+void ye_shutdown_hot_reload(){
+    if(hot_reload_thread != NULL){
+        SDL_AtomicSet(&hot_reload_running, 0);
+        SDL_WaitThread(hot_reload_thread, NULL);
+        hot_reload_thread = NULL;
+    }
+
+#ifdef __linux__
+    if(hot_reload_inotify >= 0){
+        close(hot_reload_inotify);
+        hot_reload_inotify = -1;
+    }
+    for(int i = 0; i < hot_reload_watch_count; i++)
+        free(hot_reload_watches[i].path);
+    free(hot_reload_watches);
+    hot_reload_watches = NULL;
+    hot_reload_watch_count = 0;
+    hot_reload_watch_capacity = 0;
+#endif
+
+    struct ye_hot_reload_file *file, *tmp;
+    HASH_ITER(hh, hot_reload_files, file, tmp){
+        HASH_DEL(hot_reload_files, file);
+        free(file->path);
+        free(file);
+    }
+
+    while(hot_reload_ready != NULL){
+        struct ye_hot_reload_result *next = hot_reload_ready->next;
+        SDL_FreeSurface(hot_reload_ready->surface);
+        free(hot_reload_ready->path);
+        free(hot_reload_ready);
+        hot_reload_ready = next;
+    }
+
+    if(hot_reload_mutex != NULL){
+        SDL_DestroyMutex(hot_reload_mutex);
+        hot_reload_mutex = NULL;
+    }
+
+    free(hot_reload_root);
+    hot_reload_root = NULL;
+}
@@ -38,6 +38,26 @@
 FILE *logFile = NULL;
 char *logpath = NULL;
 
+/*
+    Worker threads (hot reload, texture streaming, scene prefetch) log too, so everything that touches the
+    file, stdout, the console buffer or the counters happens under this lock. SDL mutexes are recursive,
+    so logging from inside the console painter is fine. Created by the first log line, which always comes
+    from the main thread before any other thread exists.
+*/
+SDL_mutex *log_mutex = NULL;
+
+void _ye_log_lock(){
+    if(log_mutex == NULL)
+        log_mutex = SDL_CreateMutex();
+    if(log_mutex != NULL)
+        SDL_LockMutex(log_mutex);
+}
+
+void _ye_log_unlock(){
+    if(log_mutex != NULL)
+        SDL_UnlockMutex(log_mutex);
+}
+
 #ifdef _WIN32
 void ye_enable_virtual_terminal() {
     HANDLE hOut = GetStdHandle(STD_OUTPUT_HANDLE);
@@ -53,9 +73,15 @@ void ye_enable_virtual_terminal() {
 void ye_add_to_log_buffer(enum logLevel level, const char *text);
 
 const char* ye_get_timestamp() {
+    // only called with the log lock held
     static char datetime_str[20];
     time_t now = time(NULL);
-    struct tm local_time = *localtime(&now);
+    struct tm local_time;
+    #ifdef _WIN32
+    localtime_s(&local_time, &now);
+    #else
+    localtime_r(&now, &local_time);
+    #endif
 
     strftime(datetime_str, sizeof(datetime_str), "%Y-%m-%d %H:%M:%S", &local_time);
 
@@ -89,6 +115,8 @@ void ye_logf(enum logLevel level, const char *format, ...){
     vsnprintf(text, sizeof(text), format, args);
 
     va_end(args);
+
+    _ye_log_lock();
     
     if(level == warning){
         YE_STATE.runtime.warning_count++;
@@ -99,6 +127,7 @@ void ye_logf(enum logLevel level, const char *format, ...){
 
     // if logging is disabled, or the log level is below the threshold, return (or if the file is not open yet)
     if(YE_STATE.engine.log_level > level){ // idk why i wrote null like this i just want to feel cool
+        _ye_log_unlock();
         return;
     }
     // if logfile unititialized, put it in the buffer anyways (because it meets threshold), and if we are in debug mode then print to stdout as well
@@ -108,6 +137,7 @@ void ye_logf(enum logLevel level, const char *format, ...){
         if(YE_STATE.engine.debug_mode){
             printf("%s",text);
         }
+        _ye_log_unlock();
         return;
     }
 
@@ -137,6 +167,8 @@ void ye_logf(enum logLevel level, const char *format, ...){
 
     // Add to the log buffer
     ye_add_to_log_buffer(level, text);
+
+    _ye_log_unlock();
 }
 
 void _ye_lua_logf(enum logLevel level, const char *format, ...){
@@ -148,6 +180,8 @@ void _ye_lua_logf(enum logLevel level, const char *format, ...){
     vsnprintf(text, sizeof(text), format, args);
 
     va_end(args);
+
+    _ye_log_lock();
     
     if(level == warning){
         YE_STATE.runtime.warning_count++;
@@ -158,6 +192,7 @@ void _ye_lua_logf(enum logLevel level, const char *format, ...){
 
     // if logging is disabled, or the log level is below the threshold, return (or if the file is not open yet)
     if(YE_STATE.engine.log_level > level){ // idk why i wrote null like this i just want to feel cool
+        _ye_log_unlock();
         return;
     }
     // if logfile unititialized, put it in the buffer anyways (because it meets threshold), and if we are in debug mode then print to stdout as well
@@ -167,6 +202,7 @@ void _ye_lua_logf(enum logLevel level, const char *format, ...){
         if(YE_STATE.engine.debug_mode){
             printf("%s",text);
         }
+        _ye_log_unlock();
         return;
     }
 
@@ -196,6 +232,8 @@ void _ye_lua_logf(enum logLevel level, const char *format, ...){
 
     // Add to the log buffer
     ye_add_to_log_buffer(level, text);
+
+    _ye_log_unlock();
 }
 
 void ye_log_newline(enum logLevel level){
@@ -203,8 +241,10 @@ void ye_log_newline(enum logLevel level){
     if(YE_STATE.engine.log_level > level){
         return;
     }
+    _ye_log_lock();
     fprintf(logFile, "\n");
     printf("\n");
+    _ye_log_unlock();
 }
 
 
@@ -299,6 +339,8 @@ void ye_paint_console(struct nk_context *ctx){
         nk_layout_row_dynamic(ctx, logHeight, 1);
         nk_group_begin(ctx, "Log", NK_WINDOW_BORDER);
 
+        // a worker thread logging would shift the buffer out from under us
+        _ye_log_lock();
         for (int i = 0; i < logBufferIndex; i++) {
             nk_layout_row_dynamic(ctx, 15, 1);
 
@@ -329,6 +371,7 @@ void ye_paint_console(struct nk_context *ctx){
                 nk_label_colored(ctx, formattedLog, NK_TEXT_LEFT, nk_rgb(255, 255, 255));  // white text
             }
         }
+        _ye_log_unlock();
 
         nk_group_end(ctx);
         // Input command section
@@ -420,4 +463,10 @@ void ye_log_shutdown(){
     ye_logf(info, "Logging shutdown\n");
     YE_STATE.runtime.log_line_count++;
     ye_close_log();
+
+    // every other thread has been shut down by now
+    if(log_mutex != NULL){
+        SDL_DestroyMutex(log_mutex);
+        log_mutex = NULL;
+    }
 }
\ No newline at end of file
@@ -0,0 +1,347 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/yoyolick/yoyoengine)
+    Copyright (C) 2023  Ryan Zmuda
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <SDL2/SDL.h>
+#include <SDL_image.h>
+#include <SDL_mixer.h>
+
+#include <yoyoengine/yoyoengine.h>
+
+/*
+    The kinds of asset a manifest tracks, in the order they are listed in the manifest
+*/
+enum ye_manifest_kind {
+    YE_MANIFEST_TEXTURE,
+    YE_MANIFEST_FONT,
+    YE_MANIFEST_SOUND,
+    YE_MANIFEST_STYLES,
+    YE_MANIFEST_KIND_COUNT
+};
+
+const char *manifest_kind_keys[YE_MANIFEST_KIND_COUNT] = {"textures", "fonts", "sounds", "styles"};
+
+/*
+    BUILDING
+*/
+
+/*
+    Size of whatever will actually be read for a resource: the pack entry if it is
+    packed, otherwise the file (or its pre-decoded .yetex for textures)
+*/
+size_t _ye_manifest_resource_size(const char *relative_path, enum ye_manifest_kind kind){
+    const char *resolved = ye_get_resource_static(relative_path);
+
+    char candidate[1024];
+    if(kind == YE_MANIFEST_TEXTURE){
+        snprintf(candidate, sizeof(candidate), "%s%s", resolved, YE_YETEX_EXTENSION);
+        size_t size = 0;
+        if(ye_pack_data(candidate, &size) != NULL)
+            return size;
+        struct stat st;
+        if(stat(candidate, &st) == 0)
+            return (size_t)st.st_size;
+    }
+
+    size_t size = 0;
+    if(ye_pack_data(resolved, &size) != NULL)
+        return size;
+
+    struct stat st;
+    if(stat(resolved, &st) == 0)
+        return (size_t)st.st_size;
+
+    ye_logf(warning, "Scene manifest references missing resource: %s\n", relative_path);
+    return 0;
+}
+
+/*
+    Adds a resource to its list once, `seen` is an object used as a set of "kind:path"
+*/
+void _ye_manifest_add(json_t *manifest, json_t *seen, enum ye_manifest_kind kind, const char *relative_path){
+    if(relative_path == NULL || relative_path[0] == '\0')
+        return;
+
+    char key[1024];
+    snprintf(key, sizeof(key), "%d:%s", (int)kind, relative_path);
+    if(json_object_get(seen, key) != NULL)
+        return;
+    json_object_set_new(seen, key, json_true());
+
+    size_t size = _ye_manifest_resource_size(relative_path, kind);
+
+    json_t *entry = json_object();
+    json_object_set_new(entry, "path", json_string(relative_path));
+    json_object_set_new(entry, "size", json_integer((json_int_t)size));
+    json_array_append_new(json_object_get(manifest, manifest_kind_keys[kind]), entry);
+
+    json_object_set_new(manifest, "total size", json_integer(json_integer_value(json_object_get(manifest, "total size")) + (json_int_t)size));
+}
+
+void _ye_manifest_add_styles(json_t *manifest, json_t *seen, const char *styles_path){
+    _ye_manifest_add(manifest, seen, YE_MANIFEST_STYLES, styles_path);
+
+    json_t *styles = ye_json_read(ye_get_resource_static(styles_path));
+    if(styles == NULL)
+        return;
+
+    json_t *fonts = json_object_get(styles, "fonts");
+    const char *font_name;
+    json_t *font;
+    json_object_foreach(fonts, font_name, font) {
+        const char *font_path = json_string_value(json_object_get(font, "path"));
+        _ye_manifest_add(manifest, seen, YE_MANIFEST_FONT, font_path);
+    }
+
+    json_decref(styles);
+}
+
+void _ye_manifest_add_renderer(json_t *manifest, json_t *seen, json_t *renderer){
+    int type_int;
+    json_t *impl = json_object_get(renderer, "impl");
+    if(impl == NULL || !ye_json_int(renderer, "type", &type_int))
+        return;
+
+    switch((enum ye_component_renderer_type)type_int){
+        case YE_RENDERER_TYPE_IMAGE:
+            _ye_manifest_add(manifest, seen, YE_MANIFEST_TEXTURE, json_string_value(json_object_get(impl, "src")));
+            break;
+        case YE_RENDERER_TYPE_ANIMATION: {
+            // same frame naming as ye_pre_cache_scene: path/framenum.extension
+            const char *path = json_string_value(json_object_get(impl, "animation path"));
+            const char *extension = json_string_value(json_object_get(impl, "image format"));
+            json_t *frame_count = json_object_get(impl, "frame count");
+            if(path == NULL || extension == NULL || !json_is_integer(frame_count))
+                break;
+            for(int i = 0; i < json_integer_value(frame_count); i++){
+                char filename[256];
+                snprintf(filename, sizeof(filename), "%s/%d.%s", path, i, extension);
+                _ye_manifest_add(manifest, seen, YE_MANIFEST_TEXTURE, filename);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+json_t * ye_build_scene_manifest(json_t *scene_file){
+    json_t *scene = json_object_get(scene_file, "scene");
+    json_t *entities = json_object_get(scene, "entities");
+    if(!json_is_array(entities)){
+        ye_logf(error, "%s", "Cannot build manifest for a scene without entities.\n");
+        return NULL;
+    }
+
+    json_t *manifest = json_object();
+    json_object_set_new(manifest, "version", json_integer(YE_MANIFEST_VERSION));
+    json_object_set_new(manifest, "total size", json_integer(0));
+    for(int i = 0; i < YE_MANIFEST_KIND_COUNT; i++)
+        json_object_set_new(manifest, manifest_kind_keys[i], json_array());
+
+    json_t *seen = json_object();
+
+    json_t *styles = json_object_get(scene_file, "styles");
+    for(size_t i = 0; i < json_array_size(styles); i++)
+        _ye_manifest_add_styles(manifest, seen, json_string_value(json_array_get(styles, i)));
+
+    for(size_t i = 0; i < json_array_size(entities); i++){
+        json_t *components = json_object_get(json_array_get(entities, i), "components");
+        if(components == NULL)
+            continue;
+
+        json_t *renderer = json_object_get(components, "renderer");
+        if(renderer != NULL)
+            _ye_manifest_add_renderer(manifest, seen, renderer);
+
+        // sounds are picked up from their components' paths
+        json_t *audiosource = json_object_get(components, "audiosource");
+        if(audiosource != NULL)
+            _ye_manifest_add(manifest, seen, YE_MANIFEST_SOUND, json_string_value(json_object_get(audiosource, "src")));
+    }
+
+    json_decref(seen);
+    return manifest;
+}
+
+/*
+    PREFETCHING
+*/
+
+struct ye_prefetch_item {
+    char *path;                     // resolved path
+    enum ye_manifest_kind kind;
+    size_t bytes;                   // bytes actually read
+    SDL_Surface *surface;           // decoded pixels, textures only
+    Mix_Chunk *chunk;               // decoded samples, sounds only
+    uint64_t content_hash;          // hash of the encoded file, textures only
+};
+
+/*
+    Reads a file through once so it is in the OS page cache by the time it is opened for real
+*/
+size_t _ye_prefetch_warm(const char *path){
+    size_t size = 0;
+    const unsigned char *packed = ye_pack_data(path, &size);
+    if(packed != NULL){
+        // fault the mapped pages in
+        volatile unsigned char sink = 0;
+        for(size_t i = 0; i < size; i += 4096)
+            sink ^= packed[i];
+        (void)sink;
+        return size;
+    }
+
+    FILE *file = fopen(path, "rb");
+    if(file == NULL)
+        return 0;
+
+    unsigned char buffer[64 * 1024];
+    size_t read, total = 0;
+    while((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        total += read;
+    fclose(file);
+    return total;
+}
+
+/*
+    Decodes a texture into a surface, preferring its pre-decoded .yetex
+*/
+SDL_Surface * _ye_prefetch_decode(struct ye_prefetch_item *item){
+    struct ye_image_source source;
+    if(!ye_image_source_open(item->path, &source))
+        return NULL;
+
+    item->bytes = source.size;
+    item->content_hash = source.hash;
+    SDL_Surface *surface = ye_image_source_decode(&source);
+    ye_image_source_close(&source);
+    return surface;
+}
+
+/*
+    Decodes a sound into a chunk
+*/
+Mix_Chunk * _ye_prefetch_sound(struct ye_prefetch_item *item){
+    size_t size = 0;
+    const unsigned char *packed = ye_pack_data(item->path, &size);
+    if(packed != NULL){
+        item->bytes = size;
+        return Mix_LoadWAV_RW(SDL_RWFromConstMem(packed, (int)size), 1);
+    }
+
+    struct stat st;
+    if(stat(item->path, &st) != 0)
+        return NULL;
+    item->bytes = (size_t)st.st_size;
+    return Mix_LoadWAV(item->path);
+}
+
+void _ye_prefetch_items(int start, int end, void *data){
+    struct ye_prefetch_item *items = data;
+    for(int i = start; i < end; i++){
+        if(items[i].kind == YE_MANIFEST_TEXTURE)
+            items[i].surface = _ye_prefetch_decode(&items[i]);
+        else if(items[i].kind == YE_MANIFEST_SOUND)
+            items[i].chunk = _ye_prefetch_sound(&items[i]);
+        else
+            items[i].bytes = _ye_prefetch_warm(items[i].path);
+    }
+}
+
+bool ye_prefetch_scene_manifest(json_t *manifest){
+    json_t *version = json_object_get(manifest, "version");
+    if(!json_is_integer(version) || json_integer_value(version) > YE_MANIFEST_VERSION){
+        ye_logf(warning, "%s", "Scene manifest is missing or from a newer engine, skipping prefetch.\n");
+        return false;
+    }
+
+    // collect everything up front, skipping textures we already hold
+    int total = 0;
+    for(int k = 0; k < YE_MANIFEST_KIND_COUNT; k++)
+        total += (int)json_array_size(json_object_get(manifest, manifest_kind_keys[k]));
+
+    struct ye_prefetch_item *items = calloc(total > 0 ? total : 1, sizeof(struct ye_prefetch_item));
+    if(items == NULL){
+        ye_logf(error, "%s", "Failed to allocate scene prefetch list.\n");
+        return false;
+    }
+
+    int count = 0;
+    for(int k = 0; k < YE_MANIFEST_KIND_COUNT; k++){
+        json_t *list = json_object_get(manifest, manifest_kind_keys[k]);
+        for(size_t i = 0; i < json_array_size(list); i++){
+            const char *path = json_string_value(json_object_get(json_array_get(list, i), "path"));
+            if(path == NULL)
+                continue;
+            const char *resolved = ye_get_resource_static(path);
+
+            // nothing to do for textures or sounds we already hold
+            if(k == YE_MANIFEST_TEXTURE && ye_image_is_cached(resolved))
+                continue;
+            if(k == YE_MANIFEST_SOUND && ye_sound_is_cached(resolved))
+                continue;
+
+            items[count].path = strdup(resolved);
+            items[count].kind = (enum ye_manifest_kind)k;
+            count++;
+        }
+    }
+
+    // decoders SDL_image lazily initializes are not safe to initialize from several threads at once
+    IMG_Init(IMG_INIT_PNG | IMG_INIT_JPG);
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    ye_parallel_for(count, 1, _ye_prefetch_items, items);
+    Uint64 read_done = SDL_GetPerformanceCounter();
+
+    // the renderer is only usable from this thread, so uploads happen serially
+    size_t bytes = 0;
+    int textures = 0;
+    for(int i = 0; i < count; i++){
+        bytes += items[i].bytes;
+        if(items[i].surface != NULL){
+            SDL_Texture *texture = SDL_CreateTextureFromSurface(YE_STATE.runtime.renderer, items[i].surface);
+            if(texture != NULL){
+                ye_cache_texture_preloaded(items[i].path, texture, items[i].content_hash);
+                textures++;
+            }
+            SDL_FreeSurface(items[i].surface);
+        }
+        if(items[i].chunk != NULL)
+            ye_cache_sound_preloaded(items[i].path, items[i].chunk);
+        free(items[i].path);
+    }
+    free(items);
+
+    Uint64 end = SDL_GetPerformanceCounter();
+    double frequency = (double)SDL_GetPerformanceFrequency();
+    double read_seconds = (double)(read_done - start) / frequency;
+    double total_ms = (double)(end - start) * 1000.0 / frequency;
+
+    YE_STATE.runtime.scene_prefetch_bytes = bytes;
+    YE_STATE.runtime.scene_prefetch_rate = read_seconds > 0.0 ? (float)(bytes / (1024.0 * 1024.0) / read_seconds) : 0.0f;
+
+    ye_logf(info, "Prefetched %d assets (%d textures, %.2fMB) on %d threads in %.1fms (%.1fMB/s)\n",
+        count, textures, bytes / (1024.0 * 1024.0), ye_worker_count(), total_ms, YE_STATE.runtime.scene_prefetch_rate);
+    return true;
+}
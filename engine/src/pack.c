@@ -0,0 +1,265 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/yoyolick/yoyoengine)
+    Copyright (C) 2023  Ryan Zmuda
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+#include <yoyoengine/yoyoengine.h>
+
+#define YE_PACK_HEADER_SIZE 32
+#define YE_PACK_ENTRY_SIZE 24
+
+/*
+    Index entry, keyed by a pointer straight into the path strings of the mapping
+*/
+struct ye_pack_entry {
+    const char *path;
+    size_t path_length;
+    const unsigned char *data;
+    size_t size;
+    UT_hash_handle hh;
+};
+
+const unsigned char *pack_base = NULL;
+size_t pack_size = 0;
+struct ye_pack_entry *pack_entries = NULL;       // array of every entry
+struct ye_pack_entry *pack_index = NULL;         // uthash head over pack_entries
+char pack_root[1024] = "";                       // normalized game resources path at mount time
+
+#ifdef _WIN32
+HANDLE pack_file_handle = INVALID_HANDLE_VALUE;
+HANDLE pack_mapping_handle = NULL;
+#endif
+
+uint32_t _ye_pack_u32(const unsigned char *p){
+    uint32_t v; memcpy(&v, p, sizeof(v)); return v;
+}
+
+uint64_t _ye_pack_u64(const unsigned char *p){
+    uint64_t v; memcpy(&v, p, sizeof(v)); return v;
+}
+
+/*
+    Turn whatever path we were handed into the key used in the pack:
+    normalized, relative to the game resources folder, no leading /
+*/
+bool _ye_pack_key(const char *path, char *key, size_t size){
+    char normalized[1024];
+    if(!ye_normalize_path(path, normalized, sizeof(normalized)))
+        return false;
+
+    // compared against the root normalized the same way, so "./resources/" and friends still match
+    const char *relative = normalized;
+    size_t root_length = strlen(pack_root);
+    if(root_length > 0 && strncmp(normalized, pack_root, root_length) == 0 && normalized[root_length] == '/')
+        relative += root_length + 1;
+    while(relative[0] == '/')
+        relative++;
+    return snprintf(key, size, "%s", relative) < (int)size;
+}
+
+struct ye_pack_entry * _ye_pack_find(const char *path){
+    if(pack_index == NULL || path == NULL)
+        return NULL;
+
+    char key[1024];
+    if(!_ye_pack_key(path, key, sizeof(key)))
+        return NULL;
+    struct ye_pack_entry *entry = NULL;
+    HASH_FIND(hh, pack_index, key, strlen(key), entry);
+    return entry;
+}
+
+bool _ye_pack_map(const char *pack_path){
+#ifdef _WIN32
+    pack_file_handle = CreateFileA(pack_path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if(pack_file_handle == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    if(!GetFileSizeEx(pack_file_handle, &size) || size.QuadPart == 0){
+        CloseHandle(pack_file_handle);
+        pack_file_handle = INVALID_HANDLE_VALUE;
+        return false;
+    }
+
+    pack_mapping_handle = CreateFileMappingA(pack_file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if(pack_mapping_handle == NULL){
+        CloseHandle(pack_file_handle);
+        pack_file_handle = INVALID_HANDLE_VALUE;
+        return false;
+    }
+
+    pack_base = MapViewOfFile(pack_mapping_handle, FILE_MAP_READ, 0, 0, 0);
+    if(pack_base == NULL){
+        CloseHandle(pack_mapping_handle);
+        CloseHandle(pack_file_handle);
+        pack_mapping_handle = NULL;
+        pack_file_handle = INVALID_HANDLE_VALUE;
+        return false;
+    }
+    pack_size = (size_t)size.QuadPart;
+    return true;
+#else
+    int fd = open(pack_path, O_RDONLY);
+    if(fd == -1)
+        return false;
+
+    struct stat st;
+    if(fstat(fd, &st) == -1 || st.st_size == 0){
+        close(fd);
+        return false;
+    }
+
+    void *mapped = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // the mapping keeps the file alive
+    if(mapped == MAP_FAILED)
+        return false;
+
+    pack_base = mapped;
+    pack_size = (size_t)st.st_size;
+    return true;
+#endif
+}
+
+void _ye_pack_unmap(){
+    if(pack_base == NULL)
+        return;
+#ifdef _WIN32
+    UnmapViewOfFile(pack_base);
+    CloseHandle(pack_mapping_handle);
+    CloseHandle(pack_file_handle);
+    pack_mapping_handle = NULL;
+    pack_file_handle = INVALID_HANDLE_VALUE;
+#else
+    munmap((void*)pack_base, pack_size);
+#endif
+    pack_base = NULL;
+    pack_size = 0;
+}
+
+bool ye_pack_mount(const char *pack_path){
+    ye_pack_unmount();
+
+    if(!_ye_pack_map(pack_path)){
+        ye_logf(error, "Failed to map resource pack: %s\n", pack_path);
+        return false;
+    }
+
+    // validate the header
+    if(pack_size < YE_PACK_HEADER_SIZE || memcmp(pack_base, "YEPK", 4) != 0){
+        ye_logf(error, "%s is not a resource pack.\n", pack_path);
+        _ye_pack_unmap();
+        return false;
+    }
+    uint32_t version = _ye_pack_u32(pack_base + 4);
+    uint32_t count = _ye_pack_u32(pack_base + 8);
+    uint64_t index_offset = _ye_pack_u64(pack_base + 16);
+    uint64_t index_size = _ye_pack_u64(pack_base + 24);
+    if(version != YE_PACK_VERSION){
+        ye_logf(error, "Resource pack %s is version %u, expected %d.\n", pack_path, version, YE_PACK_VERSION);
+        _ye_pack_unmap();
+        return false;
+    }
+    if(index_offset > pack_size || index_size > pack_size - index_offset || (uint64_t)count * YE_PACK_ENTRY_SIZE > index_size){
+        ye_logf(error, "Resource pack %s has a corrupt index.\n", pack_path);
+        _ye_pack_unmap();
+        return false;
+    }
+
+    pack_entries = malloc(sizeof(struct ye_pack_entry) * (count > 0 ? count : 1));
+    if(pack_entries == NULL){
+        ye_logf(error, "Failed to allocate resource pack index.\n");
+        _ye_pack_unmap();
+        return false;
+    }
+
+    const unsigned char *index = pack_base + index_offset;
+    const unsigned char *strings = index + (size_t)count * YE_PACK_ENTRY_SIZE;
+    size_t strings_size = index_size - (size_t)count * YE_PACK_ENTRY_SIZE;
+
+    for(uint32_t i = 0; i < count; i++){
+        const unsigned char *raw = index + (size_t)i * YE_PACK_ENTRY_SIZE;
+        uint64_t offset = _ye_pack_u64(raw);
+        uint64_t size = _ye_pack_u64(raw + 8);
+        uint32_t path_offset = _ye_pack_u32(raw + 16);
+        uint32_t path_length = _ye_pack_u32(raw + 20);
+
+        if(offset > pack_size || size > pack_size - offset || path_offset > strings_size || path_length > strings_size - path_offset){
+            ye_logf(error, "Resource pack %s has a corrupt entry (%u).\n", pack_path, i);
+            ye_pack_unmount();
+            return false;
+        }
+
+        struct ye_pack_entry *entry = &pack_entries[i];
+        entry->path = (const char*)strings + path_offset;
+        entry->path_length = path_length;
+        entry->data = pack_base + offset;
+        entry->size = (size_t)size;
+        HASH_ADD_KEYPTR(hh, pack_index, entry->path, entry->path_length, entry);
+    }
+
+    // keys are made relative to the resources folder the pack was built from
+    if(YE_STATE.engine.game_resources_path == NULL || !ye_normalize_path(YE_STATE.engine.game_resources_path, pack_root, sizeof(pack_root)))
+        pack_root[0] = '\0';
+
+    ye_logf(info, "Mounted resource pack %s (%u files, %zu bytes).\n", pack_path, count, pack_size);
+    return true;
+}
+
+void ye_pack_unmount(){
+    HASH_CLEAR(hh, pack_index);
+    free(pack_entries);
+    pack_entries = NULL;
+    pack_root[0] = '\0';
+    _ye_pack_unmap();
+}
+
+bool ye_pack_contains(const char *path){
+    return _ye_pack_find(path) != NULL;
+}
+
+const void * ye_pack_data(const char *path, size_t *size){
+    struct ye_pack_entry *entry = _ye_pack_find(path);
+    if(entry == NULL)
+        return NULL;
+    if(size != NULL)
+        *size = entry->size;
+    return entry->data;
+}
+
+SDL_RWops * ye_pack_open(const char *path){
+    struct ye_pack_entry *entry = _ye_pack_find(path);
+    if(entry == NULL)
+        return NULL;
+
+    SDL_RWops *rw = SDL_RWFromConstMem(entry->data, (int)entry->size);
+    if(rw == NULL)
+        ye_logf(error, "Failed to open %s from resource pack: %s\n", path, SDL_GetError());
+    return rw;
+}
@@ -0,0 +1,211 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/yoyolick/yoyoengine)
+    Copyright (C) 2023  Ryan Zmuda
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <yoyoengine/yoyoengine.h>
+
+/*
+    Replay file layout:
+
+    header:  "YERP" | uint32 version | uint32 sizeof(SDL_Event)
+    frames:  float delta | (uint8 1 | SDL_Event)* | uint8 0
+
+    Events are written raw, so a recording is only valid for builds
+    of the same SDL version on the same platform (checked via the event size).
+*/
+#define YE_REPLAY_MAGIC "YERP"
+#define YE_REPLAY_VERSION 1
+
+FILE *replay_file = NULL;
+enum ye_replay_mode replay_mode = YE_REPLAY_OFF;
+bool replay_headless = false;
+bool replay_frame_open = false;    // recording: started a frame but havent written its terminator yet
+int replay_frame = 0;
+
+/*
+    Events that carry pointers (or are platform specific) cant be
+    meaningfully written to disk, so we skip them.
+*/
+bool _ye_replay_recordable(SDL_Event *event){
+    switch(event->type){
+        case SDL_DROPFILE:
+        case SDL_DROPTEXT:
+        case SDL_SYSWMEVENT:
+            return false;
+        default:
+            return event->type < SDL_USEREVENT;
+    }
+}
+
+void _ye_replay_finish_playback(){
+    ye_logf(info, "Replay finished after %d frames.\n", replay_frame);
+    ye_replay_stop();
+}
+
+bool ye_replay_start_recording(const char *path){
+    if(replay_mode != YE_REPLAY_OFF){
+        ye_logf(error, "Cannot start recording, a replay is already active.\n");
+        return false;
+    }
+
+    replay_file = fopen(path, "wb");
+    if(replay_file == NULL){
+        ye_logf(error, "Failed to open replay file for writing: %s\n", path);
+        return false;
+    }
+
+    uint32_t version = YE_REPLAY_VERSION;
+    uint32_t event_size = sizeof(SDL_Event);
+    fwrite(YE_REPLAY_MAGIC, 1, 4, replay_file);
+    fwrite(&version, sizeof(version), 1, replay_file);
+    fwrite(&event_size, sizeof(event_size), 1, replay_file);
+
+    replay_mode = YE_REPLAY_RECORDING;
+    replay_frame = 0;
+    replay_frame_open = false;
+    ye_logf(info, "Started recording replay to %s\n", path);
+    return true;
+}
+
+bool ye_replay_start_playback(const char *path, bool headless){
+    if(replay_mode != YE_REPLAY_OFF){
+        ye_logf(error, "Cannot start playback, a replay is already active.\n");
+        return false;
+    }
+
+    replay_file = fopen(path, "rb");
+    if(replay_file == NULL){
+        ye_logf(error, "Failed to open replay file: %s\n", path);
+        return false;
+    }
+
+    char magic[4];
+    uint32_t version = 0, event_size = 0;
+    if(fread(magic, 1, 4, replay_file) != 4 || memcmp(magic, YE_REPLAY_MAGIC, 4) != 0 ||
+       fread(&version, sizeof(version), 1, replay_file) != 1 ||
+       fread(&event_size, sizeof(event_size), 1, replay_file) != 1){
+        ye_logf(error, "%s is not a replay file.\n", path);
+        fclose(replay_file);
+        replay_file = NULL;
+        return false;
+    }
+    if(version != YE_REPLAY_VERSION || event_size != sizeof(SDL_Event)){
+        ye_logf(error, "Replay %s was recorded by an incompatible build (version %u, event size %u).\n", path, version, event_size);
+        fclose(replay_file);
+        replay_file = NULL;
+        return false;
+    }
+
+    replay_mode = YE_REPLAY_PLAYING;
+    replay_headless = headless;
+    replay_frame = 0;
+    ye_logf(info, "Started playing replay %s%s\n", path, headless ? " (headless)" : "");
+    return true;
+}
+
+void ye_replay_stop(){
+    if(replay_file != NULL){
+        // dont leave a frame half written
+        if(replay_mode == YE_REPLAY_RECORDING && replay_frame_open){
+            uint8_t end = 0;
+            fwrite(&end, 1, 1, replay_file);
+        }
+        fclose(replay_file);
+        replay_file = NULL;
+
+        if(replay_mode == YE_REPLAY_RECORDING)
+            ye_logf(info, "Stopped recording replay after %d frames.\n", replay_frame);
+    }
+    replay_mode = YE_REPLAY_OFF;
+    replay_headless = false;
+    replay_frame_open = false;
+}
+
+enum ye_replay_mode ye_replay_get_mode(){
+    return replay_mode;
+}
+
+bool ye_replay_is_headless(){
+    return replay_mode == YE_REPLAY_PLAYING && replay_headless;
+}
+
+float ye_replay_begin_frame(float delta){
+    if(replay_mode == YE_REPLAY_RECORDING){
+        fwrite(&delta, sizeof(delta), 1, replay_file);
+        replay_frame_open = true;
+        replay_frame++;
+    }
+    else if(replay_mode == YE_REPLAY_PLAYING){
+        float recorded;
+        if(fread(&recorded, sizeof(recorded), 1, replay_file) != 1){
+            _ye_replay_finish_playback();
+            return delta;
+        }
+        replay_frame++;
+        return recorded;
+    }
+    return delta;
+}
+
+int ye_replay_poll_event(SDL_Event *event){
+    if(replay_mode == YE_REPLAY_OFF)
+        return SDL_PollEvent(event);
+
+    if(replay_mode == YE_REPLAY_RECORDING){
+        int got = SDL_PollEvent(event);
+        if(got){
+            if(_ye_replay_recordable(event)){
+                uint8_t more = 1;
+                fwrite(&more, 1, 1, replay_file);
+                fwrite(event, sizeof(SDL_Event), 1, replay_file);
+            }
+        }
+        else if(replay_frame_open){
+            uint8_t end = 0;
+            fwrite(&end, 1, 1, replay_file);
+            replay_frame_open = false;
+        }
+        return got;
+    }
+
+    // playing: throw away real input, but still let the user close the window
+    SDL_Event real;
+    while(SDL_PollEvent(&real)){
+        if(real.type == SDL_QUIT){
+            *event = real;
+            return 1;
+        }
+    }
+
+    uint8_t more;
+    if(fread(&more, 1, 1, replay_file) != 1){
+        _ye_replay_finish_playback();
+        return 0;
+    }
+    if(more == 0)
+        return 0;
+
+    if(fread(event, sizeof(SDL_Event), 1, replay_file) != 1){
+        _ye_replay_finish_playback();
+        return 0;
+    }
+    return 1;
+}
@@ -145,11 +145,8 @@ void ye_construct_renderer(struct ye_entity* e, json_t* renderer, const char* en
                 return;
             }
 
-            // hack to preserve original not full path to src for serialization.. TODO: FIXME this will cause an issue in like 3 months i bet
-            ye_temp_add_image_renderer_component(e,z,ye_get_resource_static(src));
-            free(e->renderer->renderer_impl.image->src); // free the old src
-            e->renderer->renderer_impl.image->src = malloc(strlen(src)+1); // malloc new src
-            strcpy(e->renderer->renderer_impl.image->src,src); // copy over the new src
+            // the texture cache resolves paths relative to resources itself, so src stays as written for serialization
+            ye_temp_add_image_renderer_component(e,z,src);
             break;
         case YE_RENDERER_TYPE_TEXT:
             // get the text field
@@ -355,6 +352,16 @@ void ye_construct_physics(struct ye_entity* e, json_t* physics, const char* enti
         e->physics->rotational_velocity = rotational_velocity;
     }
 
+    // get collision response
+    if(ye_json_has_key(physics,"restitution")){
+        float restitution = 0;    ye_json_float(physics,"restitution",&restitution);
+        e->physics->restitution = restitution;
+    }
+    if(ye_json_has_key(physics,"friction")){
+        float friction = 0;    ye_json_float(physics,"friction",&friction);
+        e->physics->friction = friction;
+    }
+
     // update active state
     if(ye_json_has_key(physics,"active")){
         bool active = true;    ye_json_bool(physics,"active",&active);
@@ -416,6 +423,51 @@ void ye_construct_collider(struct ye_entity* e, json_t* collider, const char* en
     }
 }
 
+void ye_construct_audiosource(struct ye_entity* e, json_t* audiosource, const char* entity_name){
+    // validate src field
+    const char *src = NULL;
+    if(!ye_json_string(audiosource,"src",&src)) {
+        ye_logf(warning,"Entity %s has an audiosource component, but it is missing the src field\n", entity_name);
+        return;
+    }
+
+    int loops = 0;
+    if(ye_json_has_key(audiosource,"loops"))
+        ye_json_int(audiosource,"loops",&loops);
+
+    // the sound cache resolves paths relative to resources itself, so src stays as written for serialization
+    ye_add_audiosource_component(e,src,loops);
+
+    // everything else is optional and keeps its default if missing
+    if(ye_json_has_key(audiosource,"volume"))
+        ye_json_int(audiosource,"volume",&e->audiosource->volume);
+    if(ye_json_has_key(audiosource,"priority"))
+        ye_json_int(audiosource,"priority",&e->audiosource->priority);
+    if(ye_json_has_key(audiosource,"range")){
+        // written as an int or a float
+        json_t *range = json_object_get(audiosource,"range");
+        if(json_is_number(range))
+            e->audiosource->range = (float)json_number_value(range);
+    }
+    if(ye_json_has_key(audiosource,"relative"))
+        ye_json_bool(audiosource,"relative",&e->audiosource->relative);
+    if(ye_json_has_key(audiosource,"position"))
+        e->audiosource->rect = ye_retrieve_position(audiosource);
+
+    // update active state
+    if(ye_json_has_key(audiosource,"active")){
+        bool active = true;    ye_json_bool(audiosource,"active",&active);
+        e->audiosource->active = active;
+    }
+
+    // start it with the scene
+    bool playing = false;
+    if(ye_json_has_key(audiosource,"playing"))
+        ye_json_bool(audiosource,"playing",&playing);
+    if(playing)
+        ye_play_audiosource(e);
+}
+
 /*
     ===================================================================
     ===================================================================
@@ -506,10 +558,22 @@ void ye_construct_scene(json_t *entities){
             }
             ye_construct_collider(e,collider,entity_name);
         }
+
+        // if we have an audiosource component on our entity
+        if(ye_json_has_key(components,"audiosource")){
+            json_t *audiosource = NULL; ye_json_object(components,"audiosource",&audiosource);
+            if(audiosource == NULL){
+                ye_logf(warning,"Entity %s has an audiosource field, but it's invalid.\n", entity_name);
+                continue;
+            }
+            ye_construct_audiosource(e,audiosource,entity_name);
+        }
     }
 }
 
 void ye_load_scene(const char *scene_path){
+    Uint32 load_start = SDL_GetTicks();
+
     // wipe the ecs so its ready to be populated (this will destroy and re-create editor entities, but the editor will best effort recreate and attach them)
     ye_purge_ecs();
 
@@ -553,7 +617,11 @@ void ye_load_scene(const char *scene_path){
         ye_logf(info,"Loaded scene: %s\n", scene_name);
     }
 
-    // pre cache all of its colors, fonts (TODO: thread this?)
+    // if the editor left us a manifest, read and decode everything the scene needs in parallel first
+    json_t *manifest = json_object_get(SCENE, "manifest");
+    bool prefetched = manifest != NULL && ye_prefetch_scene_manifest(manifest);
+
+    // pre cache all of its colors, fonts
     json_t *styles; ye_json_array(SCENE, "styles", &styles);
     // cache each styles file in array
     for(int i = 0; i < json_array_size(styles); i++){
@@ -561,9 +629,10 @@ void ye_load_scene(const char *scene_path){
         ye_pre_cache_styles(ye_get_resource_static(path));
     }
 
-    // pre cache all of a scenes assets (TODO: thread this?)
+    // pre cache all of a scenes assets (the manifest already covered them if we had one)
     json_t *scene = NULL; ye_json_object(SCENE, "scene", &scene);
-    ye_pre_cache_scene(scene); // lowercase scene is the actual key
+    if(!prefetched)
+        ye_pre_cache_scene(scene); // lowercase scene is the actual key
 
     // construct all entities and components
     json_t *entities = NULL;
@@ -576,6 +645,9 @@ void ye_load_scene(const char *scene_path){
     // construct scene
     ye_construct_scene(entities);
 
+    YE_STATE.runtime.scene_ready_time = SDL_GetTicks() - load_start;
+    ye_logf(info,"Scene ready in %dms\n", YE_STATE.runtime.scene_ready_time);
+
     // check if the scene has a default camera and set it if so, if not log error
     const char* default_camera_name = NULL;
     if(!ye_json_string(scene,"default camera",&default_camera_name)){
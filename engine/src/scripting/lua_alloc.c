@@ -0,0 +1,391 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/yoyolick/yoyoengine)
+    Copyright (C) 2023  Ryan Zmuda
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+    Allocator shared by every lua state.
+
+    Small blocks come out of per size class free lists carved from 64KB slabs, so the constant churn of
+    small tables, strings and closures scripts produce never reaches the system heap. Anything bigger
+    than the largest class goes to malloc. Every block starts with a small header recording which owner
+    (script) it is charged to and its size class, so a block is always credited back to the script that
+    allocated it, even when it is freed by the collector while another script is running.
+
+    Lua states are only ever touched from the main thread, so none of this is locked.
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <yoyoengine/yoyoengine.h>
+
+/*
+    Lua only needs blocks aligned for its largest scalar (8 bytes), which this header keeps
+*/
+struct ye_lua_block {
+    uint32_t owner;
+    uint32_t size_class;
+};
+
+#define YE_LUA_ALLOC_LARGE UINT32_MAX  // size_class of blocks that came from malloc
+
+#define YE_LUA_SLAB_SIZE (64 * 1024)
+
+// payload sizes of each class
+const size_t ye_lua_size_classes[] = {8, 16, 24, 32, 48, 64, 96, 128, 192, 256, 384, 512};
+#define YE_LUA_SIZE_CLASS_COUNT ((int)(sizeof(ye_lua_size_classes) / sizeof(ye_lua_size_classes[0])))
+#define YE_LUA_MAX_POOLED 512
+
+struct ye_lua_free_block {
+    struct ye_lua_free_block *next;
+};
+
+struct ye_lua_pool {
+    struct ye_lua_free_block *free_list;
+    char *bump;         // unused tail of the newest slab for this class
+    char *bump_end;
+};
+
+struct ye_lua_slab {
+    struct ye_lua_slab *next;
+};
+
+struct ye_lua_pool lua_pools[YE_LUA_SIZE_CLASS_COUNT];
+struct ye_lua_slab *lua_slabs = NULL;
+
+// size (in 8 byte steps) -> class, filled in the first time anything is allocated
+uint8_t lua_class_lookup[YE_LUA_MAX_POOLED / 8 + 1];
+bool lua_class_lookup_ready = false;
+
+/*
+    Owners. 0 is the engine itself (the shared state and its libraries).
+*/
+struct ye_lua_memory_owner {
+    size_t bytes;       // bytes currently charged to it
+    size_t peak;
+    size_t limit;       // 0 for no limit
+    bool over_limit;    // an allocation was refused because of the limit
+    bool retired;       // its script is gone, recycled once the last of its blocks is freed
+    uint32_t next_free;
+};
+
+struct ye_lua_memory_owner *lua_memory_owners = NULL;
+uint32_t lua_memory_owner_count = 0;
+uint32_t lua_memory_owner_capacity = 0;
+uint32_t lua_memory_owner_free = 0;        // head of the recycled owner list, 0 if empty
+uint32_t lua_alloc_current_owner = 0;
+
+// counted over the current frame, published by ye_lua_alloc_publish_stats
+int lua_allocations = 0;
+size_t lua_pool_bytes = 0;
+
+void _ye_lua_build_class_lookup(){
+    int size_class = 0;
+    for(int i = 0; i <= YE_LUA_MAX_POOLED / 8; i++){
+        while(ye_lua_size_classes[size_class] < (size_t)i * 8)
+            size_class++;
+        lua_class_lookup[i] = (uint8_t)size_class;
+    }
+    lua_class_lookup_ready = true;
+}
+
+uint32_t _ye_lua_class_of(size_t size){
+    if(size > YE_LUA_MAX_POOLED)
+        return YE_LUA_ALLOC_LARGE;
+    if(!lua_class_lookup_ready)
+        _ye_lua_build_class_lookup();
+    return lua_class_lookup[(size + 7) / 8];
+}
+
+bool _ye_lua_reserve_owners(uint32_t needed);
+
+/*
+    Owner 0 (the engine) always exists once anything has been allocated
+*/
+bool _ye_lua_init_owners(){
+    if(lua_memory_owner_count > 0)
+        return true;
+    if(!_ye_lua_reserve_owners(1))
+        return false;
+    lua_memory_owners[0] = (struct ye_lua_memory_owner){0};
+    lua_memory_owner_count = 1;
+    return true;
+}
+
+struct ye_lua_memory_owner * _ye_lua_owner(uint32_t owner){
+    if(owner >= lua_memory_owner_count)
+        return &lua_memory_owners[0];
+    return &lua_memory_owners[owner];
+}
+
+bool _ye_lua_reserve_owners(uint32_t needed){
+    if(needed <= lua_memory_owner_capacity)
+        return true;
+
+    uint32_t capacity = lua_memory_owner_capacity > 0 ? lua_memory_owner_capacity : 64;
+    while(capacity < needed)
+        capacity *= 2;
+    struct ye_lua_memory_owner *owners = realloc(lua_memory_owners, capacity * sizeof(struct ye_lua_memory_owner));
+    if(owners == NULL)
+        return false;
+    lua_memory_owners = owners;
+    lua_memory_owner_capacity = capacity;
+    return true;
+}
+
+void _ye_lua_charge(uint32_t owner, size_t bytes){
+    struct ye_lua_memory_owner *record = _ye_lua_owner(owner);
+    record->bytes += bytes;
+    if(record->bytes > record->peak)
+        record->peak = record->bytes;
+}
+
+void _ye_lua_credit(uint32_t owner, size_t bytes){
+    struct ye_lua_memory_owner *record = _ye_lua_owner(owner);
+    record->bytes -= bytes < record->bytes ? bytes : record->bytes;
+
+    // the last block of a removed script, its id can be reused now
+    if(record->retired && record->bytes == 0 && owner != 0){
+        record->retired = false;
+        record->next_free = lua_memory_owner_free;
+        lua_memory_owner_free = owner;
+    }
+}
+
+/*
+    A block kept its owner but changed size. Only the difference is applied: crediting osize first
+    could take a retired owner whose last bytes are in this block to zero and recycle its id while
+    the block is still alive.
+*/
+void _ye_lua_resize(uint32_t owner, size_t osize, size_t nsize){
+    if(nsize >= osize)
+        _ye_lua_charge(owner, nsize - osize);
+    else
+        _ye_lua_credit(owner, osize - nsize);
+}
+
+/*
+    Whether an owner may grow by bytes, flagging it if not
+*/
+bool _ye_lua_within_limit(uint32_t owner, size_t bytes){
+    struct ye_lua_memory_owner *record = _ye_lua_owner(owner);
+    if(record->limit == 0 || record->bytes + bytes <= record->limit)
+        return true;
+
+    if(!record->over_limit)
+        ye_logf(warning,"Lua script hit its memory limit (%zuKB), refusing to allocate more.\n", record->limit / 1024);
+    record->over_limit = true;
+    return false;
+}
+
+void * _ye_lua_pool_alloc(uint32_t size_class){
+    struct ye_lua_pool *pool = &lua_pools[size_class];
+
+    if(pool->free_list != NULL){
+        struct ye_lua_free_block *block = pool->free_list;
+        pool->free_list = block->next;
+        return block;
+    }
+
+    size_t block_size = sizeof(struct ye_lua_block) + ye_lua_size_classes[size_class];
+    if(pool->bump == NULL || pool->bump + block_size > pool->bump_end){
+        struct ye_lua_slab *slab = malloc(YE_LUA_SLAB_SIZE);
+        if(slab == NULL)
+            return NULL;
+        slab->next = lua_slabs;
+        lua_slabs = slab;
+        lua_pool_bytes += YE_LUA_SLAB_SIZE;
+
+        // blocks start 8 byte aligned after the slab link
+        pool->bump = (char*)slab + sizeof(struct ye_lua_slab);
+        pool->bump_end = (char*)slab + YE_LUA_SLAB_SIZE;
+    }
+
+    void *block = pool->bump;
+    pool->bump += block_size;
+    return block;
+}
+
+void _ye_lua_pool_free(struct ye_lua_block *block){
+    struct ye_lua_free_block *free_block = (struct ye_lua_free_block*)block;
+    free_block->next = lua_pools[block->size_class].free_list;
+    lua_pools[block->size_class].free_list = free_block;
+}
+
+/*
+    A new block of nsize bytes charged to owner, NULL if it is over its limit (when checked) or we are out of memory
+*/
+void * _ye_lua_block_alloc(uint32_t owner, size_t nsize, bool check_limit){
+    if(check_limit && !_ye_lua_within_limit(owner, nsize))
+        return NULL;
+
+    uint32_t size_class = _ye_lua_class_of(nsize);
+    struct ye_lua_block *block = size_class == YE_LUA_ALLOC_LARGE
+        ? malloc(sizeof(struct ye_lua_block) + nsize)
+        : _ye_lua_pool_alloc(size_class);
+    if(block == NULL)
+        return NULL;
+
+    block->owner = owner;
+    block->size_class = size_class;
+    _ye_lua_charge(owner, nsize);
+    lua_allocations++;
+    return block + 1;
+}
+
+void _ye_lua_block_free(struct ye_lua_block *block, size_t osize){
+    _ye_lua_credit(block->owner, osize);
+    if(block->size_class == YE_LUA_ALLOC_LARGE)
+        free(block);
+    else
+        _ye_lua_pool_free(block);
+}
+
+void * ye_lua_alloc(void *ud, void *ptr, size_t osize, size_t nsize){
+    (void)ud;
+
+    if(!_ye_lua_init_owners())
+        return NULL;
+
+    // new block (osize is a type tag here, not a size)
+    if(ptr == NULL)
+        return nsize == 0 ? NULL : _ye_lua_block_alloc(lua_alloc_current_owner, nsize, true);
+
+    struct ye_lua_block *block = (struct ye_lua_block*)ptr - 1;
+
+    if(nsize == 0){
+        _ye_lua_block_free(block, osize);
+        return NULL;
+    }
+
+    // lua assumes shrinking never fails, so limits only apply to growth
+    if(nsize > osize && !_ye_lua_within_limit(block->owner, nsize - osize))
+        return NULL;
+
+    uint32_t size_class = _ye_lua_class_of(nsize);
+
+    // still fits the block it is in
+    if(size_class != YE_LUA_ALLOC_LARGE && size_class == block->size_class){
+        _ye_lua_resize(block->owner, osize, nsize);
+        return ptr;
+    }
+
+    if(size_class == YE_LUA_ALLOC_LARGE && block->size_class == YE_LUA_ALLOC_LARGE){
+        struct ye_lua_block *grown = realloc(block, sizeof(struct ye_lua_block) + nsize);
+        if(grown == NULL)
+            return NULL;
+        _ye_lua_resize(grown->owner, osize, nsize);
+        return grown + 1;
+    }
+
+    // moving between classes (or in or out of the pools), the block stays with its owner (growth was checked above)
+    uint32_t owner = block->owner;
+    lua_allocations--;  // a move, not a new allocation
+    void *moved = _ye_lua_block_alloc(owner, nsize, false);
+    if(moved == NULL){
+        lua_allocations++;
+        return NULL;
+    }
+    memcpy(moved, ptr, osize < nsize ? osize : nsize);
+    _ye_lua_block_free(block, osize);
+    return moved;
+}
+
+/*
+    OWNERS
+*/
+
+uint32_t ye_lua_memory_owner_create(size_t limit){
+    if(!_ye_lua_init_owners())
+        return 0;
+
+    uint32_t owner = lua_memory_owner_free;
+    if(owner != 0){
+        lua_memory_owner_free = lua_memory_owners[owner].next_free;
+    }
+    else{
+        if(!_ye_lua_reserve_owners(lua_memory_owner_count + 1))
+            return 0; // charge it to the engine rather than fail
+        owner = lua_memory_owner_count++;
+    }
+
+    lua_memory_owners[owner] = (struct ye_lua_memory_owner){0};
+    lua_memory_owners[owner].limit = limit;
+    return owner;
+}
+
+void ye_lua_memory_owner_release(uint32_t owner){
+    if(owner == 0 || owner >= lua_memory_owner_count)
+        return;
+
+    struct ye_lua_memory_owner *record = &lua_memory_owners[owner];
+
+    // blocks still charged to it (held by other scripts, or not collected yet) keep it from being reused
+    record->retired = true;
+    record->limit = 0;
+    if(record->bytes == 0)
+        _ye_lua_credit(owner, 0);
+}
+
+uint32_t ye_lua_memory_owner_swap(uint32_t owner){
+    uint32_t previous = lua_alloc_current_owner;
+    lua_alloc_current_owner = owner;
+    return previous;
+}
+
+size_t ye_lua_memory_owner_usage(uint32_t owner){
+    if(lua_memory_owner_count == 0)
+        return 0;
+    return _ye_lua_owner(owner)->bytes;
+}
+
+void ye_lua_memory_owner_set_limit(uint32_t owner, size_t limit){
+    if(owner == 0 || owner >= lua_memory_owner_count)
+        return;
+    lua_memory_owners[owner].limit = limit;
+    lua_memory_owners[owner].over_limit = false;
+}
+
+bool ye_lua_memory_owner_over_limit(uint32_t owner){
+    if(lua_memory_owner_count == 0)
+        return false;
+    return _ye_lua_owner(owner)->over_limit;
+}
+
+void ye_lua_alloc_publish_stats(){
+    YE_STATE.runtime.lua_allocations = lua_allocations;
+    YE_STATE.runtime.lua_pool_bytes = lua_pool_bytes;
+    lua_allocations = 0;
+}
+
+void ye_lua_alloc_shutdown(){
+    while(lua_slabs != NULL){
+        struct ye_lua_slab *next = lua_slabs->next;
+        free(lua_slabs);
+        lua_slabs = next;
+    }
+    memset(lua_pools, 0, sizeof(lua_pools));
+    lua_pool_bytes = 0;
+
+    free(lua_memory_owners);
+    lua_memory_owners = NULL;
+    lua_memory_owner_count = 0;
+    lua_memory_owner_capacity = 0;
+    lua_memory_owner_free = 0;
+    lua_alloc_current_owner = 0;
+}
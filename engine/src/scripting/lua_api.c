@@ -83,4 +83,10 @@ void ye_register_lua_scripting_api(lua_State *state){
 
     // register this lua log function
     lua_register(state, "ye_log", lua_log);
+
+    // entities and their components (lua_api_ecs.c)
+    ye_register_lua_ecs_api(state);
+
+    // waiting and events (lua_api_coroutines.c)
+    ye_register_lua_coroutine_api(state);
 }
\ No newline at end of file
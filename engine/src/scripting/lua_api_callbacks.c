@@ -18,7 +18,12 @@
 
 #include <yoyoengine/yoyoengine.h>
 
-bool ye_run_lua_callback(struct ye_component_lua_script *script, int callback_ref, const char *callback_name) {
+/*
+    Calls a function the script defined through its registry reference (resolved once when the script
+    was loaded), so nothing is looked up by name per call. Every callback gets the entity the script is
+    attached to, on_update also gets the delta time.
+*/
+bool ye_run_lua_callback(struct ye_component_lua_script *script, int callback_ref, const char *callback_name, bool pass_delta) {
     lua_State *L = script->state;
 
     if (callback_ref != LUA_NOREF) {
@@ -30,10 +35,30 @@ bool ye_run_lua_callback(struct ye_component_lua_script *script, int callback_re
             return false;
         }
 
-        if (lua_pcall(L, 0, 0, 0) != LUA_OK) {
+        int nargs = 1;
+        ye_lua_push_entity(L, script->entity);
+        if(pass_delta){
+            lua_pushnumber(L, YE_STATE.runtime.delta_time);
+            nargs++;
+        }
+
+        struct ye_component_lua_script *previous_script = lua_running_script;
+        lua_running_script = script;
+        uint32_t previous_owner = ye_lua_memory_owner_swap(script->memory_owner);
+        int status = lua_pcall(L, nargs, 0, 0);
+        ye_lua_memory_owner_swap(previous_owner);
+        lua_running_script = previous_script;
+
+        if (status != LUA_OK) {
             const char *e = lua_tostring(L, -1);
             ye_logf(error,"Error running %s function: %s\n", callback_name, e);
             lua_pop(L, 1);
+
+            // a runaway script would just hit its limit again every frame
+            if(status == LUA_ERRMEM && ye_lua_memory_owner_over_limit(script->memory_owner)){
+                ye_logf(error,"Lua script %s on entity %s exceeded its memory limit and was disabled.\n", script->script_path, script->entity->name);
+                script->active = false;
+            }
             return false;
         }
 
@@ -44,43 +69,12 @@ bool ye_run_lua_callback(struct ye_component_lua_script *script, int callback_re
     }
 }
 
-#define LUA_END_ARGS -2
-
-int callLuaFunction(lua_State* L, const char* functionName, ...) {
-    va_list args;
-    int nargs = 0;
-
-    lua_getglobal(L, functionName); // Get the function by name
-
-    // Push arguments onto the Lua stack
-    va_start(args, functionName);
-    while (va_arg(args, int) != LUA_END_ARGS) {
-        nargs++;
-        switch (va_arg(args, int)) {
-            case LUA_TSTRING:
-                lua_pushstring(L, va_arg(args, const char*));
-                break;
-            case LUA_TNUMBER:
-                lua_pushnumber(L, va_arg(args, double));
-                break;
-            // Handle other types as needed
-        }
-    }
-    va_end(args);
-
-    // Make the function call with nargs arguments
-    if (lua_pcall(L, nargs, 0, 0) != LUA_OK) {
-        fprintf(stderr, "Error calling function: %s\n", lua_tostring(L, -1));
-        lua_pop(L, 1); // Pop the error message
-        return -1;
-    }
-
-    return 0;
-}
-
+/*
+    on_mount runs as a task, so it can wait
+*/
 void ye_run_lua_on_mount(struct ye_component_lua_script *script) {
-    if(script->has_on_mount) {
-        callLuaFunction(script->state, "on_mount", LUA_END_ARGS);
+    if(script->on_mount_ref != LUA_NOREF) {
+        ye_lua_start_callback_task(script, script->on_mount_ref);
     }
 }
 
@@ -90,13 +84,13 @@ void ye_run_lua_on_unmount(struct ye_component_lua_script *script) {
         return;
     }
     
-    if(script->has_on_unmount) {
-        callLuaFunction(script->state, "on_unmount", LUA_END_ARGS);
+    if(script->on_unmount_ref != LUA_NOREF) {
+        ye_run_lua_callback(script, script->on_unmount_ref, "on_unmount", false);
     }
 }
 
 void ye_run_lua_on_update(struct ye_component_lua_script *script) {
-    if(script->has_on_update) {
-        callLuaFunction(script->state, "on_update", LUA_END_ARGS);
+    if(script->on_update_ref != LUA_NOREF) {
+        ye_run_lua_callback(script, script->on_update_ref, "on_update", true);
     }
-}
\ No newline at end of file
+}
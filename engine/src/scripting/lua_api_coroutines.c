@@ -0,0 +1,549 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/yoyolick/yoyoengine)
+    Copyright (C) 2023  Ryan Zmuda
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+    Coroutine scheduling for lua scripts
+
+    on_mount and anything started with ye_start_task run as coroutines, which can suspend themselves with
+    wait(seconds), wait_frames(n) or wait_event(name). A suspended task sits in one of three places until
+    its wake condition fires:
+
+    - a min heap ordered by the time it wakes up at (wait)
+    - a min heap ordered by the frame it wakes up on (wait_frames)
+    - a list per event name (wait_event), moved to the ready list when the event fires
+
+    Each frame the scheduler only pops what is due off the top of the heaps and drains the ready list,
+    so a script that is waiting costs nothing until it wakes.
+*/
+
+#include <yoyoengine/yoyoengine.h>
+
+enum ye_lua_wait {
+    YE_LUA_WAIT_NONE,
+    YE_LUA_WAIT_TIME,
+    YE_LUA_WAIT_FRAMES,
+    YE_LUA_WAIT_EVENT,
+    YE_LUA_WAIT_READY,
+};
+
+struct ye_lua_task_heap {
+    struct ye_lua_task **tasks;
+    int count;
+    int capacity;
+};
+
+struct ye_lua_event_waiters {
+    char *name;
+    struct ye_lua_task *head;
+    struct ye_lua_task *tail;
+    UT_hash_handle hh;
+};
+
+struct ye_lua_task {
+    lua_State *thread;
+    lua_State *state;                       // the state the thread lives in (its registry holds thread_ref)
+    int thread_ref;
+    struct ye_component_lua_script *script; // NULL once cancelled
+
+    enum ye_lua_wait wait;
+    double wake;                            // seconds or frame number to wake at
+    uint64_t sequence;                      // keeps tasks that wake together in the order they waited
+    uint64_t queued_frame;                  // the frame it started waiting on
+    int heap_index;
+    struct ye_lua_event_waiters *event;
+
+    bool running;
+
+    struct ye_lua_task *prev;               // in its event or the ready list
+    struct ye_lua_task *next;
+    struct ye_lua_task *script_prev;        // in its scripts task list
+    struct ye_lua_task *script_next;
+};
+
+struct ye_lua_task_heap lua_time_waiters = {0};
+struct ye_lua_task_heap lua_frame_waiters = {0};
+struct ye_lua_event_waiters *lua_event_waiters = NULL;
+struct ye_lua_event_waiters lua_ready_tasks = {0};
+
+double lua_scheduler_time = 0.0;
+uint64_t lua_scheduler_frame = 0;
+uint64_t lua_scheduler_sequence = 0;
+int lua_scheduler_resumes = 0;
+int lua_task_count = 0;
+
+struct ye_component_lua_script *lua_running_script = NULL;
+
+/*
+    HEAPS
+*/
+
+bool _ye_lua_task_before(struct ye_lua_task *a, struct ye_lua_task *b){
+    if(a->wake != b->wake)
+        return a->wake < b->wake;
+    return a->sequence < b->sequence;
+}
+
+void _ye_lua_heap_place(struct ye_lua_task_heap *heap, int index, struct ye_lua_task *task){
+    heap->tasks[index] = task;
+    task->heap_index = index;
+}
+
+void _ye_lua_heap_sift_up(struct ye_lua_task_heap *heap, int index){
+    struct ye_lua_task *task = heap->tasks[index];
+    while(index > 0){
+        int parent = (index - 1) / 2;
+        if(!_ye_lua_task_before(task, heap->tasks[parent]))
+            break;
+        _ye_lua_heap_place(heap, index, heap->tasks[parent]);
+        index = parent;
+    }
+    _ye_lua_heap_place(heap, index, task);
+}
+
+void _ye_lua_heap_sift_down(struct ye_lua_task_heap *heap, int index){
+    struct ye_lua_task *task = heap->tasks[index];
+    while(true){
+        int child = index * 2 + 1;
+        if(child >= heap->count)
+            break;
+        if(child + 1 < heap->count && _ye_lua_task_before(heap->tasks[child + 1], heap->tasks[child]))
+            child++;
+        if(!_ye_lua_task_before(heap->tasks[child], task))
+            break;
+        _ye_lua_heap_place(heap, index, heap->tasks[child]);
+        index = child;
+    }
+    _ye_lua_heap_place(heap, index, task);
+}
+
+bool _ye_lua_heap_push(struct ye_lua_task_heap *heap, struct ye_lua_task *task){
+    if(heap->count == heap->capacity){
+        int capacity = heap->capacity > 0 ? heap->capacity * 2 : 64;
+        struct ye_lua_task **tasks = realloc(heap->tasks, capacity * sizeof(struct ye_lua_task*));
+        if(tasks == NULL)
+            return false;
+        heap->tasks = tasks;
+        heap->capacity = capacity;
+    }
+    heap->tasks[heap->count++] = task;
+    _ye_lua_heap_sift_up(heap, heap->count - 1);
+    return true;
+}
+
+void _ye_lua_heap_remove(struct ye_lua_task_heap *heap, int index){
+    heap->tasks[index]->heap_index = -1;
+    heap->count--;
+    if(index == heap->count)
+        return;
+
+    // the last task fills the hole, then moves whichever way it needs to
+    struct ye_lua_task *moved = heap->tasks[heap->count];
+    _ye_lua_heap_place(heap, index, moved);
+    _ye_lua_heap_sift_down(heap, index);
+    _ye_lua_heap_sift_up(heap, moved->heap_index);
+}
+
+/*
+    WAITER LISTS
+*/
+
+void _ye_lua_list_append(struct ye_lua_event_waiters *list, struct ye_lua_task *task){
+    task->prev = list->tail;
+    task->next = NULL;
+    if(list->tail != NULL)
+        list->tail->next = task;
+    else
+        list->head = task;
+    list->tail = task;
+}
+
+void _ye_lua_list_remove(struct ye_lua_event_waiters *list, struct ye_lua_task *task){
+    if(task->prev != NULL)
+        task->prev->next = task->next;
+    else
+        list->head = task->next;
+    if(task->next != NULL)
+        task->next->prev = task->prev;
+    else
+        list->tail = task->prev;
+    task->prev = task->next = NULL;
+}
+
+/*
+    Takes a task out of whatever it is waiting in
+*/
+void _ye_lua_task_unqueue(struct ye_lua_task *task){
+    switch(task->wait){
+        case YE_LUA_WAIT_TIME:
+            _ye_lua_heap_remove(&lua_time_waiters, task->heap_index);
+            break;
+        case YE_LUA_WAIT_FRAMES:
+            _ye_lua_heap_remove(&lua_frame_waiters, task->heap_index);
+            break;
+        case YE_LUA_WAIT_EVENT:
+            _ye_lua_list_remove(task->event, task);
+            break;
+        case YE_LUA_WAIT_READY:
+            _ye_lua_list_remove(&lua_ready_tasks, task);
+            break;
+        default:
+            break;
+    }
+    task->wait = YE_LUA_WAIT_NONE;
+}
+
+/*
+    Puts a task that just yielded where its wait call asked for
+*/
+void _ye_lua_task_queue(struct ye_lua_task *task){
+    task->sequence = lua_scheduler_sequence++;
+    task->queued_frame = lua_scheduler_frame;
+
+    switch(task->wait){
+        case YE_LUA_WAIT_TIME:
+            if(_ye_lua_heap_push(&lua_time_waiters, task))
+                return;
+            break;
+        case YE_LUA_WAIT_FRAMES:
+            if(_ye_lua_heap_push(&lua_frame_waiters, task))
+                return;
+            break;
+        case YE_LUA_WAIT_EVENT:
+            _ye_lua_list_append(task->event, task);
+            return;
+        default:
+            break;
+    }
+
+    // a bare coroutine.yield (or nowhere to put it), pick it back up next frame
+    task->event = NULL;
+    task->wait = YE_LUA_WAIT_READY;
+    _ye_lua_list_append(&lua_ready_tasks, task);
+}
+
+/*
+    TASKS
+*/
+
+void _ye_lua_task_free(struct ye_lua_task *task){
+    luaL_unref(task->state, LUA_REGISTRYINDEX, task->thread_ref);
+    free(task);
+    lua_task_count--;
+}
+
+void _ye_lua_task_detach(struct ye_lua_task *task){
+    struct ye_component_lua_script *script = task->script;
+    if(task->script_prev != NULL)
+        task->script_prev->script_next = task->script_next;
+    else
+        script->tasks = task->script_next;
+    if(task->script_next != NULL)
+        task->script_next->script_prev = task->script_prev;
+    task->script = NULL;
+}
+
+/*
+    Runs a task until it waits, finishes or errors. nargs values must already be on its thread.
+*/
+void _ye_lua_task_resume(struct ye_lua_task *task, int nargs){
+    struct ye_component_lua_script *script = task->script;
+    lua_State *thread = task->thread;
+
+    struct ye_component_lua_script *previous_script = lua_running_script;
+    lua_running_script = script;
+    uint32_t previous_owner = ye_lua_memory_owner_swap(script->memory_owner);
+
+    task->wait = YE_LUA_WAIT_NONE;
+    task->running = true;
+    int nresults = 0;
+    int status = lua_resume(thread, NULL, nargs, &nresults);
+    task->running = false;
+
+    ye_lua_memory_owner_swap(previous_owner);
+    lua_running_script = previous_script;
+    lua_scheduler_resumes++;
+
+    // the script was removed while the task was running
+    if(task->script == NULL){
+        _ye_lua_task_free(task);
+        return;
+    }
+
+    if(status == LUA_YIELD){
+        lua_pop(thread, nresults);
+        _ye_lua_task_queue(task);
+        return;
+    }
+
+    if(status != LUA_OK){
+        luaL_traceback(task->state, thread, lua_tostring(thread, -1), 0);
+        ye_logf(error,"Error in lua task of %s: %s\n", script->script_path, lua_tostring(task->state, -1));
+        lua_pop(task->state, 1);
+
+        if(status == LUA_ERRMEM && ye_lua_memory_owner_over_limit(script->memory_owner)){
+            ye_logf(error,"Lua script %s on entity %s exceeded its memory limit and was disabled.\n", script->script_path, script->entity->name);
+            script->active = false;
+        }
+    }
+
+    _ye_lua_task_detach(task);
+    _ye_lua_task_free(task);
+}
+
+/*
+    Creates a task for script around the function on top of L (popping it). L is the scripts
+    state or one of its threads, they all share a registry.
+*/
+struct ye_lua_task * _ye_lua_task_create(struct ye_component_lua_script *script, lua_State *L){
+    struct ye_lua_task *task = calloc(1, sizeof(struct ye_lua_task));
+    if(task == NULL){
+        lua_pop(L, 1);
+        return NULL;
+    }
+
+    uint32_t previous_owner = ye_lua_memory_owner_swap(script->memory_owner);
+    task->thread = lua_newthread(L);
+    ye_lua_memory_owner_swap(previous_owner);
+
+    // anchor the thread and move the function onto it
+    lua_insert(L, -2);
+    lua_xmove(L, task->thread, 1);
+    task->thread_ref = luaL_ref(L, LUA_REGISTRYINDEX);
+    task->state = script->state;
+    task->script = script;
+    task->heap_index = -1;
+
+    // lets wait() find the task it was called from
+    *(struct ye_lua_task **)lua_getextraspace(task->thread) = task;
+
+    task->script_next = script->tasks;
+    if(script->tasks != NULL)
+        script->tasks->script_prev = task;
+    script->tasks = task;
+
+    lua_task_count++;
+    return task;
+}
+
+bool ye_lua_start_callback_task(struct ye_component_lua_script *script, int callback_ref){
+    if(callback_ref == LUA_NOREF)
+        return false;
+
+    lua_rawgeti(script->state, LUA_REGISTRYINDEX, callback_ref);
+    struct ye_lua_task *task = _ye_lua_task_create(script, script->state);
+    if(task == NULL)
+        return false;
+
+    ye_lua_push_entity(task->thread, script->entity);
+    _ye_lua_task_resume(task, 1);
+    return true;
+}
+
+void ye_lua_cancel_script_tasks(struct ye_component_lua_script *script){
+    while(script->tasks != NULL){
+        struct ye_lua_task *task = script->tasks;
+        _ye_lua_task_unqueue(task);
+        _ye_lua_task_detach(task);
+
+        // the resume it is inside of frees it once it returns
+        if(!task->running)
+            _ye_lua_task_free(task);
+    }
+}
+
+/*
+    EVENTS
+*/
+
+struct ye_lua_event_waiters * _ye_lua_event(const char *name, bool create){
+    struct ye_lua_event_waiters *event = NULL;
+    HASH_FIND_STR(lua_event_waiters, name, event);
+    if(event == NULL && create){
+        event = calloc(1, sizeof(struct ye_lua_event_waiters));
+        if(event == NULL)
+            return NULL;
+        event->name = strdup(name);
+        HASH_ADD_KEYPTR(hh, lua_event_waiters, event->name, strlen(event->name), event);
+    }
+    return event;
+}
+
+void ye_lua_fire_event(const char *name){
+    struct ye_lua_event_waiters *event = _ye_lua_event(name, false);
+    if(event == NULL)
+        return;
+
+    // they are resumed by the scheduler, never from inside whoever fired the event
+    while(event->head != NULL){
+        struct ye_lua_task *task = event->head;
+        _ye_lua_list_remove(event, task);
+        task->queued_frame = lua_scheduler_frame;
+        task->wait = YE_LUA_WAIT_READY;
+        _ye_lua_list_append(&lua_ready_tasks, task);
+    }
+}
+
+/*
+    SCHEDULER
+*/
+
+/*
+    Resumes a task that is due, unless its script is inactive, then it checks again next frame
+*/
+void _ye_lua_task_wake(struct ye_lua_task *task){
+    _ye_lua_task_unqueue(task);
+    if(task->script->active){
+        _ye_lua_task_resume(task, 0);
+    }
+    else{
+        task->wait = YE_LUA_WAIT_READY;
+        _ye_lua_task_queue(task);
+    }
+}
+
+void ye_lua_scheduler_step(){
+    lua_scheduler_time += YE_STATE.runtime.delta_time;
+    lua_scheduler_frame++;
+    lua_scheduler_resumes = 0;
+
+    /*
+        Anything that started waiting during this step waits for the next one, so wait(0) or
+        yielding in a loop cant keep the scheduler busy forever
+    */
+    uint64_t frame = lua_scheduler_frame;
+
+    while(lua_time_waiters.count > 0){
+        struct ye_lua_task *task = lua_time_waiters.tasks[0];
+        if(task->wake > lua_scheduler_time || task->queued_frame >= frame)
+            break;
+        _ye_lua_task_wake(task);
+    }
+
+    while(lua_frame_waiters.count > 0){
+        struct ye_lua_task *task = lua_frame_waiters.tasks[0];
+        if(task->wake > (double)frame || task->queued_frame >= frame)
+            break;
+        _ye_lua_task_wake(task);
+    }
+
+    while(lua_ready_tasks.head != NULL && lua_ready_tasks.head->queued_frame < frame){
+        struct ye_lua_task *task = lua_ready_tasks.head;
+        _ye_lua_task_wake(task);
+    }
+
+    YE_STATE.runtime.lua_tasks = lua_task_count;
+    YE_STATE.runtime.lua_tasks_resumed = lua_scheduler_resumes;
+}
+
+void ye_lua_scheduler_shutdown(){
+    if(lua_task_count > 0)
+        ye_logf(warning,"%d lua tasks were still waiting at shutdown.\n", lua_task_count);
+
+    free(lua_time_waiters.tasks);
+    free(lua_frame_waiters.tasks);
+    lua_time_waiters = (struct ye_lua_task_heap){0};
+    lua_frame_waiters = (struct ye_lua_task_heap){0};
+    lua_ready_tasks = (struct ye_lua_event_waiters){0};
+
+    struct ye_lua_event_waiters *event, *tmp;
+    HASH_ITER(hh, lua_event_waiters, event, tmp){
+        HASH_DEL(lua_event_waiters, event);
+        free(event->name);
+        free(event);
+    }
+
+    lua_scheduler_time = 0.0;
+    lua_scheduler_frame = 0;
+}
+
+/*
+    LUA FUNCTIONS
+*/
+
+/*
+    The task a wait was called from, raising an error if it cant suspend
+*/
+struct ye_lua_task * _ye_lua_waiting_task(lua_State *L, const char *function){
+    struct ye_lua_task *task = *(struct ye_lua_task **)lua_getextraspace(L);
+    if(task == NULL || task->thread != L || !lua_isyieldable(L))
+        luaL_error(L, "%s can only be called from on_mount or a function started with ye_start_task", function);
+    return task;
+}
+
+int _ye_lua_wait(lua_State *L){
+    lua_Number seconds = luaL_checknumber(L, 1);
+    struct ye_lua_task *task = _ye_lua_waiting_task(L, "wait");
+    task->wait = YE_LUA_WAIT_TIME;
+    task->wake = lua_scheduler_time + (seconds > 0 ? seconds : 0);
+    return lua_yield(L, 0);
+}
+
+int _ye_lua_wait_frames(lua_State *L){
+    lua_Integer frames = luaL_optinteger(L, 1, 1);
+    struct ye_lua_task *task = _ye_lua_waiting_task(L, "wait_frames");
+    task->wait = YE_LUA_WAIT_FRAMES;
+    task->wake = (double)(lua_scheduler_frame + (frames > 1 ? (uint64_t)frames : 1));
+    return lua_yield(L, 0);
+}
+
+int _ye_lua_wait_event(lua_State *L){
+    const char *name = luaL_checkstring(L, 1);
+    struct ye_lua_task *task = _ye_lua_waiting_task(L, "wait_event");
+    task->event = _ye_lua_event(name, true);
+    if(task->event == NULL)
+        return luaL_error(L, "out of memory waiting for event %s", name);
+    task->wait = YE_LUA_WAIT_EVENT;
+    return lua_yield(L, 0);
+}
+
+/*
+    ye_start_task(fn, ...) runs fn(...) as a task of the calling script until it first waits
+*/
+int _ye_lua_start_task(lua_State *L){
+    luaL_checktype(L, 1, LUA_TFUNCTION);
+    if(lua_running_script == NULL)
+        return luaL_error(L, "ye_start_task can only be called from a script");
+
+    // L is the scripts state or a thread of it, so the task can be made right here
+    struct ye_component_lua_script *script = lua_running_script;
+    int nargs = lua_gettop(L) - 1;
+
+    lua_pushvalue(L, 1);
+    struct ye_lua_task *task = _ye_lua_task_create(script, L);
+    if(task == NULL)
+        return luaL_error(L, "out of memory starting a task");
+
+    for(int i = 2; i <= nargs + 1; i++)
+        lua_pushvalue(L, i);
+    lua_xmove(L, task->thread, nargs);
+    _ye_lua_task_resume(task, nargs);
+    return 0;
+}
+
+int _ye_lua_fire_event(lua_State *L){
+    ye_lua_fire_event(luaL_checkstring(L, 1));
+    return 0;
+}
+
+void ye_register_lua_coroutine_api(lua_State *L){
+    lua_register(L, "wait", _ye_lua_wait);
+    lua_register(L, "wait_frames", _ye_lua_wait_frames);
+    lua_register(L, "wait_event", _ye_lua_wait_event);
+    lua_register(L, "ye_start_task", _ye_lua_start_task);
+    lua_register(L, "ye_fire_event", _ye_lua_fire_event);
+}
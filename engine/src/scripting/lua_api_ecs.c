@@ -0,0 +1,549 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/yoyolick/yoyoengine)
+    Copyright (C) 2023  Ryan Zmuda
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+    ECS bindings for lua.
+
+    Entities are handed to scripts as a userdata boxing the entity pointer, and each component is a
+    view (also a userdata) that reads and writes the component struct in place through a table of
+    field offsets, so nothing is copied into lua tables. A view only holds the entity, it goes back
+    through entity->component on every access, so removing a component (or destroying the entity)
+    turns later accesses into errors rather than reads of freed memory.
+*/
+
+#include <limits.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <yoyoengine/yoyoengine.h>
+
+#define YE_LUA_ENTITY_METATABLE "ye_entity"
+#define YE_LUA_ENTITY_HANDLES "ye_entity_handles"   // registry table, entity pointer -> its userdata (weak values)
+
+enum ye_lua_field_type {
+    YE_LUA_FIELD_FLOAT,
+    YE_LUA_FIELD_INT,
+    YE_LUA_FIELD_BOOL
+};
+
+struct ye_lua_field {
+    const char *name;
+    enum ye_lua_field_type type;
+    size_t offset;      // offset of the field inside the component struct
+    bool read_only;
+};
+
+struct ye_lua_component_binding {
+    const char *name;                   // how scripts get at it from an entity (entity.transform)
+    const char *metatable;
+    size_t entity_offset;               // offset of the component pointer inside struct ye_entity
+    const struct ye_lua_field *fields;
+    int field_count;
+};
+
+// the box behind an entity userdata, the pointer is cleared when the entity is destroyed
+struct ye_lua_entity {
+    struct ye_entity *entity;
+};
+
+// the box behind a component view, the entity userdata is kept alive as its user value
+struct ye_lua_component {
+    struct ye_lua_entity *owner;
+    const struct ye_lua_component_binding *binding;
+};
+
+#define YE_LUA_FIELD(component, field_name, member, type, read_only) \
+    { field_name, type, offsetof(struct component, member), read_only }
+
+const struct ye_lua_field ye_lua_transform_fields[] = {
+    YE_LUA_FIELD(ye_component_transform, "x", x, YE_LUA_FIELD_FLOAT, false),
+    YE_LUA_FIELD(ye_component_transform, "y", y, YE_LUA_FIELD_FLOAT, false),
+};
+
+const struct ye_lua_field ye_lua_physics_fields[] = {
+    YE_LUA_FIELD(ye_component_physics, "active", active, YE_LUA_FIELD_BOOL, false),
+    YE_LUA_FIELD(ye_component_physics, "velocity_x", velocity.x, YE_LUA_FIELD_FLOAT, false),
+    YE_LUA_FIELD(ye_component_physics, "velocity_y", velocity.y, YE_LUA_FIELD_FLOAT, false),
+    YE_LUA_FIELD(ye_component_physics, "rotational_velocity", rotational_velocity, YE_LUA_FIELD_FLOAT, false),
+    YE_LUA_FIELD(ye_component_physics, "restitution", restitution, YE_LUA_FIELD_FLOAT, false),
+    YE_LUA_FIELD(ye_component_physics, "friction", friction, YE_LUA_FIELD_FLOAT, false),
+};
+
+const struct ye_lua_field ye_lua_collider_fields[] = {
+    YE_LUA_FIELD(ye_component_collider, "active", active, YE_LUA_FIELD_BOOL, false),
+    YE_LUA_FIELD(ye_component_collider, "relative", relative, YE_LUA_FIELD_BOOL, false),
+    YE_LUA_FIELD(ye_component_collider, "is_trigger", is_trigger, YE_LUA_FIELD_BOOL, true),
+    YE_LUA_FIELD(ye_component_collider, "x", rect.x, YE_LUA_FIELD_FLOAT, false),
+    YE_LUA_FIELD(ye_component_collider, "y", rect.y, YE_LUA_FIELD_FLOAT, false),
+    YE_LUA_FIELD(ye_component_collider, "w", rect.w, YE_LUA_FIELD_FLOAT, false),
+    YE_LUA_FIELD(ye_component_collider, "h", rect.h, YE_LUA_FIELD_FLOAT, false),
+};
+
+const struct ye_lua_field ye_lua_renderer_fields[] = {
+    YE_LUA_FIELD(ye_component_renderer, "active", active, YE_LUA_FIELD_BOOL, false),
+    YE_LUA_FIELD(ye_component_renderer, "alpha", alpha, YE_LUA_FIELD_INT, false),
+    YE_LUA_FIELD(ye_component_renderer, "z", z, YE_LUA_FIELD_INT, true),    // the render list is sorted by it
+    YE_LUA_FIELD(ye_component_renderer, "rotation", rotation, YE_LUA_FIELD_FLOAT, false),
+    YE_LUA_FIELD(ye_component_renderer, "flipped_x", flipped_x, YE_LUA_FIELD_BOOL, false),
+    YE_LUA_FIELD(ye_component_renderer, "flipped_y", flipped_y, YE_LUA_FIELD_BOOL, false),
+    YE_LUA_FIELD(ye_component_renderer, "relative", relative, YE_LUA_FIELD_BOOL, false),
+    YE_LUA_FIELD(ye_component_renderer, "x", rect.x, YE_LUA_FIELD_FLOAT, false),
+    YE_LUA_FIELD(ye_component_renderer, "y", rect.y, YE_LUA_FIELD_FLOAT, false),
+    YE_LUA_FIELD(ye_component_renderer, "w", rect.w, YE_LUA_FIELD_FLOAT, false),
+    YE_LUA_FIELD(ye_component_renderer, "h", rect.h, YE_LUA_FIELD_FLOAT, false),
+};
+
+const struct ye_lua_field ye_lua_camera_fields[] = {
+    YE_LUA_FIELD(ye_component_camera, "active", active, YE_LUA_FIELD_BOOL, false),
+    YE_LUA_FIELD(ye_component_camera, "relative", relative, YE_LUA_FIELD_BOOL, false),
+    YE_LUA_FIELD(ye_component_camera, "z", z, YE_LUA_FIELD_INT, false),
+    YE_LUA_FIELD(ye_component_camera, "x", view_field.x, YE_LUA_FIELD_INT, false),
+    YE_LUA_FIELD(ye_component_camera, "y", view_field.y, YE_LUA_FIELD_INT, false),
+    YE_LUA_FIELD(ye_component_camera, "w", view_field.w, YE_LUA_FIELD_INT, false),
+    YE_LUA_FIELD(ye_component_camera, "h", view_field.h, YE_LUA_FIELD_INT, false),
+};
+
+const struct ye_lua_field ye_lua_audiosource_fields[] = {
+    YE_LUA_FIELD(ye_component_audiosource, "active", active, YE_LUA_FIELD_BOOL, false),
+    YE_LUA_FIELD(ye_component_audiosource, "playing", playing, YE_LUA_FIELD_BOOL, false),
+    YE_LUA_FIELD(ye_component_audiosource, "loops", loops, YE_LUA_FIELD_INT, false),
+    YE_LUA_FIELD(ye_component_audiosource, "volume", volume, YE_LUA_FIELD_INT, false),
+    YE_LUA_FIELD(ye_component_audiosource, "priority", priority, YE_LUA_FIELD_INT, false),
+    YE_LUA_FIELD(ye_component_audiosource, "range", range, YE_LUA_FIELD_FLOAT, false),
+    YE_LUA_FIELD(ye_component_audiosource, "relative", relative, YE_LUA_FIELD_BOOL, false),
+    YE_LUA_FIELD(ye_component_audiosource, "x", rect.x, YE_LUA_FIELD_FLOAT, false),
+    YE_LUA_FIELD(ye_component_audiosource, "y", rect.y, YE_LUA_FIELD_FLOAT, false),
+    YE_LUA_FIELD(ye_component_audiosource, "w", rect.w, YE_LUA_FIELD_FLOAT, false),
+    YE_LUA_FIELD(ye_component_audiosource, "h", rect.h, YE_LUA_FIELD_FLOAT, false),
+};
+
+#define YE_LUA_COMPONENT(component_name, fields) \
+    { #component_name, "ye_" #component_name, offsetof(struct ye_entity, component_name), fields, sizeof(fields) / sizeof(fields[0]) }
+
+const struct ye_lua_component_binding ye_lua_components[] = {
+    YE_LUA_COMPONENT(transform, ye_lua_transform_fields),
+    YE_LUA_COMPONENT(physics, ye_lua_physics_fields),
+    YE_LUA_COMPONENT(collider, ye_lua_collider_fields),
+    YE_LUA_COMPONENT(renderer, ye_lua_renderer_fields),
+    YE_LUA_COMPONENT(camera, ye_lua_camera_fields),
+    YE_LUA_COMPONENT(audiosource, ye_lua_audiosource_fields),
+};
+
+#define YE_LUA_COMPONENT_COUNT ((int)(sizeof(ye_lua_components) / sizeof(ye_lua_components[0])))
+
+/*
+    ENTITIES
+*/
+
+void ye_lua_push_entity(lua_State *L, struct ye_entity *entity){
+    if(entity == NULL){
+        lua_pushnil(L);
+        return;
+    }
+
+    // hand out the same userdata for an entity for as long as lua holds on to it
+    lua_getfield(L, LUA_REGISTRYINDEX, YE_LUA_ENTITY_HANDLES);
+    if(lua_rawgetp(L, -1, entity) != LUA_TNIL){
+        lua_remove(L, -2);
+        return;
+    }
+    lua_pop(L, 1);
+
+    // one user value per component type, for caching its view
+    struct ye_lua_entity *handle = lua_newuserdatauv(L, sizeof(struct ye_lua_entity), YE_LUA_COMPONENT_COUNT);
+    handle->entity = entity;
+    luaL_setmetatable(L, YE_LUA_ENTITY_METATABLE);
+
+    lua_pushvalue(L, -1);
+    lua_rawsetp(L, -3, entity);
+    lua_remove(L, -2);
+}
+
+/*
+    Clears the handle a state holds for an entity, if it has one
+*/
+void _ye_lua_forget_entity_in(lua_State *L, struct ye_entity *entity){
+    lua_getfield(L, LUA_REGISTRYINDEX, YE_LUA_ENTITY_HANDLES);
+    if(lua_rawgetp(L, -1, entity) == LUA_TUSERDATA){
+        struct ye_lua_entity *handle = lua_touserdata(L, -1);
+        handle->entity = NULL;
+
+        lua_pushnil(L);
+        lua_rawsetp(L, -3, entity);
+    }
+    lua_pop(L, 2);
+}
+
+void ye_lua_forget_entity(struct ye_entity *entity){
+    if(lua_shared_state != NULL)
+        _ye_lua_forget_entity_in(lua_shared_state, entity);
+
+    // scripts that have their own state could be holding it too
+    for(struct ye_entity_node *current = lua_script_list_head; current != NULL; current = current->next){
+        struct ye_component_lua_script *script = current->entity->lua_script;
+        if(!script->shared_state && script->state != NULL)
+            _ye_lua_forget_entity_in(script->state, entity);
+    }
+}
+
+/*
+    The entity behind the userdata at idx, erroring if it is not an entity or was destroyed
+*/
+struct ye_entity * _ye_lua_check_entity(lua_State *L, int idx){
+    struct ye_lua_entity *handle = luaL_checkudata(L, idx, YE_LUA_ENTITY_METATABLE);
+    if(handle->entity == NULL)
+        luaL_error(L, "attempt to use a destroyed entity");
+    return handle->entity;
+}
+
+// same as _ye_lua_check_entity, but NULL instead of an error (for bulk functions)
+struct ye_entity * _ye_lua_test_entity(lua_State *L, int idx){
+    struct ye_lua_entity *handle = luaL_testudata(L, idx, YE_LUA_ENTITY_METATABLE);
+    return handle != NULL ? handle->entity : NULL;
+}
+
+void * _ye_lua_component_of(struct ye_entity *entity, const struct ye_lua_component_binding *binding){
+    return *(void**)((char*)entity + binding->entity_offset);
+}
+
+/*
+    Pushes the view of a component, creating (and caching on the entity userdata) it the first time
+*/
+void _ye_lua_push_component(lua_State *L, int entity_idx, int slot){
+    entity_idx = lua_absindex(L, entity_idx);
+    if(lua_getiuservalue(L, entity_idx, slot + 1) == LUA_TUSERDATA)
+        return;
+    lua_pop(L, 1);
+
+    struct ye_lua_component *view = lua_newuserdatauv(L, sizeof(struct ye_lua_component), 1);
+    view->owner = lua_touserdata(L, entity_idx);
+    view->binding = &ye_lua_components[slot];
+    luaL_setmetatable(L, ye_lua_components[slot].metatable);
+
+    // the view keeps its entity userdata alive
+    lua_pushvalue(L, entity_idx);
+    lua_setiuservalue(L, -2, 1);
+
+    lua_pushvalue(L, -1);
+    lua_setiuservalue(L, entity_idx, slot + 1);
+}
+
+int _ye_lua_entity_index(lua_State *L){
+    struct ye_entity *entity = _ye_lua_check_entity(L, 1);
+    const char *key = luaL_checkstring(L, 2);
+
+    if(strcmp(key, "id") == 0){
+        lua_pushinteger(L, entity->id);
+        return 1;
+    }
+    if(strcmp(key, "name") == 0){
+        lua_pushstring(L, entity->name);
+        return 1;
+    }
+    if(strcmp(key, "active") == 0){
+        lua_pushboolean(L, entity->active);
+        return 1;
+    }
+
+    for(int i = 0; i < YE_LUA_COMPONENT_COUNT; i++){
+        if(strcmp(key, ye_lua_components[i].name) != 0)
+            continue;
+
+        if(_ye_lua_component_of(entity, &ye_lua_components[i]) == NULL)
+            lua_pushnil(L);
+        else
+            _ye_lua_push_component(L, 1, i);
+        return 1;
+    }
+
+    lua_pushnil(L);
+    return 1;
+}
+
+int _ye_lua_entity_newindex(lua_State *L){
+    struct ye_entity *entity = _ye_lua_check_entity(L, 1);
+    const char *key = luaL_checkstring(L, 2);
+
+    if(strcmp(key, "active") == 0){
+        entity->active = lua_toboolean(L, 3);
+        return 0;
+    }
+    return luaL_error(L, "cannot set field '%s' of an entity", key);
+}
+
+int _ye_lua_entity_tostring(lua_State *L){
+    struct ye_lua_entity *handle = luaL_checkudata(L, 1, YE_LUA_ENTITY_METATABLE);
+    if(handle->entity == NULL)
+        lua_pushstring(L, "entity (destroyed)");
+    else
+        lua_pushfstring(L, "entity %d \"%s\"", handle->entity->id, handle->entity->name);
+    return 1;
+}
+
+/*
+    COMPONENT VIEWS
+
+    __index and __newindex are closures over a table mapping field names to their index in the
+    binding (so resolving a field is one table lookup on an interned string) and the index of the
+    binding itself, which the view is checked against since scripts can call the metamethods directly.
+*/
+
+void * _ye_lua_check_component(lua_State *L, const struct ye_lua_component_binding **binding){
+    int slot = (int)lua_tointeger(L, lua_upvalueindex(2));
+    struct ye_lua_component *view = luaL_checkudata(L, 1, ye_lua_components[slot].metatable);
+    *binding = view->binding;
+
+    if(view->owner->entity == NULL)
+        luaL_error(L, "attempt to use a component of a destroyed entity");
+
+    void *component = _ye_lua_component_of(view->owner->entity, view->binding);
+    if(component == NULL)
+        luaL_error(L, "entity \"%s\" no longer has a %s", view->owner->entity->name, view->binding->name);
+    return component;
+}
+
+const struct ye_lua_field * _ye_lua_lookup_field(lua_State *L, const struct ye_lua_component_binding *binding){
+    lua_pushvalue(L, 2);
+    if(lua_rawget(L, lua_upvalueindex(1)) != LUA_TNUMBER){
+        lua_pop(L, 1);
+        return NULL;
+    }
+    int index = (int)lua_tointeger(L, -1);
+    lua_pop(L, 1);
+    return &binding->fields[index];
+}
+
+int _ye_lua_component_index(lua_State *L){
+    const struct ye_lua_component_binding *binding;
+    char *component = _ye_lua_check_component(L, &binding);
+
+    const struct ye_lua_field *field = _ye_lua_lookup_field(L, binding);
+    if(field == NULL){
+        lua_pushnil(L);
+        return 1;
+    }
+
+    switch(field->type){
+        case YE_LUA_FIELD_FLOAT:
+            lua_pushnumber(L, *(float*)(component + field->offset));
+            break;
+        case YE_LUA_FIELD_INT:
+            lua_pushinteger(L, *(int*)(component + field->offset));
+            break;
+        case YE_LUA_FIELD_BOOL:
+            lua_pushboolean(L, *(bool*)(component + field->offset));
+            break;
+    }
+    return 1;
+}
+
+/*
+    Integer fields accept any number and truncate it like before, but casting a NaN or out of range
+    double to int is undefined, so those are rejected or clamped first.
+*/
+int _ye_lua_check_int(lua_State *L, int arg){
+    lua_Number value = luaL_checknumber(L, arg);
+    if(value != value)
+        luaL_argerror(L, arg, "number is NaN");
+    if(value >= (lua_Number)INT_MAX)
+        return INT_MAX;
+    if(value <= (lua_Number)INT_MIN)
+        return INT_MIN;
+    return (int)value;
+}
+
+int _ye_lua_component_newindex(lua_State *L){
+    const struct ye_lua_component_binding *binding;
+    char *component = _ye_lua_check_component(L, &binding);
+
+    const struct ye_lua_field *field = _ye_lua_lookup_field(L, binding);
+    if(field == NULL)
+        return luaL_error(L, "%s has no field '%s'", binding->name, luaL_checkstring(L, 2));
+    if(field->read_only)
+        return luaL_error(L, "%s.%s is read only", binding->name, field->name);
+
+    switch(field->type){
+        case YE_LUA_FIELD_FLOAT:
+            *(float*)(component + field->offset) = (float)luaL_checknumber(L, 3);
+            break;
+        case YE_LUA_FIELD_INT:
+            *(int*)(component + field->offset) = _ye_lua_check_int(L, 3);
+            break;
+        case YE_LUA_FIELD_BOOL:
+            *(bool*)(component + field->offset) = lua_toboolean(L, 3);
+            break;
+    }
+    return 0;
+}
+
+/*
+    LOOKUPS
+*/
+
+int _ye_lua_get_entity(lua_State *L){
+    ye_lua_push_entity(L, ye_get_entity_by_name(luaL_checkstring(L, 1)));
+    return 1;
+}
+
+int _ye_lua_get_entity_by_id(lua_State *L){
+    ye_lua_push_entity(L, ye_get_entity_by_id((int)luaL_checkinteger(L, 1)));
+    return 1;
+}
+
+/*
+    BULK
+
+    For scripts that drive a lot of entities: one call walks an array of entities and moves values
+    between their components and plain arrays, instead of a field access per entity per value.
+*/
+
+/*
+    Returns the table at idx, or a new one (left on the stack at idx) if nothing was passed
+*/
+void _ye_lua_opt_table(lua_State *L, int idx, int size){
+    if(lua_isnoneornil(L, idx)){
+        lua_createtable(L, size, 0);
+        lua_replace(L, idx);
+    }
+    else{
+        luaL_checktype(L, idx, LUA_TTABLE);
+    }
+}
+
+// xs, ys = ye_get_positions(entities [, xs, ys]), entities without a transform get nil
+int _ye_lua_get_positions(lua_State *L){
+    luaL_checktype(L, 1, LUA_TTABLE);
+    int count = (int)lua_rawlen(L, 1);
+    lua_settop(L, 3);
+    _ye_lua_opt_table(L, 2, count);
+    _ye_lua_opt_table(L, 3, count);
+
+    for(int i = 1; i <= count; i++){
+        lua_rawgeti(L, 1, i);
+        struct ye_entity *entity = _ye_lua_test_entity(L, -1);
+        lua_pop(L, 1);
+
+        if(entity != NULL && entity->transform != NULL){
+            lua_pushnumber(L, entity->transform->x);
+            lua_rawseti(L, 2, i);
+            lua_pushnumber(L, entity->transform->y);
+            lua_rawseti(L, 3, i);
+        }
+        else{
+            lua_pushnil(L);
+            lua_rawseti(L, 2, i);
+            lua_pushnil(L);
+            lua_rawseti(L, 3, i);
+        }
+    }
+    return 2;
+}
+
+// ye_set_positions(entities, xs, ys), skipping entities without a transform and nil values
+int _ye_lua_set_positions(lua_State *L){
+    luaL_checktype(L, 1, LUA_TTABLE);
+    luaL_checktype(L, 2, LUA_TTABLE);
+    luaL_checktype(L, 3, LUA_TTABLE);
+    int count = (int)lua_rawlen(L, 1);
+
+    for(int i = 1; i <= count; i++){
+        lua_rawgeti(L, 1, i);
+        lua_rawgeti(L, 2, i);
+        lua_rawgeti(L, 3, i);
+        struct ye_entity *entity = _ye_lua_test_entity(L, -3);
+        if(entity != NULL && entity->transform != NULL && lua_isnumber(L, -2) && lua_isnumber(L, -1)){
+            entity->transform->x = (float)lua_tonumber(L, -2);
+            entity->transform->y = (float)lua_tonumber(L, -1);
+        }
+        lua_pop(L, 3);
+    }
+    return 0;
+}
+
+// ye_set_velocities(entities, vxs, vys), skipping entities without physics and nil values
+int _ye_lua_set_velocities(lua_State *L){
+    luaL_checktype(L, 1, LUA_TTABLE);
+    luaL_checktype(L, 2, LUA_TTABLE);
+    luaL_checktype(L, 3, LUA_TTABLE);
+    int count = (int)lua_rawlen(L, 1);
+
+    for(int i = 1; i <= count; i++){
+        lua_rawgeti(L, 1, i);
+        lua_rawgeti(L, 2, i);
+        lua_rawgeti(L, 3, i);
+        struct ye_entity *entity = _ye_lua_test_entity(L, -3);
+        if(entity != NULL && entity->physics != NULL && lua_isnumber(L, -2) && lua_isnumber(L, -1)){
+            entity->physics->velocity.x = (float)lua_tonumber(L, -2);
+            entity->physics->velocity.y = (float)lua_tonumber(L, -1);
+        }
+        lua_pop(L, 3);
+    }
+    return 0;
+}
+
+/*
+    REGISTRATION
+*/
+
+void ye_register_lua_ecs_api(lua_State *L){
+    // entity pointer -> userdata, weak so handles lua dropped can be collected
+    lua_newtable(L);
+    lua_newtable(L);
+    lua_pushstring(L, "v");
+    lua_setfield(L, -2, "__mode");
+    lua_setmetatable(L, -2);
+    lua_setfield(L, LUA_REGISTRYINDEX, YE_LUA_ENTITY_HANDLES);
+
+    luaL_newmetatable(L, YE_LUA_ENTITY_METATABLE);
+    lua_pushcfunction(L, _ye_lua_entity_index);
+    lua_setfield(L, -2, "__index");
+    lua_pushcfunction(L, _ye_lua_entity_newindex);
+    lua_setfield(L, -2, "__newindex");
+    lua_pushcfunction(L, _ye_lua_entity_tostring);
+    lua_setfield(L, -2, "__tostring");
+    lua_pop(L, 1);
+
+    for(int i = 0; i < YE_LUA_COMPONENT_COUNT; i++){
+        const struct ye_lua_component_binding *binding = &ye_lua_components[i];
+
+        luaL_newmetatable(L, binding->metatable);
+
+        // field name -> index into binding->fields, shared by both metamethods
+        lua_createtable(L, 0, binding->field_count);
+        for(int f = 0; f < binding->field_count; f++){
+            lua_pushinteger(L, f);
+            lua_setfield(L, -2, binding->fields[f].name);
+        }
+
+        lua_pushvalue(L, -1);
+        lua_pushinteger(L, i);
+        lua_pushcclosure(L, _ye_lua_component_index, 2);
+        lua_setfield(L, -3, "__index");
+        lua_pushinteger(L, i);
+        lua_pushcclosure(L, _ye_lua_component_newindex, 2);
+        lua_setfield(L, -2, "__newindex");
+
+        lua_pop(L, 1);
+    }
+
+    lua_register(L, "ye_get_entity", _ye_lua_get_entity);
+    lua_register(L, "ye_get_entity_by_id", _ye_lua_get_entity_by_id);
+    lua_register(L, "ye_get_positions", _ye_lua_get_positions);
+    lua_register(L, "ye_set_positions", _ye_lua_set_positions);
+    lua_register(L, "ye_set_velocities", _ye_lua_set_velocities);
+}
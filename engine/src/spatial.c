@@ -0,0 +1,511 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/yoyolick/yoyoengine)
+    Copyright (C) 2023  Ryan Zmuda
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <stdlib.h>
+#include <math.h>
+#include <float.h>
+
+#include <yoyoengine/yoyoengine.h>
+
+/*
+    One tracked set of bounds (a collider or a renderer on an entity)
+*/
+struct ye_spatial_item {
+    struct ye_entity *entity;
+    enum ye_component_type component;
+    struct ye_rectf bounds;
+    int z;                  // renderer z of the entity (used for sorting point/rect results)
+    unsigned int stamp;     // id of the last query that visited this item
+};
+
+/*
+    A cell in the open addressing hash table, pointing at the head of a list of spatial_refs
+*/
+struct ye_spatial_cell {
+    int cx, cy;
+    int head;   // index into spatial_refs, -1 when the slot is unused
+};
+
+struct ye_spatial_ref {
+    int item;
+    int next;
+};
+
+/*
+    A candidate result before it gets sorted and copied out to the caller
+*/
+struct ye_spatial_candidate {
+    struct ye_spatial_hit hit;
+    int z;
+};
+
+/*
+    All of these only ever grow, so steady state queries and rebuilds do not allocate
+*/
+struct ye_spatial_item *spatial_items = NULL;
+int spatial_item_count = 0;
+int spatial_item_capacity = 0;
+
+struct ye_spatial_cell *spatial_cells = NULL;
+int spatial_cell_capacity = 0; // always a power of two
+
+struct ye_spatial_ref *spatial_refs = NULL;
+int spatial_ref_count = 0;
+int spatial_ref_capacity = 0;
+
+int *spatial_oversized = NULL;
+int spatial_oversized_count = 0;
+int spatial_oversized_capacity = 0;
+
+struct ye_spatial_candidate *spatial_candidates = NULL;
+int spatial_candidate_capacity = 0;
+
+unsigned int spatial_query_stamp = 0;
+bool spatial_dirty = true;
+struct ye_rectf spatial_world_bounds = {0,0,0,0};
+
+/*
+    Grows a buffer to hold at least needed elements
+*/
+bool _ye_spatial_reserve(void **buffer, int *capacity, int needed, size_t element_size){
+    if(needed <= *capacity)
+        return true;
+
+    int new_capacity = *capacity > 0 ? *capacity : 64;
+    while(new_capacity < needed)
+        new_capacity *= 2;
+
+    void *grown = realloc(*buffer, new_capacity * element_size);
+    if(grown == NULL){
+        ye_logf(error, "Failed to grow spatial index buffer to %d elements.\n", new_capacity);
+        return false;
+    }
+    *buffer = grown;
+    *capacity = new_capacity;
+    return true;
+}
+
+int _ye_spatial_cell_coord(float v){
+    return (int)floorf(v / YE_SPATIAL_CELL_SIZE);
+}
+
+unsigned int _ye_spatial_hash(int cx, int cy){
+    return ((unsigned int)cx * 73856093u) ^ ((unsigned int)cy * 19349663u);
+}
+
+int _ye_spatial_find_cell(int cx, int cy){
+    if(spatial_cell_capacity == 0)
+        return -1;
+
+    unsigned int mask = spatial_cell_capacity - 1;
+    unsigned int slot = _ye_spatial_hash(cx, cy) & mask;
+    while(spatial_cells[slot].head != -1){
+        if(spatial_cells[slot].cx == cx && spatial_cells[slot].cy == cy)
+            return slot;
+        slot = (slot + 1) & mask;
+    }
+    return -1;
+}
+
+void _ye_spatial_insert_ref(int cx, int cy, int item){
+    unsigned int mask = spatial_cell_capacity - 1;
+    unsigned int slot = _ye_spatial_hash(cx, cy) & mask;
+    while(spatial_cells[slot].head != -1 && (spatial_cells[slot].cx != cx || spatial_cells[slot].cy != cy)){
+        slot = (slot + 1) & mask;
+    }
+
+    spatial_refs[spatial_ref_count].item = item;
+    spatial_refs[spatial_ref_count].next = spatial_cells[slot].head;
+    spatial_cells[slot].cx = cx;
+    spatial_cells[slot].cy = cy;
+    spatial_cells[slot].head = spatial_ref_count;
+    spatial_ref_count++;
+}
+
+void _ye_spatial_add_item(struct ye_entity *entity, enum ye_component_type component){
+    if(!_ye_spatial_reserve((void**)&spatial_items, &spatial_item_capacity, spatial_item_count + 1, sizeof(struct ye_spatial_item)))
+        return;
+
+    struct ye_spatial_item *item = &spatial_items[spatial_item_count++];
+    item->entity = entity;
+    item->component = component;
+    item->bounds = ye_get_position(entity, component);
+    item->z = entity->renderer != NULL ? entity->renderer->z : 0;
+    item->stamp = 0;
+}
+
+/*
+    Rebuild the grid from the current collider and renderer lists.
+    Two passes: count how many spatial_refs we will need, then insert them.
+*/
+void _ye_spatial_rebuild(){
+    spatial_item_count = 0;
+    spatial_ref_count = 0;
+    spatial_oversized_count = 0;
+
+    struct ye_entity_node *current = collider_list_head;
+    while(current != NULL){
+        if(current->entity->active && current->entity->collider != NULL && current->entity->collider->active)
+            _ye_spatial_add_item(current->entity, YE_COMPONENT_COLLIDER);
+        current = current->next;
+    }
+
+    current = renderer_list_head;
+    while(current != NULL){
+        if(current->entity->active && current->entity->renderer != NULL && current->entity->renderer->active)
+            _ye_spatial_add_item(current->entity, YE_COMPONENT_RENDERER);
+        current = current->next;
+    }
+
+    // count the spatial_refs we need and the world bounds
+    int needed_refs = 0;
+    float min_x = FLT_MAX, min_y = FLT_MAX, max_x = -FLT_MAX, max_y = -FLT_MAX;
+    for(int i = 0; i < spatial_item_count; i++){
+        struct ye_rectf b = spatial_items[i].bounds;
+        int span = (_ye_spatial_cell_coord(b.x + b.w) - _ye_spatial_cell_coord(b.x) + 1) *
+                   (_ye_spatial_cell_coord(b.y + b.h) - _ye_spatial_cell_coord(b.y) + 1);
+        if(span <= YE_SPATIAL_MAX_CELLS_PER_ITEM)
+            needed_refs += span;
+
+        if(b.x < min_x) min_x = b.x;
+        if(b.y < min_y) min_y = b.y;
+        if(b.x + b.w > max_x) max_x = b.x + b.w;
+        if(b.y + b.h > max_y) max_y = b.y + b.h;
+    }
+    spatial_world_bounds = spatial_item_count > 0 ? (struct ye_rectf){min_x, min_y, max_x - min_x, max_y - min_y} : (struct ye_rectf){0,0,0,0};
+
+    // keep the table at most half full
+    int needed_cells = 64;
+    while(needed_cells < needed_refs * 2)
+        needed_cells *= 2;
+
+    if(!_ye_spatial_reserve((void**)&spatial_refs, &spatial_ref_capacity, needed_refs, sizeof(struct ye_spatial_ref)) ||
+       !_ye_spatial_reserve((void**)&spatial_oversized, &spatial_oversized_capacity, spatial_item_count, sizeof(int)) ||
+       !_ye_spatial_reserve((void**)&spatial_candidates, &spatial_candidate_capacity, spatial_item_count, sizeof(struct ye_spatial_candidate)) ||
+       !_ye_spatial_reserve((void**)&spatial_cells, &spatial_cell_capacity, needed_cells, sizeof(struct ye_spatial_cell))){
+        spatial_item_count = 0;
+        return;
+    }
+
+    for(int i = 0; i < spatial_cell_capacity; i++)
+        spatial_cells[i].head = -1;
+
+    for(int i = 0; i < spatial_item_count; i++){
+        struct ye_rectf b = spatial_items[i].bounds;
+        int x0 = _ye_spatial_cell_coord(b.x), x1 = _ye_spatial_cell_coord(b.x + b.w);
+        int y0 = _ye_spatial_cell_coord(b.y), y1 = _ye_spatial_cell_coord(b.y + b.h);
+
+        if((x1 - x0 + 1) * (y1 - y0 + 1) > YE_SPATIAL_MAX_CELLS_PER_ITEM){
+            spatial_oversized[spatial_oversized_count++] = i;
+            continue;
+        }
+
+        for(int cy = y0; cy <= y1; cy++)
+            for(int cx = x0; cx <= x1; cx++)
+                _ye_spatial_insert_ref(cx, cy, i);
+    }
+
+    spatial_dirty = false;
+}
+
+void _ye_spatial_ensure_built(){
+    if(spatial_dirty)
+        _ye_spatial_rebuild();
+}
+
+/*
+    Starts a new query, so every item can be visited at most once
+*/
+void _ye_spatial_begin_query(){
+    spatial_query_stamp++;
+    if(spatial_query_stamp == 0){
+        // wrapped, reset every stamp so old values cant collide
+        for(int i = 0; i < spatial_item_count; i++)
+            spatial_items[i].stamp = 0;
+        spatial_query_stamp = 1;
+    }
+}
+
+bool _ye_spatial_visit(int item, int mask){
+    if(spatial_items[item].stamp == spatial_query_stamp)
+        return false;
+    spatial_items[item].stamp = spatial_query_stamp;
+
+    if(spatial_items[item].component == YE_COMPONENT_COLLIDER)
+        return (mask & YE_SPATIAL_COLLIDERS) != 0;
+    return (mask & YE_SPATIAL_RENDERERS) != 0;
+}
+
+bool _ye_spatial_rect_overlap(struct ye_rectf a, struct ye_rectf b){
+    return a.x <= b.x + b.w && a.x + a.w >= b.x &&
+           a.y <= b.y + b.h && a.y + a.h >= b.y;
+}
+
+void _ye_spatial_add_candidate(int *count, int item, float distance, struct ye_vec2f point, struct ye_vec2f normal){
+    struct ye_spatial_candidate *c = &spatial_candidates[(*count)++];
+    c->hit.entity = spatial_items[item].entity;
+    c->hit.component = spatial_items[item].component;
+    c->hit.bounds = spatial_items[item].bounds;
+    c->hit.distance = distance;
+    c->hit.point = point;
+    c->hit.normal = normal;
+    c->z = spatial_items[item].z;
+}
+
+int _ye_spatial_compare_distance(const void *a, const void *b){
+    const struct ye_spatial_candidate *ca = a, *cb = b;
+    if(ca->hit.distance < cb->hit.distance) return -1;
+    if(ca->hit.distance > cb->hit.distance) return 1;
+    return ca->hit.entity->id - cb->hit.entity->id;
+}
+
+int _ye_spatial_compare_z(const void *a, const void *b){
+    const struct ye_spatial_candidate *ca = a, *cb = b;
+    if(ca->z != cb->z) return cb->z - ca->z;
+    if(ca->hit.entity->id != cb->hit.entity->id) return ca->hit.entity->id - cb->hit.entity->id;
+    return (int)ca->hit.component - (int)cb->hit.component;
+}
+
+int _ye_spatial_finish(int count, int (*compare)(const void*, const void*), struct ye_spatial_hit *hits, int max_hits){
+    qsort(spatial_candidates, count, sizeof(struct ye_spatial_candidate), compare);
+
+    int written = count < max_hits ? count : max_hits;
+    for(int i = 0; i < written; i++)
+        hits[i] = spatial_candidates[i].hit;
+    return written;
+}
+
+/*
+    Slab test of a ray against a rect, writes the entry distance and the normal of the entered face,
+    and the exit distance if t_exit is not NULL
+*/
+bool _ye_spatial_ray_rect(float ox, float oy, float dx, float dy, struct ye_rectf r, float max_t, float *t_out, float *t_exit, struct ye_vec2f *normal){
+    float t_min = 0.0f, t_max = max_t;
+    struct ye_vec2f n = {0,0};
+
+    // x slab
+    if(dx == 0.0f){
+        if(ox < r.x || ox > r.x + r.w) return false;
+    }
+    else{
+        float inv = 1.0f / dx;
+        float t1 = (r.x - ox) * inv;
+        float t2 = (r.x + r.w - ox) * inv;
+        float nx = -1.0f;
+        if(t1 > t2){ float tmp = t1; t1 = t2; t2 = tmp; nx = 1.0f; }
+        if(t1 > t_min){ t_min = t1; n = (struct ye_vec2f){nx, 0}; }
+        if(t2 < t_max) t_max = t2;
+        if(t_min > t_max) return false;
+    }
+
+    // y slab
+    if(dy == 0.0f){
+        if(oy < r.y || oy > r.y + r.h) return false;
+    }
+    else{
+        float inv = 1.0f / dy;
+        float t1 = (r.y - oy) * inv;
+        float t2 = (r.y + r.h - oy) * inv;
+        float ny = -1.0f;
+        if(t1 > t2){ float tmp = t1; t1 = t2; t2 = tmp; ny = 1.0f; }
+        if(t1 > t_min){ t_min = t1; n = (struct ye_vec2f){0, ny}; }
+        if(t2 < t_max) t_max = t2;
+        if(t_min > t_max) return false;
+    }
+
+    *t_out = t_min;
+    if(t_exit != NULL)
+        *t_exit = t_max;
+    *normal = n;
+    return true;
+}
+
+void _ye_spatial_ray_test(int item, int mask, float ox, float oy, float dx, float dy, float max_t, int *count){
+    if(!_ye_spatial_visit(item, mask))
+        return;
+
+    float t;
+    struct ye_vec2f normal;
+    if(_ye_spatial_ray_rect(ox, oy, dx, dy, spatial_items[item].bounds, max_t, &t, NULL, &normal)){
+        _ye_spatial_add_candidate(count, item, t, (struct ye_vec2f){ox + dx * t, oy + dy * t}, normal);
+    }
+}
+
+int ye_raycast(float x, float y, float dir_x, float dir_y, float max_distance, int mask, struct ye_spatial_hit *hits, int max_hits){
+    _ye_spatial_ensure_built();
+    if(spatial_item_count == 0 || hits == NULL || max_hits <= 0)
+        return 0;
+
+    float length = sqrtf(dir_x * dir_x + dir_y * dir_y);
+    if(length == 0.0f){
+        ye_logf(warning, "Raycast with a zero length direction, treating it as a point query.\n");
+        return ye_query_point(x, y, mask, hits, max_hits);
+    }
+    float dx = dir_x / length;
+    float dy = dir_y / length;
+
+    // clip the ray to the world bounds so unbounded rays terminate where they leave it
+    float t_enter, t_exit;
+    struct ye_vec2f unused;
+    float limit = max_distance > 0 ? max_distance : FLT_MAX;
+    if(!_ye_spatial_ray_rect(x, y, dx, dy, spatial_world_bounds, limit, &t_enter, &t_exit, &unused))
+        return 0;
+
+    _ye_spatial_begin_query();
+    int count = 0;
+
+    for(int i = 0; i < spatial_oversized_count; i++)
+        _ye_spatial_ray_test(spatial_oversized[i], mask, x, y, dx, dy, limit, &count);
+
+    /*
+        Walk the grid spatial_cells along the ray (Amanatides & Woo) starting where it enters the world
+    */
+    float sx = x + dx * t_enter;
+    float sy = y + dy * t_enter;
+    int cx = _ye_spatial_cell_coord(sx);
+    int cy = _ye_spatial_cell_coord(sy);
+    int step_x = dx > 0 ? 1 : -1;
+    int step_y = dy > 0 ? 1 : -1;
+
+    float next_x = (cx + (step_x > 0 ? 1 : 0)) * YE_SPATIAL_CELL_SIZE;
+    float next_y = (cy + (step_y > 0 ? 1 : 0)) * YE_SPATIAL_CELL_SIZE;
+    float t_max_x = dx != 0.0f ? t_enter + (next_x - sx) / dx : FLT_MAX;
+    float t_max_y = dy != 0.0f ? t_enter + (next_y - sy) / dy : FLT_MAX;
+    float t_delta_x = dx != 0.0f ? YE_SPATIAL_CELL_SIZE / fabsf(dx) : FLT_MAX;
+    float t_delta_y = dy != 0.0f ? YE_SPATIAL_CELL_SIZE / fabsf(dy) : FLT_MAX;
+
+    float t = t_enter;
+    while(t <= t_exit){
+        int slot = _ye_spatial_find_cell(cx, cy);
+        if(slot != -1){
+            for(int r = spatial_cells[slot].head; r != -1; r = spatial_refs[r].next)
+                _ye_spatial_ray_test(spatial_refs[r].item, mask, x, y, dx, dy, limit, &count);
+        }
+
+        if(t_max_x < t_max_y){
+            t = t_max_x;
+            t_max_x += t_delta_x;
+            cx += step_x;
+        }
+        else{
+            t = t_max_y;
+            t_max_y += t_delta_y;
+            cy += step_y;
+        }
+    }
+
+    return _ye_spatial_finish(count, _ye_spatial_compare_distance, hits, max_hits);
+}
+
+int ye_query_point(float x, float y, int mask, struct ye_spatial_hit *hits, int max_hits){
+    _ye_spatial_ensure_built();
+    if(spatial_item_count == 0 || hits == NULL || max_hits <= 0)
+        return 0;
+
+    _ye_spatial_begin_query();
+    int count = 0;
+    struct ye_vec2f point = {x, y};
+    struct ye_rectf probe = {x, y, 0, 0};
+
+    for(int i = 0; i < spatial_oversized_count; i++){
+        int item = spatial_oversized[i];
+        if(_ye_spatial_visit(item, mask) && _ye_spatial_rect_overlap(probe, spatial_items[item].bounds))
+            _ye_spatial_add_candidate(&count, item, 0, point, (struct ye_vec2f){0,0});
+    }
+
+    int slot = _ye_spatial_find_cell(_ye_spatial_cell_coord(x), _ye_spatial_cell_coord(y));
+    if(slot != -1){
+        for(int r = spatial_cells[slot].head; r != -1; r = spatial_refs[r].next){
+            int item = spatial_refs[r].item;
+            if(_ye_spatial_visit(item, mask) && _ye_spatial_rect_overlap(probe, spatial_items[item].bounds))
+                _ye_spatial_add_candidate(&count, item, 0, point, (struct ye_vec2f){0,0});
+        }
+    }
+
+    return _ye_spatial_finish(count, _ye_spatial_compare_z, hits, max_hits);
+}
+
+int ye_query_rect(struct ye_rectf rect, int mask, struct ye_spatial_hit *hits, int max_hits){
+    _ye_spatial_ensure_built();
+    if(spatial_item_count == 0 || hits == NULL || max_hits <= 0)
+        return 0;
+
+    _ye_spatial_begin_query();
+    int count = 0;
+    struct ye_vec2f point = {rect.x, rect.y};
+
+    int x0 = _ye_spatial_cell_coord(rect.x), x1 = _ye_spatial_cell_coord(rect.x + rect.w);
+    int y0 = _ye_spatial_cell_coord(rect.y), y1 = _ye_spatial_cell_coord(rect.y + rect.h);
+    long long span = (long long)(x1 - x0 + 1) * (long long)(y1 - y0 + 1);
+
+    /*
+        If the rect covers more spatial_cells than we have spatial_items, walking the spatial_cells costs more
+        than just testing every item, so do that instead.
+    */
+    if(span > spatial_item_count){
+        for(int i = 0; i < spatial_item_count; i++){
+            if(_ye_spatial_visit(i, mask) && _ye_spatial_rect_overlap(rect, spatial_items[i].bounds))
+                _ye_spatial_add_candidate(&count, i, 0, point, (struct ye_vec2f){0,0});
+        }
+        return _ye_spatial_finish(count, _ye_spatial_compare_z, hits, max_hits);
+    }
+
+    for(int i = 0; i < spatial_oversized_count; i++){
+        int item = spatial_oversized[i];
+        if(_ye_spatial_visit(item, mask) && _ye_spatial_rect_overlap(rect, spatial_items[item].bounds))
+            _ye_spatial_add_candidate(&count, item, 0, point, (struct ye_vec2f){0,0});
+    }
+
+    for(int cy = y0; cy <= y1; cy++){
+        for(int cx = x0; cx <= x1; cx++){
+            int slot = _ye_spatial_find_cell(cx, cy);
+            if(slot == -1)
+                continue;
+            for(int r = spatial_cells[slot].head; r != -1; r = spatial_refs[r].next){
+                int item = spatial_refs[r].item;
+                if(_ye_spatial_visit(item, mask) && _ye_spatial_rect_overlap(rect, spatial_items[item].bounds))
+                    _ye_spatial_add_candidate(&count, item, 0, point, (struct ye_vec2f){0,0});
+            }
+        }
+    }
+
+    return _ye_spatial_finish(count, _ye_spatial_compare_z, hits, max_hits);
+}
+
+void ye_spatial_invalidate(){
+    spatial_dirty = true;
+}
+
+void ye_init_spatial(){
+    spatial_item_count = 0;
+    spatial_ref_count = 0;
+    spatial_oversized_count = 0;
+    spatial_query_stamp = 0;
+    spatial_dirty = true;
+    ye_logf(info, "Initialized spatial index.\n");
+}
+
+void ye_shutdown_spatial(){
+    free(spatial_items);        spatial_items = NULL;       spatial_item_capacity = 0;      spatial_item_count = 0;
+    free(spatial_cells);        spatial_cells = NULL;       spatial_cell_capacity = 0;
+    free(spatial_refs);         spatial_refs = NULL;        spatial_ref_capacity = 0;       spatial_ref_count = 0;
+    free(spatial_oversized);    spatial_oversized = NULL;   spatial_oversized_capacity = 0; spatial_oversized_count = 0;
+    free(spatial_candidates);   spatial_candidates = NULL;  spatial_candidate_capacity = 0;
+    spatial_dirty = true;
+    ye_logf(info, "Shut down spatial index.\n");
+}
@@ -0,0 +1,299 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/yoyolick/yoyoengine)
+    Copyright (C) 2023  Ryan Zmuda
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <SDL2/SDL.h>
+
+#include <yoyoengine/yoyoengine.h>
+
+// shown in place of a texture until it has streamed in
+extern SDL_Texture *missing_texture;
+
+/*
+    A texture somewhere between being requested and being uploaded.
+    Requests are handed to the loader thread, which fills in surface and hands them back.
+*/
+struct ye_stream_job {
+    char *key;                      // cache key of the texture
+    SDL_Surface *surface;           // decoded RGBA32 pixels, NULL if the file could not be loaded
+    uint64_t content_hash;
+    SDL_Texture *texture;           // created on the main thread once the upload starts
+    int uploaded_rows;
+    struct ye_stream_job *next;
+};
+
+/*
+    Keys that have been requested and not finished, so a path is only streamed once
+*/
+struct ye_stream_pending {
+    char *key;
+    UT_hash_handle hh;
+};
+
+SDL_Thread *stream_thread = NULL;
+SDL_mutex *stream_mutex = NULL;                         // guards the request and ready queues
+SDL_cond *stream_cond = NULL;
+bool stream_running = false;                            // guarded by stream_mutex
+struct ye_stream_job *stream_requests_head = NULL;
+struct ye_stream_job *stream_requests_tail = NULL;
+struct ye_stream_job *stream_ready_head = NULL;
+struct ye_stream_job *stream_ready_tail = NULL;
+
+// only touched by the main thread
+struct ye_stream_job *stream_uploads_head = NULL;
+struct ye_stream_job *stream_uploads_tail = NULL;
+struct ye_stream_pending *stream_pending = NULL;
+
+void _ye_stream_push(struct ye_stream_job **head, struct ye_stream_job **tail, struct ye_stream_job *job){
+    job->next = NULL;
+    if(*tail != NULL) (*tail)->next = job;
+    else *head = job;
+    *tail = job;
+}
+
+struct ye_stream_job * _ye_stream_pop(struct ye_stream_job **head, struct ye_stream_job **tail){
+    struct ye_stream_job *job = *head;
+    if(job != NULL){
+        *head = job->next;
+        if(*head == NULL) *tail = NULL;
+        job->next = NULL;
+    }
+    return job;
+}
+
+void _ye_stream_free_job(struct ye_stream_job *job){
+    if(job->surface != NULL) SDL_FreeSurface(job->surface);
+    if(job->texture != NULL) SDL_DestroyTexture(job->texture);
+    free(job->key);
+    free(job);
+}
+
+/*
+    Reads and decodes the file, converting it to the format the upload expects
+*/
+void _ye_stream_decode(struct ye_stream_job *job){
+    struct ye_image_source source;
+    if(!ye_image_source_open(job->key, &source))
+        return;
+
+    job->content_hash = source.hash;
+    SDL_Surface *surface = ye_image_source_decode(&source);
+    ye_image_source_close(&source);
+    if(surface == NULL)
+        return;
+
+    if(surface->format->format != SDL_PIXELFORMAT_RGBA32){
+        SDL_Surface *converted = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+        SDL_FreeSurface(surface);
+        surface = converted;
+    }
+    job->surface = surface;
+}
+
+int _ye_stream_thread(void *data){
+    (void)data;
+
+    SDL_LockMutex(stream_mutex);
+    while(true){
+        while(stream_running && stream_requests_head == NULL)
+            SDL_CondWait(stream_cond, stream_mutex);
+        if(!stream_running)
+            break;
+
+        struct ye_stream_job *job = _ye_stream_pop(&stream_requests_head, &stream_requests_tail);
+        SDL_UnlockMutex(stream_mutex);
+
+        _ye_stream_decode(job);
+
+        SDL_LockMutex(stream_mutex);
+        _ye_stream_push(&stream_ready_head, &stream_ready_tail, job);
+    }
+    SDL_UnlockMutex(stream_mutex);
+    return 0;
+}
+
+SDL_Texture * ye_image_acquire_streamed(const char *path){
+    if(stream_thread == NULL || !YE_STATE.engine.stream_textures || ye_image_is_cached(path))
+        return ye_image_acquire(path);
+
+    char key[1024];
+    if(!ye_image_key(path, key, sizeof(key)))
+        return ye_image_acquire(path);
+
+    struct ye_stream_pending *pending = NULL;
+    HASH_FIND_STR(stream_pending, key, pending);
+    if(pending != NULL)
+        return missing_texture;
+
+    pending = malloc(sizeof(struct ye_stream_pending));
+    pending->key = strdup(key);
+    HASH_ADD_KEYPTR(hh, stream_pending, pending->key, strlen(pending->key), pending);
+    YE_STATE.runtime.texture_stream_pending++;
+
+    struct ye_stream_job *job = calloc(1, sizeof(struct ye_stream_job));
+    job->key = strdup(key);
+
+    SDL_LockMutex(stream_mutex);
+    _ye_stream_push(&stream_requests_head, &stream_requests_tail, job);
+    SDL_CondSignal(stream_cond);
+    SDL_UnlockMutex(stream_mutex);
+
+    return missing_texture;
+}
+
+/*
+    Hands a finished texture to the cache and the renderers waiting on it
+*/
+void _ye_stream_finish(struct ye_stream_job *job){
+    if(job->texture != NULL){
+        ye_cache_texture_preloaded(job->key, job->texture, job->content_hash);
+        job->texture = NULL; // owned by the cache now
+        ye_renderer_texture_streamed(job->key);
+    }
+    else{
+        // same as a synchronous load, remember the failure so we dont keep retrying it
+        ye_logf(error, "Could not stream texture '%s'.\n", job->key);
+        ye_cache_texture_preloaded(job->key, missing_texture, 0);
+    }
+
+    struct ye_stream_pending *pending = NULL;
+    HASH_FIND_STR(stream_pending, job->key, pending);
+    if(pending != NULL){
+        HASH_DEL(stream_pending, pending);
+        free(pending->key);
+        free(pending);
+        YE_STATE.runtime.texture_stream_pending--;
+    }
+    _ye_stream_free_job(job);
+}
+
+/*
+    Uploads the next band of rows, returns true once the whole texture is uploaded
+*/
+bool _ye_stream_upload_band(struct ye_stream_job *job){
+    SDL_Surface *surface = job->surface;
+    if(surface == NULL)
+        return true;
+
+    if(job->texture == NULL){
+        job->texture = SDL_CreateTexture(YE_STATE.runtime.renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, surface->w, surface->h);
+        if(job->texture == NULL){
+            ye_logf(error, "Failed to create streamed texture %s: %s\n", job->key, SDL_GetError());
+            return true;
+        }
+        SDL_SetTextureBlendMode(job->texture, SDL_BLENDMODE_BLEND);
+    }
+
+    int rows = surface->h - job->uploaded_rows;
+    if(rows > YE_STREAM_UPLOAD_ROWS)
+        rows = YE_STREAM_UPLOAD_ROWS;
+
+    SDL_Rect band = {0, job->uploaded_rows, surface->w, rows};
+    const Uint8 *pixels = (const Uint8 *)surface->pixels + (size_t)job->uploaded_rows * surface->pitch;
+    if(SDL_UpdateTexture(job->texture, &band, pixels, surface->pitch) != 0){
+        ye_logf(error, "Failed to upload streamed texture %s: %s\n", job->key, SDL_GetError());
+        SDL_DestroyTexture(job->texture);
+        job->texture = NULL;
+        return true;
+    }
+
+    job->uploaded_rows += rows;
+    return job->uploaded_rows >= surface->h;
+}
+
+void ye_texture_stream_update(){
+    YE_STATE.runtime.texture_upload_time = 0.0f;
+    if(stream_thread == NULL)
+        return;
+
+    // take everything the loader finished since last frame
+    SDL_LockMutex(stream_mutex);
+    struct ye_stream_job *job;
+    while((job = _ye_stream_pop(&stream_ready_head, &stream_ready_tail)) != NULL)
+        _ye_stream_push(&stream_uploads_head, &stream_uploads_tail, job);
+    SDL_UnlockMutex(stream_mutex);
+
+    if(stream_uploads_head == NULL)
+        return;
+
+    // always make some progress, even if the budget is smaller than a single band
+    Uint64 start = SDL_GetPerformanceCounter();
+    double budget = YE_STATE.engine.texture_upload_budget_ms * (double)SDL_GetPerformanceFrequency() / 1000.0;
+    do{
+        job = stream_uploads_head;
+        if(_ye_stream_upload_band(job)){
+            _ye_stream_pop(&stream_uploads_head, &stream_uploads_tail);
+            _ye_stream_finish(job);
+        }
+    } while(stream_uploads_head != NULL && (double)(SDL_GetPerformanceCounter() - start) < budget);
+
+    YE_STATE.runtime.texture_upload_time = (float)((double)(SDL_GetPerformanceCounter() - start) * 1000.0 / (double)SDL_GetPerformanceFrequency());
+}
+
+void ye_init_texture_streaming(){
+    ye_shutdown_texture_streaming();
+
+    stream_mutex = SDL_CreateMutex();
+    stream_cond = SDL_CreateCond();
+    stream_running = true;
+
+    stream_thread = SDL_CreateThread(_ye_stream_thread, "ye_texture_stream", NULL);
+    if(stream_thread == NULL){
+        ye_logf(error, "Failed to start texture streaming thread: %s\n", SDL_GetError());
+        ye_shutdown_texture_streaming();
+    }
+}
+
+void ye_shutdown_texture_streaming(){
+    if(stream_thread != NULL){
+        SDL_LockMutex(stream_mutex);
+        stream_running = false;
+        SDL_CondSignal(stream_cond);
+        SDL_UnlockMutex(stream_mutex);
+        SDL_WaitThread(stream_thread, NULL);
+        stream_thread = NULL;
+    }
+
+    struct ye_stream_job *job;
+    while((job = _ye_stream_pop(&stream_requests_head, &stream_requests_tail)) != NULL)
+        _ye_stream_free_job(job);
+    while((job = _ye_stream_pop(&stream_ready_head, &stream_ready_tail)) != NULL)
+        _ye_stream_free_job(job);
+    while((job = _ye_stream_pop(&stream_uploads_head, &stream_uploads_tail)) != NULL)
+        _ye_stream_free_job(job);
+
+    struct ye_stream_pending *pending, *tmp;
+    HASH_ITER(hh, stream_pending, pending, tmp){
+        HASH_DEL(stream_pending, pending);
+        free(pending->key);
+        free(pending);
+    }
+    YE_STATE.runtime.texture_stream_pending = 0;
+
+    if(stream_cond != NULL){
+        SDL_DestroyCond(stream_cond);
+        stream_cond = NULL;
+    }
+    if(stream_mutex != NULL){
+        SDL_DestroyMutex(stream_mutex);
+        stream_mutex = NULL;
+    }
+}
@@ -149,6 +149,15 @@ void ui_paint_debug_overlay(){
     char entity_count_str[100];
     char audio_chunk_count_str[100];
     char log_line_count_str[100];
+    char texture_cache_str[100];
+    char texture_cache_stats_str[100];
+    char scene_load_str[100];
+    char texture_stream_str[100];
+    char sound_cache_str[100];
+    char voices_str[100];
+    char lua_str[100];
+    char lua_alloc_str[100];
+    char lua_tasks_str[100];
     sprintf(fps_str, "fps: %d", YE_STATE.runtime.fps);
     sprintf(input_time_str, "input time: %dms", YE_STATE.runtime.input_time);
     sprintf(physics_time_str, "physics time: %dms", YE_STATE.runtime.physics_time);
@@ -159,6 +168,15 @@ void ui_paint_debug_overlay(){
     sprintf(entity_count_str, "entity count: %d", YE_STATE.runtime.entity_count);
     sprintf(audio_chunk_count_str, "audio chunk count: %d", YE_STATE.runtime.audio_chunk_count);
     sprintf(log_line_count_str, "log line count: %d", YE_STATE.runtime.log_line_count);
+    sprintf(texture_cache_str, "textures: %d (%.1fMB)", YE_STATE.runtime.texture_cache_count, YE_STATE.runtime.texture_cache_bytes / (1024.0 * 1024.0));
+    sprintf(texture_cache_stats_str, "tex hit/miss/evict/dup: %d/%d/%d/%d", YE_STATE.runtime.texture_cache_hits, YE_STATE.runtime.texture_cache_misses, YE_STATE.runtime.texture_cache_evictions, YE_STATE.runtime.texture_cache_dedupes);
+    sprintf(scene_load_str, "scene: %dms (%.1fMB @ %.0fMB/s)", YE_STATE.runtime.scene_ready_time, YE_STATE.runtime.scene_prefetch_bytes / (1024.0 * 1024.0), YE_STATE.runtime.scene_prefetch_rate);
+    sprintf(sound_cache_str, "sounds: %d (%.1fMB) hit/miss: %d/%d", YE_STATE.runtime.sound_cache_count, YE_STATE.runtime.sound_cache_bytes / (1024.0 * 1024.0), YE_STATE.runtime.sound_cache_hits, YE_STATE.runtime.sound_cache_misses);
+    sprintf(voices_str, "voices req/play/steal/drop: %d/%d/%d/%d", YE_STATE.runtime.audio_voices_requested, YE_STATE.runtime.audio_voices_played, YE_STATE.runtime.audio_voices_stolen, YE_STATE.runtime.audio_voices_dropped);
+    sprintf(lua_str, "lua: %d states %.1fMB (max %.1fMB) gc %.2fms", YE_STATE.runtime.lua_state_count, YE_STATE.runtime.lua_memory_bytes / (1024.0 * 1024.0), YE_STATE.runtime.lua_max_state_memory_bytes / (1024.0 * 1024.0), YE_STATE.runtime.lua_gc_time);
+    sprintf(lua_alloc_str, "lua pools: %.1fMB allocs: %d", YE_STATE.runtime.lua_pool_bytes / (1024.0 * 1024.0), YE_STATE.runtime.lua_allocations);
+    sprintf(lua_tasks_str, "lua tasks: %d (resumed %d)", YE_STATE.runtime.lua_tasks, YE_STATE.runtime.lua_tasks_resumed);
+    sprintf(texture_stream_str, "streaming: %d (%.2fms)", YE_STATE.runtime.texture_stream_pending, YE_STATE.runtime.texture_upload_time);
 
     if (nk_begin(ctx, "Metrics", nk_rect(10, 10, 220, 200),
                     NK_WINDOW_BORDER | NK_WINDOW_MOVABLE | NK_WINDOW_TITLE)) {
@@ -173,6 +191,15 @@ void ui_paint_debug_overlay(){
         nk_label(ctx, entity_count_str, NK_TEXT_LEFT);
         nk_label(ctx, audio_chunk_count_str, NK_TEXT_LEFT);
         nk_label(ctx, log_line_count_str, NK_TEXT_LEFT);
+        nk_label(ctx, texture_cache_str, NK_TEXT_LEFT);
+        nk_label(ctx, texture_cache_stats_str, NK_TEXT_LEFT);
+        nk_label(ctx, scene_load_str, NK_TEXT_LEFT);
+        nk_label(ctx, texture_stream_str, NK_TEXT_LEFT);
+        nk_label(ctx, sound_cache_str, NK_TEXT_LEFT);
+        nk_label(ctx, voices_str, NK_TEXT_LEFT);
+        nk_label(ctx, lua_str, NK_TEXT_LEFT);
+        nk_label(ctx, lua_alloc_str, NK_TEXT_LEFT);
+        nk_label(ctx, lua_tasks_str, NK_TEXT_LEFT);
     }
     nk_end(ctx);
 }
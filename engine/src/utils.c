@@ -16,6 +16,11 @@
     along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
 #include <yoyoengine/yoyoengine.h>
 
 void ye_auto_fit_bounds(struct ye_rectf* bounds_f, struct ye_rectf* obj_f, enum ye_alignment alignment, SDL_Point* center){
@@ -97,6 +102,108 @@ int ye_clamp(int value, int min, int max) {
     return (value < min) ? min : (value > max) ? max : value;
 }
 
+bool ye_normalize_path(const char *path, char *out, size_t out_size){
+    if(path == NULL || out_size == 0)
+        return false;
+
+    size_t length = 0;
+    bool absolute = path[0] == '/' || path[0] == '\\';
+    if(absolute){
+        if(out_size < 2)
+            return false;
+        out[length++] = '/';
+    }
+    size_t root_length = length; // ".." never climbs past this
+
+    const char *p = path;
+    while(*p){
+        while(*p == '/' || *p == '\\')
+            p++;
+        if(*p == '\0')
+            break;
+
+        const char *segment = p;
+        while(*p && *p != '/' && *p != '\\')
+            p++;
+        size_t segment_length = p - segment;
+
+        if(segment_length == 1 && segment[0] == '.')
+            continue;
+
+        if(segment_length == 2 && segment[0] == '.' && segment[1] == '.'){
+            // drop the previous segment, unless there is none or it is a ".." we could not resolve
+            size_t last = length;
+            while(last > root_length && out[last - 1] != '/')
+                last--;
+            bool previous_is_parent = length - last == 2 && out[last] == '.' && out[last + 1] == '.';
+            if(length > root_length && !previous_is_parent){
+                length = last > root_length ? last - 1 : last;
+                continue;
+            }
+            if(absolute)
+                continue; // "/.." is just "/"
+        }
+
+        if(length > root_length){
+            if(length + 1 >= out_size)
+                return false;
+            out[length++] = '/';
+        }
+        if(length + segment_length >= out_size)
+            return false;
+        memcpy(out + length, segment, segment_length);
+        length += segment_length;
+    }
+
+    out[length] = '\0';
+    return true;
+}
+
+uint64_t ye_hash_bytes(const void *data, size_t size){
+    // FNV-1a over 8 byte words (then the tail byte by byte), seeded with the size
+    const uint64_t prime = 0x100000001b3ULL;
+    uint64_t hash = 0xcbf29ce484222325ULL ^ (uint64_t)size;
+    const unsigned char *bytes = data;
+
+    size_t i = 0;
+    for(; i + 8 <= size; i += 8){
+        uint64_t word;
+        memcpy(&word, bytes + i, sizeof(word));
+        hash = (hash ^ word) * prime;
+        hash ^= hash >> 29;
+    }
+    for(; i < size; i++)
+        hash = (hash ^ bytes[i]) * prime;
+
+    // 0 is reserved to mean "no hash"
+    return hash != 0 ? hash : 1;
+}
+
+unsigned char * ye_read_file(const char *path, size_t *size){
+    FILE *file = fopen(path, "rb");
+    if(file == NULL)
+        return NULL;
+
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if(length <= 0){
+        fclose(file);
+        return NULL;
+    }
+
+    unsigned char *buffer = malloc((size_t)length);
+    if(buffer == NULL || fread(buffer, 1, (size_t)length, file) != (size_t)length){
+        free(buffer);
+        fclose(file);
+        return NULL;
+    }
+
+    fclose(file);
+    *size = (size_t)length;
+    return buffer;
+}
+
 SDL_Rect ye_get_real_texture_size_rect(SDL_Texture *pTexture){
     int imgWidth, imgHeight;
     SDL_QueryTexture(pTexture, NULL, NULL, &imgWidth, &imgHeight);
@@ -184,6 +291,21 @@ struct ye_rectf ye_get_position(struct ye_entity *entity, enum ye_component_type
             }
             ye_logf(error,"Tried to get position of a null collider component on entity \"%s\". returning (0,0,0,0)\n",entity->name);
             return pos;
+        case YE_COMPONENT_AUDIOSOURCE:
+            if(entity->audiosource != NULL){
+                // set x,y,w,h
+                pos = entity->audiosource->rect;
+
+                // if relative adjust its position
+                if(entity->audiosource->relative && entity->transform != NULL){
+                    pos.x += entity->transform->x;
+                    pos.y += entity->transform->y;
+                }
+
+                return pos;
+            }
+            ye_logf(error,"Tried to get position of a null audiosource component on entity \"%s\". returning (0,0,0,0)\n",entity->name);
+            return pos;
         default:
             ye_logf(error, "Tried to get position for component on \"%s\" that does not have a position or size. returning (0,0,0,0)\n",entity->name);
             return pos;
@@ -0,0 +1,196 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/yoyolick/yoyoengine)
+    Copyright (C) 2023  Ryan Zmuda
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <yoyoengine/yoyoengine.h>
+
+/*
+    The job currently being worked on. Chunks are claimed by atomically
+    bumping next_chunk, so no lock is held while running user code.
+*/
+struct ye_worker_job {
+    ye_parallel_fn fn;
+    void *data;
+    int count;
+    int grain;
+    int chunk_count;
+    SDL_atomic_t next_chunk;
+    SDL_atomic_t chunks_done;
+};
+
+SDL_Thread *worker_threads[YE_MAX_WORKERS];
+int worker_thread_count = 0;
+
+SDL_mutex *worker_mutex = NULL;
+SDL_cond *worker_wake = NULL;   // signalled when a new job is posted (or we are shutting down)
+SDL_cond *worker_done = NULL;   // signalled when a worker finishes its part of a job
+
+struct ye_worker_job worker_job;
+unsigned int worker_generation = 0; // bumped every time a job is posted
+int worker_busy = 0;                // workers currently inside a job, guarded by worker_mutex
+bool workers_running = false;
+bool worker_job_active = false;
+
+/*
+    Claim and run chunks of the current job until there are none left
+*/
+void _ye_worker_run_chunks(){
+    while(true){
+        int chunk = SDL_AtomicAdd(&worker_job.next_chunk, 1);
+        if(chunk >= worker_job.chunk_count)
+            break;
+
+        int start = chunk * worker_job.grain;
+        int end = start + worker_job.grain;
+        if(end > worker_job.count)
+            end = worker_job.count;
+
+        worker_job.fn(start, end, worker_job.data);
+        SDL_AtomicAdd(&worker_job.chunks_done, 1);
+    }
+}
+
+int _ye_worker_main(void *unused){
+    (void)unused;
+    unsigned int seen_generation = 0;
+
+    SDL_LockMutex(worker_mutex);
+    while(true){
+        while(workers_running && worker_generation == seen_generation)
+            SDL_CondWait(worker_wake, worker_mutex);
+
+        if(!workers_running)
+            break;
+
+        seen_generation = worker_generation;
+        worker_busy++;
+        SDL_UnlockMutex(worker_mutex);
+
+        _ye_worker_run_chunks();
+
+        SDL_LockMutex(worker_mutex);
+        worker_busy--;
+        SDL_CondSignal(worker_done);
+    }
+    SDL_UnlockMutex(worker_mutex);
+    return 0;
+}
+
+void ye_parallel_for(int count, int grain, ye_parallel_fn fn, void *data){
+    if(count <= 0 || fn == NULL)
+        return;
+    if(grain < 1)
+        grain = 1;
+
+    // not worth (or not possible) to hand this off, just do it here
+    if(!workers_running || worker_job_active || count <= grain){
+        fn(0, count, data);
+        return;
+    }
+
+    SDL_LockMutex(worker_mutex);
+
+    // a worker that woke up late for the last job might still be looking at it
+    while(worker_busy > 0)
+        SDL_CondWait(worker_done, worker_mutex);
+
+    worker_job_active = true;
+    worker_job.fn = fn;
+    worker_job.data = data;
+    worker_job.count = count;
+    worker_job.grain = grain;
+    worker_job.chunk_count = (count + grain - 1) / grain;
+    SDL_AtomicSet(&worker_job.next_chunk, 0);
+    SDL_AtomicSet(&worker_job.chunks_done, 0);
+    worker_generation++;
+    SDL_CondBroadcast(worker_wake);
+    SDL_UnlockMutex(worker_mutex);
+
+    // help out instead of idling
+    _ye_worker_run_chunks();
+
+    /*
+        Wait for every chunk to finish, and for every worker to have left the job,
+        so nobody is still reading worker_job when the next one gets posted.
+    */
+    SDL_LockMutex(worker_mutex);
+    while(SDL_AtomicGet(&worker_job.chunks_done) < worker_job.chunk_count || worker_busy > 0)
+        SDL_CondWait(worker_done, worker_mutex);
+    worker_job_active = false;
+    SDL_UnlockMutex(worker_mutex);
+}
+
+int ye_worker_count(){
+    return worker_thread_count + 1;
+}
+
+void ye_init_workers(){
+    worker_thread_count = SDL_GetCPUCount() - 1;
+    if(worker_thread_count > YE_MAX_WORKERS)
+        worker_thread_count = YE_MAX_WORKERS;
+    if(worker_thread_count < 0)
+        worker_thread_count = 0;
+
+    worker_mutex = SDL_CreateMutex();
+    worker_wake = SDL_CreateCond();
+    worker_done = SDL_CreateCond();
+    if(worker_mutex == NULL || worker_wake == NULL || worker_done == NULL){
+        ye_logf(error, "Failed to create worker pool primitives: %s. Running single threaded.\n", SDL_GetError());
+        worker_thread_count = 0;
+        return;
+    }
+
+    workers_running = true;
+    for(int i = 0; i < worker_thread_count; i++){
+        worker_threads[i] = SDL_CreateThread(_ye_worker_main, "ye_worker", NULL);
+        if(worker_threads[i] == NULL){
+            ye_logf(warning, "Failed to create worker thread %d: %s\n", i, SDL_GetError());
+            worker_thread_count = i;
+            break;
+        }
+    }
+
+    // no threads means no point pretending we have a pool
+    if(worker_thread_count == 0)
+        workers_running = false;
+
+    ye_logf(info, "Initialized worker pool with %d threads.\n", worker_thread_count);
+}
+
+void ye_shutdown_workers(){
+    if(worker_mutex != NULL){
+        SDL_LockMutex(worker_mutex);
+        workers_running = false;
+        SDL_CondBroadcast(worker_wake);
+        SDL_UnlockMutex(worker_mutex);
+    }
+
+    for(int i = 0; i < worker_thread_count; i++){
+        SDL_WaitThread(worker_threads[i], NULL);
+        worker_threads[i] = NULL;
+    }
+    worker_thread_count = 0;
+
+    if(worker_done != NULL) SDL_DestroyCond(worker_done);
+    if(worker_wake != NULL) SDL_DestroyCond(worker_wake);
+    if(worker_mutex != NULL) SDL_DestroyMutex(worker_mutex);
+    worker_done = NULL;
+    worker_wake = NULL;
+    worker_mutex = NULL;
+
+    ye_logf(info, "Shut down worker pool.\n");
+}
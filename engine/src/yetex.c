@@ -0,0 +1,286 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/yoyolick/yoyoengine)
+    Copyright (C) 2023  Ryan Zmuda
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <SDL2/SDL.h>
+
+#include <yoyoengine/yoyoengine.h>
+
+#define YE_YETEX_HEADER_SIZE 32
+
+// LZ4 stores match lengths minus this
+#define YE_LZ4_MIN_MATCH 4
+
+uint32_t _ye_yetex_u32(const unsigned char *p){
+    uint32_t v; memcpy(&v, p, sizeof(v)); return v;
+}
+
+uint64_t _ye_yetex_u64(const unsigned char *p){
+    uint64_t v; memcpy(&v, p, sizeof(v)); return v;
+}
+
+/*
+    Reads an LZ4 extended length (a run of bytes summed until one is not 255)
+*/
+bool _ye_lz4_length(const unsigned char **ip, const unsigned char *iend, size_t *length){
+    unsigned char b;
+    do {
+        if(*ip >= iend)
+            return false;
+        b = *(*ip)++;
+        *length += b;
+    } while(b == 255);
+    return true;
+}
+
+bool ye_lz4_decompress(const unsigned char *src, size_t src_size, unsigned char *dst, size_t dst_size){
+    const unsigned char *ip = src;
+    const unsigned char *iend = src + src_size;
+    unsigned char *op = dst;
+    unsigned char *oend = dst + dst_size;
+
+    while(ip < iend){
+        unsigned char token = *ip++;
+
+        // literals
+        size_t literal_length = token >> 4;
+        if(literal_length == 15 && !_ye_lz4_length(&ip, iend, &literal_length))
+            return false;
+        if(literal_length > (size_t)(iend - ip) || literal_length > (size_t)(oend - op))
+            return false;
+        memcpy(op, ip, literal_length);
+        ip += literal_length;
+        op += literal_length;
+
+        // the last sequence is literals only
+        if(ip == iend)
+            break;
+
+        // match
+        if(iend - ip < 2)
+            return false;
+        size_t offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+        ip += 2;
+        if(offset == 0 || offset > (size_t)(op - dst))
+            return false;
+
+        size_t match_length = token & 15;
+        if(match_length == 15 && !_ye_lz4_length(&ip, iend, &match_length))
+            return false;
+        match_length += YE_LZ4_MIN_MATCH;
+        if(match_length > (size_t)(oend - op))
+            return false;
+
+        // matches can overlap their own output (offset < length), so copy forward byte by byte then
+        const unsigned char *match = op - offset;
+        if(offset >= match_length){
+            memcpy(op, match, match_length);
+            op += match_length;
+        }
+        else{
+            for(size_t i = 0; i < match_length; i++)
+                *op++ = *match++;
+        }
+    }
+
+    return op == oend;
+}
+
+/*
+    Validates a yetex header and finds its payload
+*/
+bool _ye_yetex_header(const unsigned char *bytes, size_t size, uint32_t *width, uint32_t *height, uint32_t *compression, const unsigned char **payload, size_t *payload_size){
+    if(bytes == NULL || size < YE_YETEX_HEADER_SIZE || memcmp(bytes, "YETX", 4) != 0){
+        ye_logf(error, "Invalid yetex data.\n");
+        return false;
+    }
+
+    uint32_t version = _ye_yetex_u32(bytes + 4);
+    *width = _ye_yetex_u32(bytes + 8);
+    *height = _ye_yetex_u32(bytes + 12);
+    *compression = _ye_yetex_u32(bytes + 16);
+    uint64_t stored_size = _ye_yetex_u64(bytes + 24);
+
+    if(version != YE_YETEX_VERSION){
+        ye_logf(error, "Unsupported yetex version %u (expected %d).\n", version, YE_YETEX_VERSION);
+        return false;
+    }
+    if(*width == 0 || *height == 0 || *width > 65536 || *height > 65536 || stored_size > size - YE_YETEX_HEADER_SIZE){
+        ye_logf(error, "Corrupt yetex header (%ux%u, %llu byte payload).\n", *width, *height, (unsigned long long)stored_size);
+        return false;
+    }
+    if(*compression != YE_YETEX_RAW && *compression != YE_YETEX_LZ4){
+        ye_logf(error, "Unsupported yetex compression %u.\n", *compression);
+        return false;
+    }
+
+    *payload = bytes + YE_YETEX_HEADER_SIZE;
+    *payload_size = (size_t)stored_size;
+    return true;
+}
+
+/*
+    Writes the pixels of a yetex payload into dst, which holds exactly pixels_size bytes
+*/
+bool _ye_yetex_unpack(uint32_t compression, const unsigned char *payload, size_t payload_size, unsigned char *dst, size_t pixels_size){
+    if(compression == YE_YETEX_LZ4){
+        if(!ye_lz4_decompress(payload, payload_size, dst, pixels_size)){
+            ye_logf(error, "Corrupt yetex: LZ4 payload did not decompress.\n");
+            return false;
+        }
+        return true;
+    }
+
+    if(payload_size != pixels_size){
+        ye_logf(error, "Corrupt yetex: expected %zu bytes of pixels, got %zu.\n", pixels_size, payload_size);
+        return false;
+    }
+    memcpy(dst, payload, pixels_size);
+    return true;
+}
+
+SDL_Surface * ye_decode_yetex_surface(const void *data, size_t size){
+    uint32_t width, height, compression;
+    const unsigned char *payload;
+    size_t payload_size;
+    if(!_ye_yetex_header(data, size, &width, &height, &compression, &payload, &payload_size))
+        return NULL;
+
+    SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, (int)width, (int)height, 32, SDL_PIXELFORMAT_RGBA32);
+    if(surface == NULL){
+        ye_logf(error, "Error creating yetex surface: %s\n", SDL_GetError());
+        return NULL;
+    }
+
+    // 32bpp surfaces are never padded, so the pixels are one contiguous block
+    if(!_ye_yetex_unpack(compression, payload, payload_size, surface->pixels, (size_t)width * height * 4)){
+        SDL_FreeSurface(surface);
+        return NULL;
+    }
+    return surface;
+}
+
+SDL_Texture * ye_create_yetex_texture(const void *data, size_t size){
+    uint32_t width, height, compression;
+    const unsigned char *payload;
+    size_t payload_size;
+    if(!_ye_yetex_header(data, size, &width, &height, &compression, &payload, &payload_size))
+        return NULL;
+
+    size_t pixels_size = (size_t)width * height * 4;
+    unsigned char *decompressed = NULL;
+    const unsigned char *pixels = payload;
+
+    // raw pixels are uploaded straight from wherever they already are
+    if(compression != YE_YETEX_RAW || payload_size != pixels_size){
+        decompressed = malloc(pixels_size);
+        if(decompressed == NULL){
+            ye_logf(error, "Failed to allocate %zu bytes to decompress yetex.\n", pixels_size);
+            return NULL;
+        }
+        if(!_ye_yetex_unpack(compression, payload, payload_size, decompressed, pixels_size)){
+            free(decompressed);
+            return NULL;
+        }
+        pixels = decompressed;
+    }
+
+    // RGBA32 is whichever packed format has R,G,B,A in memory order on this machine
+    SDL_Texture *texture = SDL_CreateTexture(YE_STATE.runtime.renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, (int)width, (int)height);
+    if(texture == NULL){
+        ye_logf(error, "Error creating yetex texture: %s\n", SDL_GetError());
+        free(decompressed);
+        return NULL;
+    }
+
+    if(SDL_UpdateTexture(texture, NULL, pixels, (int)width * 4) != 0){
+        ye_logf(error, "Error uploading yetex texture: %s\n", SDL_GetError());
+        SDL_DestroyTexture(texture);
+        free(decompressed);
+        return NULL;
+    }
+
+    // match what SDL_CreateTextureFromSurface does for images with alpha
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+    free(decompressed);
+    return texture;
+}
+
+/*
+    Builds the .yetex path for an image (or keeps it if it already is one), false if it doesnt fit
+*/
+bool _ye_yetex_path(const char *image_path, char *out, size_t out_size){
+    size_t path_length = strlen(image_path);
+    size_t extension_length = strlen(YE_YETEX_EXTENSION);
+    if(path_length >= extension_length && strcmp(image_path + path_length - extension_length, YE_YETEX_EXTENSION) == 0)
+        return snprintf(out, out_size, "%s", image_path) < (int)out_size;
+    return snprintf(out, out_size, "%s%s", image_path, YE_YETEX_EXTENSION) < (int)out_size;
+}
+
+SDL_Texture * ye_load_yetex(const char *image_path){
+    // accept either the original image path or the .yetex itself
+    char yetex_path[1024];
+    if(image_path == NULL || !_ye_yetex_path(image_path, yetex_path, sizeof(yetex_path)))
+        return NULL;
+
+    // in the pack: upload straight from the mapping
+    size_t size = 0;
+    const void *packed = ye_pack_data(yetex_path, &size);
+    if(packed != NULL)
+        return ye_create_yetex_texture(packed, size);
+
+    // the original is packed but its .yetex is not, so there is nothing on disk to find
+    if(ye_pack_contains(image_path))
+        return NULL;
+
+    unsigned char *buffer = ye_read_file(yetex_path, &size);
+    if(buffer == NULL)
+        return NULL;
+
+    SDL_Texture *texture = ye_create_yetex_texture(buffer, size);
+    free(buffer);
+    return texture;
+}
+
+SDL_Surface * ye_load_yetex_surface(const char *image_path){
+    char yetex_path[1024];
+    if(image_path == NULL || !_ye_yetex_path(image_path, yetex_path, sizeof(yetex_path)))
+        return NULL;
+
+    size_t size = 0;
+    const void *packed = ye_pack_data(yetex_path, &size);
+    if(packed != NULL)
+        return ye_decode_yetex_surface(packed, size);
+
+    // the original is packed but its .yetex is not, so there is nothing on disk to find
+    if(ye_pack_contains(image_path))
+        return NULL;
+
+    unsigned char *buffer = ye_read_file(yetex_path, &size);
+    if(buffer == NULL)
+        return NULL;
+
+    SDL_Surface *surface = ye_decode_yetex_surface(buffer, size);
+    free(buffer);
+    return surface;
+}
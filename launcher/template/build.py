@@ -79,7 +79,22 @@ os.mkdir("./build")
 shutil.copytree(build_engine_path, "./build/" + build_platform)
 shutil.copytree("./custom/include", "./build/" + build_platform + "/include", dirs_exist_ok=True)
 shutil.copytree("./custom/lib", "./build/" + build_platform + "/lib", dirs_exist_ok=True)
+
 shutil.copytree("./resources", "./build/" + build_platform + "/resources", dirs_exist_ok=True)
+
+# optionally convert images into pre-decoded .yetex textures, so the game skips png/jpg decoding when loading
+if build.get("predecode_textures", False):
+    subprocess.run([sys.executable, shpath + "../tools/convert_textures.py", "./build/" + build_platform + "/resources", "--remove-originals"], check=True)
+
+# optionally pack resources into a single resources.yepk the engine memory maps at startup.
+# scenes, styles and scripts are still read as loose files, so only those are left alongside it
+if build.get("pack_resources", False):
+    loose_extensions = [".yoyo", ".lua"]
+    subprocess.run([sys.executable, shpath + "../tools/pack_assets.py", "./build/" + build_platform + "/resources", "./build/" + build_platform + "/resources.yepk", "--exclude-ext", ",".join(loose_extensions)], check=True)
+    for root, dirs, files in os.walk("./build/" + build_platform + "/resources"):
+        for f in files:
+            if os.path.splitext(f)[1].lower() not in loose_extensions:
+                os.remove(os.path.join(root, f))
 shutil.copyfile("./settings.yoyo", "./build/" + build_platform + "/settings.yoyo")
 
 print("Building \"" + game_name + "\" for " + build_platform + " with flags: " + build_cflags)
@@ -0,0 +1,165 @@
+"""
+    This file is a part of yoyoengine. (https://github.com/yoyolick/yoyoengine)
+    Copyright (C) 2023  Ryan Zmuda
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+"""
+
+"""
+    Converts every image under a resources folder into the engine's pre-decoded
+    texture format (see engine/dist/include/yoyoengine/yetex.h), written next to
+    the original as "<image>.yetex". The engine loads these instead of decoding
+    the png/jpg at runtime.
+
+    requires Pillow (pip install pillow). Uses the lz4 package for compression if
+    it is installed, otherwise a slower built in encoder.
+
+    usage: python3 convert_textures.py <resources folder> [--compression lz4|raw] [--remove-originals]
+"""
+
+import os
+import sys
+import struct
+import argparse
+
+try:
+    from PIL import Image
+except ImportError:
+    Image = None
+
+try:
+    import lz4.block as lz4_block
+except ImportError:
+    lz4_block = None
+
+YETEX_VERSION = 1
+YETEX_RAW = 0
+YETEX_LZ4 = 1
+HEADER_FORMAT = "<4sIIIIIQ"
+IMAGE_EXTENSIONS = (".png", ".jpg", ".jpeg", ".bmp", ".tga", ".gif", ".webp")
+
+LZ4_MIN_MATCH = 4
+LZ4_LAST_LITERALS = 5   # a block always ends in at least this many literals
+LZ4_MATCH_LIMIT = 12    # and the last match starts at least this far from the end
+LZ4_MAX_OFFSET = 65535
+
+def _lz4_length(out, length):
+    while length >= 255:
+        out.append(255)
+        length -= 255
+    out.append(length)
+
+def _lz4_sequence(out, data, literal_start, literal_end, offset, match_length):
+    literal_length = literal_end - literal_start
+    token = (min(literal_length, 15) << 4)
+    if offset:
+        token |= min(match_length - LZ4_MIN_MATCH, 15)
+    out.append(token)
+    if literal_length >= 15:
+        _lz4_length(out, literal_length - 15)
+    out += data[literal_start:literal_end]
+    if offset:
+        out += struct.pack("<H", offset)
+        if match_length - LZ4_MIN_MATCH >= 15:
+            _lz4_length(out, match_length - LZ4_MIN_MATCH - 15)
+
+def lz4_compress(data):
+    """
+        Greedy single block LZ4 encoder (hash of the next 4 bytes -> last position).
+    """
+    if lz4_block is not None:
+        return lz4_block.compress(data, store_size=False)
+
+    out = bytearray()
+    length = len(data)
+    table = {}
+    anchor = 0
+    i = 0
+    match_limit = length - LZ4_MATCH_LIMIT
+    while i < match_limit:
+        key = data[i:i + 4]
+        candidate = table.get(key)
+        table[key] = i
+        if candidate is None or i - candidate > LZ4_MAX_OFFSET:
+            i += 1
+            continue
+
+        # extend the match, keeping the last literals out of it
+        match_end = i + 4
+        end_limit = length - LZ4_LAST_LITERALS
+        while match_end < end_limit and data[match_end] == data[candidate + match_end - i]:
+            match_end += 1
+
+        _lz4_sequence(out, data, anchor, i, i - candidate, match_end - i)
+        i = match_end
+        anchor = i
+
+    _lz4_sequence(out, data, anchor, length, 0, 0)
+    return bytes(out)
+
+def convert_image(image_path, compression):
+    image = Image.open(image_path).convert("RGBA")
+    width, height = image.size
+    pixels = image.tobytes()
+
+    payload = pixels
+    if compression == YETEX_LZ4:
+        compressed = lz4_compress(pixels)
+        # not worth decompressing if it barely shrank
+        if len(compressed) < len(pixels) * 0.9:
+            payload = compressed
+        else:
+            compression = YETEX_RAW
+
+    with open(image_path + ".yetex", "wb") as f:
+        f.write(struct.pack(HEADER_FORMAT, b"YETX", YETEX_VERSION, width, height, compression, 0, len(payload)))
+        f.write(payload)
+
+    return len(pixels), len(payload)
+
+def convert_folder(resources_dir, compression=YETEX_LZ4, remove_originals=False):
+    if Image is None:
+        print("Error: converting textures requires Pillow (pip install pillow).")
+        sys.exit(1)
+
+    converted = 0
+    for root, dirs, filenames in os.walk(resources_dir):
+        for filename in sorted(filenames):
+            if os.path.splitext(filename)[1].lower() not in IMAGE_EXTENSIONS:
+                continue
+            image_path = os.path.join(root, filename)
+            try:
+                raw_size, stored_size = convert_image(image_path, compression)
+            except Exception as e:
+                print("Skipping " + image_path + ": " + str(e))
+                continue
+            converted += 1
+            print("Converted " + image_path + " (" + str(raw_size) + " -> " + str(stored_size) + " bytes)")
+            if remove_originals:
+                os.remove(image_path)
+    return converted
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Convert images into pre-decoded .yetex textures.")
+    parser.add_argument("resources", help="the resources folder to convert")
+    parser.add_argument("--compression", choices=["lz4", "raw"], default="lz4", help="how to store pixels (default lz4)")
+    parser.add_argument("--remove-originals", action="store_true", help="delete each image once converted (for build output only)")
+    args = parser.parse_args()
+
+    if not os.path.isdir(args.resources):
+        print("Error: resources folder \"" + args.resources + "\" does not exist.")
+        sys.exit(1)
+
+    count = convert_folder(args.resources, YETEX_LZ4 if args.compression == "lz4" else YETEX_RAW, args.remove_originals)
+    print("Converted " + str(count) + " images")
@@ -0,0 +1,103 @@
+"""
+    This file is a part of yoyoengine. (https://github.com/yoyolick/yoyoengine)
+    Copyright (C) 2023  Ryan Zmuda
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+"""
+
+"""
+    Packs a game's resources folder into a single .yepk file that the engine
+    memory maps at startup (see engine/dist/include/yoyoengine/pack.h).
+
+    usage: python3 pack_assets.py <resources folder> <output.yepk> [--align N] [--exclude-ext .yoyo,.lua]
+
+    Layout (little endian):
+        header: "YEPK" | u32 version | u32 entry count | u32 alignment | u64 index offset | u64 index size
+        blobs:  each starting on an alignment boundary
+        index:  entry count * (u64 offset | u64 size | u32 path offset | u32 path length), then the path strings
+"""
+
+import os
+import sys
+import struct
+import argparse
+
+PACK_VERSION = 1
+HEADER_FORMAT = "<4sIIIQQ"
+ENTRY_FORMAT = "<QQII"
+
+def collect_files(resources_dir, excluded_extensions):
+    files = []
+    for root, dirs, filenames in os.walk(resources_dir):
+        dirs.sort()
+        for filename in sorted(filenames):
+            if os.path.splitext(filename)[1].lower() in excluded_extensions:
+                continue
+            full_path = os.path.join(root, filename)
+            relative_path = os.path.relpath(full_path, resources_dir).replace(os.sep, "/")
+            files.append((relative_path, full_path))
+    return files
+
+def align_up(value, alignment):
+    return (value + alignment - 1) // alignment * alignment
+
+def write_pack(resources_dir, output_path, alignment=64, excluded_extensions=()):
+    files = collect_files(resources_dir, excluded_extensions)
+    header_size = struct.calcsize(HEADER_FORMAT)
+
+    entries = []
+    strings = bytearray()
+    with open(output_path, "wb") as pack:
+        # leave room for the header, we fill it in once we know where the index is
+        pack.write(b"\0" * header_size)
+
+        for relative_path, full_path in files:
+            offset = align_up(pack.tell(), alignment)
+            pack.write(b"\0" * (offset - pack.tell()))
+
+            with open(full_path, "rb") as f:
+                data = f.read()
+            pack.write(data)
+
+            encoded_path = relative_path.encode("utf-8")
+            entries.append((offset, len(data), len(strings), len(encoded_path)))
+            strings += encoded_path
+
+        index_offset = align_up(pack.tell(), 8)
+        pack.write(b"\0" * (index_offset - pack.tell()))
+        for entry in entries:
+            pack.write(struct.pack(ENTRY_FORMAT, *entry))
+        pack.write(strings)
+        index_size = pack.tell() - index_offset
+
+        pack.seek(0)
+        pack.write(struct.pack(HEADER_FORMAT, b"YEPK", PACK_VERSION, len(entries), alignment, index_offset, index_size))
+
+    return len(entries), os.path.getsize(output_path)
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Pack a yoyoengine resources folder into a .yepk file.")
+    parser.add_argument("resources", help="the resources folder to pack")
+    parser.add_argument("output", help="the .yepk file to write")
+    parser.add_argument("--align", type=int, default=64, help="alignment of each file in the pack (default 64)")
+    parser.add_argument("--exclude-ext", default="", help="comma separated extensions to leave out, ex: .yoyo,.lua")
+    args = parser.parse_args()
+
+    if not os.path.isdir(args.resources):
+        print("Error: resources folder \"" + args.resources + "\" does not exist.")
+        sys.exit(1)
+
+    excluded = tuple(ext.strip().lower() for ext in args.exclude_ext.split(",") if ext.strip())
+    count, size = write_pack(args.resources, args.output, args.align, excluded)
+    print("Packed " + str(count) + " files (" + str(size) + " bytes) into " + args.output)